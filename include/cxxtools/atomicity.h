@@ -31,7 +31,10 @@
 
 #include <cxxtools/config.h>
 
-#if defined(CXXTOOLS_ATOMICITY_SUN)
+#if defined(CXXTOOLS_ATOMICITY_STDCXX)
+    #include <cxxtools/atomicity.stdcxx.h>
+
+#elif defined(CXXTOOLS_ATOMICITY_SUN)
     #include <cxxtools/atomicity.sun.h>
 
 #elif defined(CXXTOOLS_ATOMICITY_WINDOWS)
@@ -181,6 +184,29 @@ atomic_t atomicExchange(volatile atomic_t& val, atomic_t exch);
 */
 void* atomicExchange(void* volatile& dest, void* exch);
 
+#ifndef CXXTOOLS_ATOMICITY_HAS_REFCOUNT_OPS
+
+/** @brief Increments a reference count
+
+    Returns the incremented value. Unlike atomicIncrement no memory ordering
+    is guaranteed, which is sufficient, when the caller already holds a
+    reference. Backends, which do not implement relaxed ordering, fall back
+    to atomicIncrement.
+*/
+inline atomic_t atomicRefIncrement(volatile atomic_t& val)
+{ return atomicIncrement(val); }
+
+/** @brief Decrements a reference count
+
+    Returns the decremented value. The decrement has release semantics and
+    when it reaches 0, the following destruction of the object sees all
+    writes of the other owners.
+*/
+inline atomic_t atomicRefDecrement(volatile atomic_t& val)
+{ return atomicDecrement(val); }
+
+#endif
+
 }
 
 #endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef CXXTOOLS_ATOMICINT_STDCXX_H
+#define CXXTOOLS_ATOMICINT_STDCXX_H
+
+namespace cxxtools {
+
+typedef long atomic_t;
+
+} // namespace cxxtools
+
+#if __cplusplus >= 201103L
+
+#include <atomic>
+
+#define CXXTOOLS_ATOMICITY_HAS_REFCOUNT_OPS
+
+namespace cxxtools {
+
+inline volatile std::atomic<atomic_t>& atomicObject(volatile atomic_t& val)
+{
+    static_assert(sizeof(std::atomic<atomic_t>) == sizeof(atomic_t)
+        && alignof(std::atomic<atomic_t>) == alignof(atomic_t),
+        "std::atomic<atomic_t> must have the layout of atomic_t");
+    return reinterpret_cast<volatile std::atomic<atomic_t>&>(val);
+}
+
+// Taking an additional reference needs no ordering, since the caller
+// already holds one.
+inline atomic_t atomicRefIncrement(volatile atomic_t& val)
+{
+    return atomicObject(val).fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// Releasing a reference must publish all writes to the object to the
+// thread, which finally destroys it; only that thread needs the acquire.
+inline atomic_t atomicRefDecrement(volatile atomic_t& val)
+{
+    atomic_t ret = atomicObject(val).fetch_sub(1, std::memory_order_release) - 1;
+    if (ret == 0)
+        std::atomic_thread_fence(std::memory_order_acquire);
+    return ret;
+}
+
+} // namespace cxxtools
+
+#endif
+
+#endif
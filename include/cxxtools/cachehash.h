@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CACHEHASH_H
+#define CXXTOOLS_CACHEHASH_H
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+
+namespace cxxtools
+{
+  /**
+     Hash function used by ConcurrentCache and HashLruCache.
+
+     The generic version works for integral keys. Specialize it or pass a
+     own functor to the cache for other key types.
+   */
+  template <typename Key>
+  struct CacheHash
+  {
+    std::size_t operator() (const Key& key) const
+    { return static_cast<std::size_t>(key); }
+  };
+
+  /**
+     Hash function for strings.
+
+     Strings can be looked up with a const char* without creating a
+     temporary std::string.
+   */
+  template <>
+  struct CacheHash<std::string>
+  {
+    static std::size_t hash(const char* data, std::size_t size)
+    {
+      // FNV-1a
+      std::size_t h = 2166136261u;
+      for (std::size_t n = 0; n < size; ++n)
+      {
+        h ^= static_cast<unsigned char>(data[n]);
+        h *= 16777619u;
+      }
+      return h;
+    }
+
+    std::size_t operator() (const std::string& key) const
+    { return hash(key.data(), key.size()); }
+
+    std::size_t operator() (const char* key) const
+    { return hash(key, std::strlen(key)); }
+  };
+
+  /// spreads the bits of a hash value, so that weak hashes like the
+  /// identity of integers use all buckets of a power of 2 sized table.
+  inline std::size_t cacheHashMix(std::size_t h)
+  {
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h;
+  }
+}
+
+#endif // CXXTOOLS_CACHEHASH_H
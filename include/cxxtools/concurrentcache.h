@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CONCURRENTCACHE_H
+#define CXXTOOLS_CONCURRENTCACHE_H
+
+#include <cxxtools/mutex.h>
+#include <cxxtools/timespan.h>
+#include <cxxtools/cachehash.h>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace cxxtools
+{
+  /**
+     Implements a thread safe cache.
+
+     The elements are distributed to a number of shards by the hash of the
+     key. Each shard has its own mutex and hash table, so that threads
+     accessing different shards do not block each other.
+
+     When a shard is full, the element to drop is selected using the CLOCK
+     algorithm: a hit just sets a reference flag of the element. The clock
+     hand moves over the elements of the shard, clears the flag of
+     referenced elements and drops the first element found without a flag.
+     This approximates a lru cache without reordering a list on every hit.
+
+     Optionally elements expire after a time to live.
+
+     Values are returned as copies, since other threads may replace or drop
+     elements at any time.
+   */
+  template <typename Key, typename Value, typename Hash = CacheHash<Key> >
+  class ConcurrentCache
+  {
+#if __cplusplus >= 201103L
+      ConcurrentCache(const ConcurrentCache&) = delete;
+      ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+#else
+      ConcurrentCache(const ConcurrentCache&) { }
+      ConcurrentCache& operator=(const ConcurrentCache&) { return *this; }
+#endif
+
+      enum { npos = 0xffffffffu };
+
+      struct Slot
+      {
+        Key key;
+        Value value;
+        Timespan expires;
+        unsigned next;      // next slot in the hash chain or free list
+        bool used;
+        bool referenced;
+      };
+
+      struct Shard
+      {
+        Mutex mutex;
+        std::vector<Slot> slots;
+        std::vector<unsigned> buckets;
+        unsigned freeList;
+        unsigned hand;
+        std::size_t count;
+        std::size_t maxElements;
+        unsigned hits;
+        unsigned misses;
+        unsigned evictions;
+
+        Shard()
+          : freeList(npos),
+            hand(0),
+            count(0),
+            maxElements(0),
+            hits(0),
+            misses(0),
+            evictions(0)
+          { }
+
+        void init(std::size_t maxElements_)
+        {
+          maxElements = maxElements_ > 0 ? maxElements_ : 1;
+          std::size_t n = 8;
+          while (n < maxElements + maxElements / 2)
+            n <<= 1;
+          buckets.assign(n, npos);
+        }
+
+        unsigned& bucket(std::size_t h)
+        { return buckets[h & (buckets.size() - 1)]; }
+
+        unsigned find(std::size_t h, const Key& key)
+        {
+          for (unsigned s = bucket(h); s != npos; s = slots[s].next)
+            if (slots[s].key == key)
+              return s;
+          return npos;
+        }
+
+        void unlink(std::size_t h, unsigned s)
+        {
+          unsigned* p = &bucket(h);
+          while (*p != s)
+            p = &slots[*p].next;
+          *p = slots[s].next;
+        }
+
+        void release(std::size_t h, unsigned s)
+        {
+          unlink(h, s);
+          slots[s].used = false;
+          slots[s].key = Key();
+          slots[s].value = Value();
+          slots[s].next = freeList;
+          freeList = s;
+          --count;
+        }
+      };
+
+      std::vector<Shard*> _shards;
+      Hash _hash;
+      Timespan _ttl;
+      std::size_t _maxElements;
+
+      Shard& shard(std::size_t h)
+      { return *_shards[(h >> 24) & (_shards.size() - 1)]; }
+
+      // returns a free slot; drops a element when the shard is full
+      unsigned _allocate(Shard& s)
+      {
+        if (s.freeList != npos)
+        {
+          unsigned n = s.freeList;
+          s.freeList = s.slots[n].next;
+          return n;
+        }
+
+        if (s.slots.size() < s.maxElements)
+        {
+          s.slots.push_back(Slot());
+          return static_cast<unsigned>(s.slots.size() - 1);
+        }
+
+        // clock algorithm
+        while (true)
+        {
+          if (s.hand >= s.slots.size())
+            s.hand = 0;
+
+          Slot& slot = s.slots[s.hand];
+          if (slot.used && !slot.referenced)
+          {
+            unsigned n = s.hand++;
+            ++s.evictions;
+            s.release(cacheHashMix(_hash(slot.key)), n);
+            s.freeList = s.slots[n].next;
+            return n;
+          }
+
+          slot.referenced = false;
+          ++s.hand;
+        }
+      }
+
+      bool _expired(const Slot& slot) const
+      { return _ttl > Timespan(0) && slot.expires < Timespan::gettimeofday(); }
+
+    public:
+      typedef std::size_t size_type;
+      typedef Value value_type;
+
+      /**
+         Creates a cache for maxElements elements.
+
+         The elements are distributed to the given number of shards, which
+         is rounded up to a power of 2. A positive ttl lets elements expire
+         after that time.
+       */
+      explicit ConcurrentCache(size_type maxElements_, unsigned shards = 16,
+                               const Milliseconds& ttl = Milliseconds(0), const Hash& hash = Hash())
+        : _hash(hash),
+          _ttl(ttl),
+          _maxElements(maxElements_)
+      {
+        unsigned n = 1;
+        while (n < shards)
+          n <<= 1;
+
+        _shards.reserve(n);
+        for (unsigned s = 0; s < n; ++s)
+        {
+          _shards.push_back(new Shard());
+          _shards.back()->init((maxElements_ + n - 1) / n);
+        }
+      }
+
+      ~ConcurrentCache()
+      {
+        for (typename std::vector<Shard*>::iterator it = _shards.begin(); it != _shards.end(); ++it)
+          delete *it;
+      }
+
+      /// returns the number of elements currently in the cache
+      size_type size() const
+      {
+        size_type ret = 0;
+        for (typename std::vector<Shard*>::const_iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          ret += (*it)->count;
+        }
+        return ret;
+      }
+
+      /// returns the maximum number of elements in the cache
+      size_type getMaxElements() const      { return _maxElements; }
+
+      /// returns the time to live of the elements or 0 if they do not expire
+      Milliseconds getTtl() const           { return _ttl; }
+
+      /// removes a element from the cache and returns true, if found
+      bool erase(const Key& key)
+      {
+        std::size_t h = cacheHashMix(_hash(key));
+        Shard& s = shard(h);
+        MutexLock lock(s.mutex);
+
+        unsigned n = s.find(h, key);
+        if (n == npos)
+          return false;
+
+        s.release(h, n);
+        return true;
+      }
+
+      /// clears the cache.
+      void clear(bool stats = false)
+      {
+        for (typename std::vector<Shard*>::iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          Shard& s = **it;
+          MutexLock lock(s.mutex);
+          s.slots.clear();
+          s.buckets.assign(s.buckets.size(), npos);
+          s.freeList = npos;
+          s.hand = 0;
+          s.count = 0;
+          if (stats)
+            s.hits = s.misses = s.evictions = 0;
+        }
+      }
+
+      /// puts a new element in the cache or replaces the value of a existing one.
+      void put(const Key& key, const Value& value)
+      {
+        std::size_t h = cacheHashMix(_hash(key));
+        Shard& s = shard(h);
+        MutexLock lock(s.mutex);
+
+        unsigned n = s.find(h, key);
+        if (n == npos)
+        {
+          n = _allocate(s);
+          Slot& slot = s.slots[n];
+          slot.key = key;
+          slot.used = true;
+          slot.next = s.bucket(h);
+          s.bucket(h) = n;
+          ++s.count;
+        }
+
+        Slot& slot = s.slots[n];
+        slot.value = value;
+        slot.referenced = true;
+        if (_ttl > Timespan(0))
+          slot.expires = Timespan::gettimeofday() + _ttl;
+      }
+
+      /// returns a pair of values - a flag, if the value was found and the
+      /// value if found or the passed default otherwise.
+      std::pair<bool, Value> getx(const Key& key, Value def = Value())
+      {
+        std::size_t h = cacheHashMix(_hash(key));
+        Shard& s = shard(h);
+        MutexLock lock(s.mutex);
+
+        unsigned n = s.find(h, key);
+        if (n != npos && _expired(s.slots[n]))
+        {
+          s.release(h, n);
+          n = npos;
+        }
+
+        if (n == npos)
+        {
+          ++s.misses;
+          return std::pair<bool, Value>(false, def);
+        }
+
+        ++s.hits;
+        Slot& slot = s.slots[n];
+        slot.referenced = true;
+        return std::pair<bool, Value>(true, slot.value);
+      }
+
+      /// returns the value to a key or the passed default value if not found.
+      Value get(const Key& key, Value def = Value())
+      {
+        return getx(key, def).second;
+      }
+
+      /// returns the number of hits.
+      unsigned getHits() const
+      {
+        unsigned ret = 0;
+        for (typename std::vector<Shard*>::const_iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          ret += (*it)->hits;
+        }
+        return ret;
+      }
+
+      /// returns the number of misses.
+      unsigned getMisses() const
+      {
+        unsigned ret = 0;
+        for (typename std::vector<Shard*>::const_iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          ret += (*it)->misses;
+        }
+        return ret;
+      }
+
+      /// returns the number of elements dropped to make room for new ones.
+      unsigned getEvictions() const
+      {
+        unsigned ret = 0;
+        for (typename std::vector<Shard*>::const_iterator it = _shards.begin(); it != _shards.end(); ++it)
+        {
+          MutexLock lock((*it)->mutex);
+          ret += (*it)->evictions;
+        }
+        return ret;
+      }
+
+      /// returns the cache hit ratio between 0 and 1.
+      double hitRatio() const
+      {
+        unsigned hits = getHits();
+        unsigned misses = getMisses();
+        return hits+misses > 0 ? static_cast<double>(hits)/static_cast<double>(hits+misses) : 0;
+      }
+
+      /// returns the ratio, between held elements and maximum elements.
+      double fillfactor() const   { return static_cast<double>(size()) / static_cast<double>(_maxElements); }
+  };
+
+}
+
+#endif // CXXTOOLS_CONCURRENTCACHE_H
@@ -0,0 +1,422 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CONCURRENTPOOL_H
+#define CXXTOOLS_CONCURRENTPOOL_H
+
+#include <cxxtools/pool.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/thread.h>
+#include <vector>
+
+namespace cxxtools
+{
+  /// Returns a small number, which is unique for the calling thread.
+  unsigned poolThreadIndex();
+
+  /** A thread safe pool for objects without a global lock.
+
+      Like cxxtools::Pool the ConcurrentPool keeps instances, which are not
+      in use, and returns them with a smart pointer, which puts them back
+      into the pool when released.
+
+      Each thread gets and releases objects through a small magazine of
+      objects, which is used mostly by that thread. Only when its magazine
+      is empty or full, the thread accesses a shared lock free stack.
+
+      The high watermark limits the number of spare objects kept in the
+      shared stack; further released objects are destroyed. trim drops
+      spare objects down to the low watermark and prewarm creates
+      objects in advance.
+   */
+  template <typename ObjectType,
+            typename CreatorType = DefaultCreator<ObjectType>,
+            template <class> class DestroyPolicy = DeletePolicy>
+  class ConcurrentPool
+  {
+#if __cplusplus >= 201103L
+      ConcurrentPool(const ConcurrentPool&) = delete;
+      ConcurrentPool& operator=(const ConcurrentPool&) = delete;
+#else
+      ConcurrentPool(const ConcurrentPool&) { }
+      ConcurrentPool& operator=(const ConcurrentPool&) { return *this; }
+#endif
+
+      // a pooled object together with the reference count of its Ptr instances
+      struct Holder
+      {
+        ObjectType* object;
+        volatile atomic_t refs;
+        bool detached;
+
+        explicit Holder(ObjectType* object_)
+          : object(object_),
+            refs(0),
+            detached(false)
+          { }
+      };
+
+    public:
+      class Ptr
+      {
+          Holder* holder;
+          ConcurrentPool* pool;
+
+          void doUnlink()
+          {
+            if (holder && atomicRefDecrement(holder->refs) == 0)
+            {
+              if (holder->detached)
+                pool->destroy(holder);
+              else
+                pool->put(holder);
+            }
+          }
+
+        public:
+          Ptr()
+            : holder(0),
+              pool(0)
+            { }
+
+          Ptr(Holder* holder_, ConcurrentPool* pool_)
+            : holder(holder_),
+              pool(pool_)
+            { atomicRefIncrement(holder->refs); }
+
+          Ptr(const Ptr& ptr)
+            : holder(ptr.holder),
+              pool(ptr.pool)
+            {
+              if (holder)
+                atomicRefIncrement(holder->refs);
+            }
+
+          ~Ptr()
+            { doUnlink(); }
+
+          Ptr& operator= (const Ptr& ptr)
+          {
+            if (holder != ptr.holder)
+            {
+              doUnlink();
+              holder = ptr.holder;
+              pool = ptr.pool;
+              if (holder)
+                atomicRefIncrement(holder->refs);
+            }
+            return *this;
+          }
+
+          /// The object can be dereferenced like the held object
+          ObjectType* operator->() const              { return holder->object; }
+          /// The object can be dereferenced like the held object
+          ObjectType& operator*() const               { return *holder->object; }
+
+          bool operator! () const { return holder == 0; }
+          operator bool () const  { return holder != 0; }
+
+          ObjectType* getPointer()              { return holder ? holder->object : 0; }
+          const ObjectType* getPointer() const  { return holder ? holder->object : 0; }
+
+          // don't put the object back to the pool
+          void release()
+          {
+            if (holder)
+              holder->detached = true;
+          }
+      };
+
+    private:
+      friend class Ptr;
+
+      enum {
+        MagazineSize = 16,
+        Magazines = 64,
+        IndexBits = 16,
+        Nil = (1 << IndexBits) - 1
+      };
+
+      struct Magazine
+      {
+        volatile atomic_t busy;
+        unsigned count;
+        Holder* items[MagazineSize];
+        char pad[64];   // keep magazines of different threads in different cache lines
+
+        Magazine()
+          : busy(0),
+            count(0)
+          { }
+      };
+
+      struct Node
+      {
+        Holder* volatile holder;
+        volatile atomic_t next;
+      };
+
+      Magazine _magazines[Magazines];
+
+      // Treiber stacks of node indexes; the upper bits of the head are a
+      // tag, which is incremented on every change to avoid the ABA problem
+      std::vector<Node> _nodes;
+      volatile atomic_t _full;
+      volatile atomic_t _empty;
+      volatile atomic_t _spare;
+
+      unsigned _lowWatermark;
+      CreatorType _creator;
+
+      static atomic_t _nextHead(atomic_t head, atomic_t index)
+      {
+        static const atomic_t tagMask = (static_cast<atomic_t>(1) << (sizeof(atomic_t) * 8 - IndexBits - 1)) - 1;
+        atomic_t tag = ((head >> IndexBits) + 1) & tagMask;
+        return (tag << IndexBits) | index;
+      }
+
+      void _push(volatile atomic_t& stack, atomic_t index)
+      {
+        atomic_t head = atomicGet(stack);
+        while (true)
+        {
+          _nodes[index].next = head & Nil;
+          atomic_t h = atomicCompareExchange(stack, _nextHead(head, index), head);
+          if (h == head)
+            return;
+          head = h;
+        }
+      }
+
+      atomic_t _pop(volatile atomic_t& stack)
+      {
+        atomic_t head = atomicGet(stack);
+        while (true)
+        {
+          atomic_t index = head & Nil;
+          if (index == Nil)
+            return Nil;
+
+          atomic_t h = atomicCompareExchange(stack, _nextHead(head, _nodes[index].next), head);
+          if (h == head)
+            return index;
+          head = h;
+        }
+      }
+
+      Holder* _popShared()
+      {
+        atomic_t index = _pop(_full);
+        if (index == Nil)
+          return 0;
+
+        Holder* holder = _nodes[index].holder;
+        _push(_empty, index);
+        atomicDecrement(_spare);
+        return holder;
+      }
+
+      // returns false, when the shared stack has reached the high watermark
+      bool _pushShared(Holder* holder)
+      {
+        atomic_t index = _pop(_empty);
+        if (index == Nil)
+          return false;
+
+        _nodes[index].holder = holder;
+        _push(_full, index);
+        atomicIncrement(_spare);
+        return true;
+      }
+
+      Magazine* _lockMagazine()
+      {
+        Magazine& m = _magazines[poolThreadIndex() % Magazines];
+        return atomicCompareExchange(m.busy, 1, 0) == 0 ? &m : 0;
+      }
+
+      static void _unlockMagazine(Magazine* m)
+      { atomicExchange(m->busy, 0); }
+
+      void destroy(Holder* holder)
+      {
+        DestroyPolicy<ObjectType>::destroy(holder->object);
+        delete holder;
+      }
+
+      void put(Holder* holder)
+      {
+        Magazine* m = _lockMagazine();
+        if (m)
+        {
+          if (m->count < MagazineSize)
+          {
+            m->items[m->count++] = holder;
+            _unlockMagazine(m);
+            return;
+          }
+
+          // move half of the full magazine to the shared stack
+          while (m->count > MagazineSize / 2 && _pushShared(m->items[m->count - 1]))
+            --m->count;
+
+          if (m->count < MagazineSize)
+          {
+            m->items[m->count++] = holder;
+            _unlockMagazine(m);
+            return;
+          }
+
+          _unlockMagazine(m);
+        }
+
+        if (!_pushShared(holder))
+          destroy(holder);
+      }
+
+    public:
+      /**
+         Creates a pool, which keeps up to highWatermark spare objects in
+         the shared stack in addition to the per thread magazines.
+       */
+      explicit ConcurrentPool(unsigned highWatermark = 256, unsigned lowWatermark = 0,
+                              CreatorType creator_ = CreatorType())
+        : _nodes(highWatermark < Nil ? highWatermark : Nil - 1),
+          _full(Nil),
+          _empty(Nil),
+          _spare(0),
+          _lowWatermark(lowWatermark),
+          _creator(creator_)
+      {
+        for (atomic_t n = 0; n < static_cast<atomic_t>(_nodes.size()); ++n)
+          _push(_empty, n);
+      }
+
+      ~ConcurrentPool()
+      {
+        drop();
+      }
+
+      Ptr get()
+      {
+        Holder* holder = 0;
+
+        Magazine* m = _lockMagazine();
+        if (m)
+        {
+          if (m->count > 0)
+            holder = m->items[--m->count];
+          _unlockMagazine(m);
+        }
+
+        if (holder == 0)
+          holder = _popShared();
+
+        if (holder == 0)
+          holder = new Holder(_creator());
+
+        return Ptr(holder, this);
+      }
+
+      /// Creates objects until the shared stack holds n spare objects.
+      void prewarm(unsigned n)
+      {
+        while (static_cast<unsigned>(atomicGet(_spare)) < n)
+        {
+          Holder* holder = new Holder(_creator());
+          if (!_pushShared(holder))
+          {
+            destroy(holder);
+            break;
+          }
+        }
+      }
+
+      /// Drops spare objects of the shared stack down to the low watermark.
+      void trim()
+      {
+        while (static_cast<unsigned>(atomicGet(_spare)) > _lowWatermark)
+        {
+          Holder* holder = _popShared();
+          if (holder == 0)
+            break;
+          destroy(holder);
+        }
+      }
+
+      /// Drops all spare objects except keep objects in the shared stack.
+      void drop(unsigned keep = 0)
+      {
+        for (unsigned n = 0; n < Magazines; ++n)
+        {
+          Magazine& m = _magazines[n];
+          while (atomicCompareExchange(m.busy, 1, 0) != 0)
+            Thread::yield();
+
+          while (m.count > 0)
+          {
+            Holder* holder = m.items[--m.count];
+            if (!_pushShared(holder))
+              destroy(holder);
+          }
+
+          _unlockMagazine(&m);
+        }
+
+        while (static_cast<unsigned>(atomicGet(_spare)) > keep)
+        {
+          Holder* holder = _popShared();
+          if (holder == 0)
+            break;
+          destroy(holder);
+        }
+      }
+
+      /// Returns the number of spare objects in the shared stack.
+      unsigned size()
+      { return static_cast<unsigned>(atomicGet(_spare)); }
+
+      unsigned getHighWatermark() const
+      { return static_cast<unsigned>(_nodes.size()); }
+
+      unsigned getLowWatermark() const
+      { return _lowWatermark; }
+
+      void setLowWatermark(unsigned s)
+      { _lowWatermark = s; }
+
+      CreatorType& getCreator()
+      { return _creator; }
+
+      const CreatorType& getCreator() const
+      { return _creator; }
+  };
+
+}
+
+#endif // CXXTOOLS_CONCURRENTPOOL_H
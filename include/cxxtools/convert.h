@@ -639,6 +639,83 @@ inline OutIterT putInt(OutIterT it, T i, const FormatT& fmt)
 }
 
 
+//! @internal @brief Returns the two digit strings "00" to "99" in one array.
+inline const char* decimalDigitPairs()
+{
+    static const char pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+    return pairs;
+}
+
+/** @brief Formats an integer in decimal format into a caller supplied buffer.
+
+    The number is written backwards, so that it ends just before \a end.
+    The buffer must have room for std::numeric_limits<T>::digits10 + 2
+    characters. Returns a pointer to the first character of the number.
+    Two digits are generated per division.
+ */
+template <typename T>
+inline char* formatDecimal(char* end, T i)
+{
+    typedef typename IntTraits<T>::Unsigned UnsignedInt;
+
+    const char* pairs = decimalDigitPairs();
+    char* cur = end;
+
+    bool isNeg = false;
+    UnsignedInt u = formatAbs(i, isNeg);
+
+    while (u >= 100)
+    {
+        unsigned r = static_cast<unsigned>(u % 100) * 2;
+        u /= 100;
+        cur -= 2;
+        cur[0] = pairs[r];
+        cur[1] = pairs[r + 1];
+    }
+
+    if (u >= 10)
+    {
+        unsigned r = static_cast<unsigned>(u) * 2;
+        cur -= 2;
+        cur[0] = pairs[r];
+        cur[1] = pairs[r + 1];
+    }
+    else
+    {
+        *--cur = static_cast<char>('0' + u);
+    }
+
+    if (isNeg)
+        *--cur = '-';
+
+    return cur;
+}
+
+
+template <typename OutIterT, typename T>
+inline OutIterT putInt(OutIterT it, T i, const DecimalFormat<char>&)
+{
+    const std::size_t buflen = std::numeric_limits<T>::digits10 + 2;
+    char buf[buflen];
+    char* end = buf + buflen;
+
+    for (char* p = formatDecimal(end, i); p != end; ++p)
+        *it++ = *p;
+
+    return it;
+}
+
+
 template <typename OutIterT, typename T>
 inline OutIterT putInt(OutIterT it, T i)
 {
@@ -753,15 +830,134 @@ inline OutIterT putFloat(OutIterT it, T value, const FormatT& fmt, int precision
 }
 
 
+/** @internal @brief Generates the shortest digits, which read back as \a value.
+
+    The value must be finite and greater than zero. The digits (at most
+    17) are written to \a digits without terminating zero and the number of
+    digits is returned. The value is digits * 10^exp.
+ */
+unsigned formatShortest(char* digits, int& exp, double value);
+
+//! @internal @brief Generates the shortest digits, which read back as \a value.
+unsigned formatShortest(char* digits, int& exp, float value);
+
+//! @internal @brief Outputs digits * 10^exp in positional notation.
+template <typename OutIterT>
+OutIterT putFloatDigits(OutIterT it, const char* digits, unsigned len, int exp)
+{
+    int point = static_cast<int>(len) + exp;
+
+    if (point <= 0)
+    {
+        *it = '0'; ++it;
+        *it = '.'; ++it;
+
+        for ( ; point < 0; ++point)
+        {
+            *it = '0'; ++it;
+        }
+
+        for (unsigned n = 0; n < len; ++n)
+        {
+            *it = digits[n]; ++it;
+        }
+    }
+    else
+    {
+        for (unsigned n = 0; n < len; ++n)
+        {
+            if (static_cast<int>(n) == point)
+            {
+                *it = '.'; ++it;
+            }
+            *it = digits[n]; ++it;
+        }
+
+        for (int n = static_cast<int>(len); n < point; ++n)
+        {
+            *it = '0'; ++it;
+        }
+    }
+
+    return it;
+}
+
+
+/** @brief Formats a floating point value with the shortest representation,
+    which reads back as the same value.
+ */
 template <typename OutIterT, typename T>
 inline OutIterT putFloat(OutIterT it, T value)
 {
-    const int precision = std::numeric_limits<T>::digits10 - 1;
+    typedef char CharT;
+    FloatFormat<char> fmt;
+
+    if (value != value)
+    {
+        for (const CharT* nanstr = fmt.nan(); *nanstr != 0; ++nanstr)
+        {
+            *it = *nanstr;
+            ++it;
+        }
+
+        return it;
+    }
+
+    if (value < 0.0)
+    {
+        *it = fmt.minus();
+        ++it;
+    }
+
+    T num = std::fabs(value);
+
+    if (num == std::numeric_limits<T>::infinity())
+    {
+        for (const CharT* infstr = fmt.inf(); *infstr != 0; ++infstr)
+        {
+            *it = *infstr;
+            ++it;
+        }
+
+        return it;
+    }
+
+    if (num == 0)
+    {
+        *it = '0'; ++it;
+        return it;
+    }
+
+    char digits[20];
+    int exp;
+    unsigned len = formatShortest(digits, exp, num);
+    return putFloatDigits(it, digits, len, exp);
+}
+
+
+template <typename OutIterT>
+inline OutIterT putFloat(OutIterT it, long double value)
+{
+    const int precision = std::numeric_limits<long double>::digits10 - 1;
     FloatFormat<char> fmt;
     return putFloat(it, value, fmt, precision);
 }
 
 
+/** @internal @brief Converts w * 10^exp to the nearest floating point value.
+
+    When the decimal number has more than 19 significant digits, \a w holds
+    the first 19 digits and \a more the remaining ones.
+ */
+void decimalToFloat(double& n, uint64_t w, int exp, const std::string& more);
+
+//! @internal @brief Converts w * 10^exp to the nearest floating point value.
+void decimalToFloat(float& n, uint64_t w, int exp, const std::string& more);
+
+//! @internal @brief Converts w * 10^exp to the nearest floating point value.
+void decimalToFloat(long double& n, uint64_t w, int exp, const std::string& more);
+
+
 template <typename InIterT, typename FormatT>
 InIterT getSign(InIterT it, InIterT end, bool& pos, const FormatT& fmt)
 {
@@ -859,7 +1055,6 @@ template <typename InIterT, typename T, typename FormatT>
 InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt)
 {
     typedef typename FormatT::CharT CharT;
-    CharT zero = fmt.toChar(0);
     n = 0.0;
     ok = false;
 
@@ -978,95 +1173,87 @@ InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt)
         ++it;
     }
 
+    // The significant digits are collected into a 64 bit integer, which
+    // holds 19 digits. Further digits are only needed for exact rounding.
+    uint64_t w = 0;
+    unsigned digits = 0;
+    int exp = 0;
+    bool anyDigit = false;
+    std::string more;
+
     // integral part
-    bool withFractional = false;
-    for( ; it != end; ++it)
+    for ( ; it != end; ++it)
     {
-        if( *it == fmt.point() || *it == fmt.e() || *it == fmt.E() )
-        {
-            if( *it == fmt.point())
-            {
-                withFractional = true;
-                ++it;
-            }
+        unsigned digit = fmt.toDigit(*it);
+        if (digit >= fmt.base)
             break;
-        }
-        
-        unsigned digit = fmt.toDigit(*it); 
-        if(digit >= fmt.base)
-            return it;
-        
-        ok = true;
-        n *= 10;
-        n += digit; 
-    }
-    
-    // it is ok, if fraction is missing
-    if(it == end)
-    {
-        if( ! pos )
-            n *= -1;
 
-        ok = true;
-        return it;
+        anyDigit = true;
+        if (digits < 19)
+        {
+            w = w * 10 + digit;
+            if (w != 0)
+                ++digits;
+        }
+        else
+        {
+            more += static_cast<char>('0' + digit);
+            ++exp;
+        }
     }
 
-    T base = 10.0;
-    if( withFractional)
+    // fractional part
+    if (it != end && *it == fmt.point())
     {
-        // fractional part, ignore 0 digits after dot
-        unsigned short fractDigits = 0;
-        size_t maxDigits = std::numeric_limits<unsigned short>::max() - std::numeric_limits<T>::digits10;
-        while(it != end && *it == zero)
+        for (++it; it != end; ++it)
         {
-            if( fractDigits > maxDigits )
-                return it;
-            
-            ++fractDigits;
-            ++it;
-        }
- 
-        // fractional part, parse like integer, skip insignificant digits
-        unsigned short significants = 0;
-        T fraction = 0.0;
-        for( ; it != end; ++it)
-        {
-            unsigned digit = fmt.toDigit(*it); 
-            if(digit >= fmt.base)
+            unsigned digit = fmt.toDigit(*it);
+            if (digit >= fmt.base)
                 break;
-            
-            if( significants <= std::numeric_limits<T>::digits10 )
+
+            anyDigit = true;
+            if (digits < 19)
             {
-                fraction *= 10;
-                fraction += digit;
-                
-                ++fractDigits;
-                ++significants;
+                w = w * 10 + digit;
+                if (w != 0)
+                    ++digits;
+                --exp;
+            }
+            else
+            {
+                more += static_cast<char>('0' + digit);
             }
         }
-    
-
-        // fractional part, scale down
-        fraction /= std::pow(base, T(fractDigits));
-        n += fraction;
     }
 
+    if (!anyDigit)
+        return it;
+
     // exponent [e|E][+|-][0-9]*
-    if(it != end && (*it == fmt.e() || *it == fmt.E()) )
+    if (it != end && (*it == fmt.e() || *it == fmt.E()) )
     {
-        if(++it == end)
+        if (++it == end)
             return it;
 
-        long exp = 0;
-        it = getInt(it, end, ok, exp, fmt);
-        if( ! ok )
+        long e = 0;
+        bool eok = false;
+        it = getInt(it, end, eok, e, fmt);
+        if (!eok)
             return it;
-            
-        n *= std::pow(base, T(exp));
+
+        // far beyond the range of any floating point type
+        if (e > 100000)
+            e = 100000;
+        else if (e < -100000)
+            e = -100000;
+
+        exp += static_cast<int>(e);
     }
 
+    decimalToFloat(n, w, exp, more);
+
     if( ! pos )
-        n *= -1;
+        n = -n;
 
     ok = true;
     return it;
@@ -52,17 +52,52 @@ namespace cxxtools
             void selectColumn(const std::string& memberName, const std::string& title);
 
             void delimiter(String delimiter)
-            { _delimiter = delimiter; }
+            {
+                _delimiter = delimiter;
+                _delimiterBytes = Utf8Codec::encode(delimiter);
+            }
 
             void quote(Char quote)
-            { _quote = quote; }
+            {
+                _quote = quote;
+                _quoteBytes = Utf8Codec::encode(String(1, quote));
+            }
 
             void lineEnding(const String& le)
-            { _lineEnding = le; }
+            {
+                _lineEnding = le;
+                _lineEndingBytes = Utf8Codec::encode(le);
+            }
 
             virtual void addValueString(const std::string& name, const std::string& type,
                                   const String& value);
 
+            virtual void addValueStdString(const std::string& name, const std::string& type,
+                                  const std::string& value);
+
+            virtual void addValueChar(const std::string& name, const std::string& type,
+                                  char value);
+
+            virtual void addValueBool(const std::string& name, const std::string& type,
+                                  bool value);
+
+            virtual void addValueInt(const std::string& name, const std::string& type,
+                                  int_type value);
+
+            virtual void addValueUnsigned(const std::string& name, const std::string& type,
+                                  unsigned_type value);
+
+            virtual void addValueFloat(const std::string& name, const std::string& type,
+                                  float value);
+
+            virtual void addValueDouble(const std::string& name, const std::string& type,
+                                  double value);
+
+            virtual void addValueLongDouble(const std::string& name, const std::string& type,
+                                  long double value);
+
+            virtual void addNull(const std::string& name, const std::string& type);
+
             virtual void beginArray(const std::string& name, const std::string& type);
 
             virtual void finishArray();
@@ -78,8 +113,12 @@ namespace cxxtools
             virtual void finish();
 
         private:
-            void toCsvData(String& ret, const std::string& type, const String& value);
+            void init();
+            std::string* cell();
+            void quoteCell(std::string& data);
+            void titlesOut();
             void dataOut();
+            void rowOut();
 
             bool _firstline;
             bool _collectTitles;
@@ -89,6 +128,11 @@ namespace cxxtools
             Char _quote;
             String _lineEnding;
 
+            // utf-8 encoded delimiter, quote and line ending
+            std::string _delimiterBytes;
+            std::string _quoteBytes;
+            std::string _lineEndingBytes;
+
             // titles and member names
             struct Title
             {
@@ -97,11 +141,22 @@ namespace cxxtools
             };
 
             std::vector<Title> _titles;
+            unsigned _nextTitle;
+
+            // utf-8 encoded columns of the current row; the strings are
+            // reused for the next row
+            std::vector<std::string> _data;
+            unsigned _columns;
+            std::string _row;
+            std::string _tmp;
 
-            std::vector<String> _data;
             std::string _memberName;
+
+            // utf-8 output is written directly to the stream buffer;
+            // other encodings use a text stream
+            std::ostream* _out;
             TextOStream* _ts;
-            TextOStream& _os;
+            TextOStream* _os;
     };
 }
 
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CSVPARALLELREADER_H
+#define CXXTOOLS_CSVPARALLELREADER_H
+
+#include <cxxtools/csvreader.h>
+#include <cxxtools/callable.h>
+#include <string>
+#include <vector>
+
+namespace cxxtools
+{
+    /**
+       Parses large csv files on multiple threads.
+
+       The input is split into chunks, which are parsed on a thread pool. A
+       chunk starts speculatively after the first line break following its
+       nominal start. Line breaks inside quoted fields may make the guess
+       wrong. The chunks are validated in order: a chunk, which does not start
+       where its predecessor ended, is parsed again from the right position.
+
+       Each row is passed to a callback as a CsvReader positioned at that row.
+       In ordered mode the rows are passed in input order from the thread,
+       which calls read(). Otherwise the callback is called concurrently from
+       the threads of the pool, one chunk at a time per thread, and must be
+       thread safe.
+
+       Example:
+       \code
+        void onRow(const cxxtools::CsvReader& row)
+        {
+            MyObject obj;
+            row >>= obj;
+            ...
+        }
+
+        cxxtools::CsvParallelReader reader;
+        reader.open("data.csv");
+        reader.read(cxxtools::callable(onRow));
+       \endcode
+     */
+    class CsvParallelReader
+    {
+#if __cplusplus >= 201103L
+            CsvParallelReader(const CsvParallelReader&) = delete;
+            CsvParallelReader& operator=(const CsvParallelReader&) = delete;
+#else
+            CsvParallelReader(const CsvParallelReader&) { }
+            CsvParallelReader& operator=(const CsvParallelReader&) { return *this; }
+#endif
+
+        public:
+            CsvParallelReader();
+
+            /// Reads csv from memory; the data must stay valid while reading.
+            CsvParallelReader(const char* data, std::size_t size);
+
+            /// Reads csv from a file, which is mapped into memory.
+            void open(const std::string& fileName);
+
+            void close();
+
+            Char delimiter() const
+            { return _reader.delimiter(); }
+
+            void delimiter(Char ch)
+            { _reader.delimiter(ch); }
+
+            bool readTitle() const
+            { return _reader.readTitle(); }
+
+            void readTitle(bool sw)
+            { _reader.readTitle(sw); }
+
+            /// Sets the number of threads; defaults to the number of processors.
+            void threads(unsigned n)
+            { _threads = n; }
+
+            unsigned threads() const
+            { return _threads; }
+
+            /// Sets the nominal size of the chunks in bytes.
+            void chunkSize(std::size_t size)
+            { _chunkSize = size; }
+
+            std::size_t chunkSize() const
+            { return _chunkSize; }
+
+            void ordered(bool sw)
+            { _ordered = sw; }
+
+            bool ordered() const
+            { return _ordered; }
+
+            const std::vector<std::string>& titles() const
+            { return _reader.titles(); }
+
+            /// Returns the number of chunks, which had to be parsed again in the last read.
+            unsigned misspeculations() const
+            { return _misspeculations; }
+
+            /** Parses the input and passes each row to the callback.
+
+                Returns the number of rows. Errors of the parser or exceptions
+                thrown by the callback are passed to the caller, after the
+                running threads are finished.
+             */
+            unsigned long read(const Callable<void, const CsvReader&>& cb);
+
+        private:
+            struct Chunk;
+
+            unsigned long readSequential(const Callable<void, const CsvReader&>& cb);
+            void scanChunk(Chunk& chunk) const;
+            void deliverChunk(Chunk& chunk) const;
+            void checkChunk(const Chunk& chunk) const;
+
+            CsvReader _reader;
+            unsigned _threads;
+            std::size_t _chunkSize;
+            bool _ordered;
+            unsigned _misspeculations;
+    };
+}
+
+#endif // CXXTOOLS_CSVPARALLELREADER_H
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CSVREADER_H
+#define CXXTOOLS_CSVREADER_H
+
+#include <cxxtools/char.h>
+#include <cxxtools/string.h>
+#include <cxxtools/serializationinfo.h>
+#include <iosfwd>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace cxxtools
+{
+    /**
+       Reads csv data row by row.
+
+       In contrast to CsvDeserializer, which collects the whole input into a
+       SerializationInfo, the reader keeps only the current row in memory.
+       The input is processed as bytes. Files are mapped into memory and
+       streams are read in chunks into a buffer.
+
+       The fields of the current row point directly into the input. Quotes
+       are removed, but doubled quote characters within quoted fields are
+       only resolved, when the value is requested using Field::str().
+
+       Example:
+       \code
+        cxxtools::CsvReader reader;
+        reader.open("data.csv");
+        while (reader.next())
+        {
+            std::cout << reader[0].str() << std::endl;
+
+            MyObject obj;
+            reader >>= obj;   // deserialize the row with the titles as member names
+        }
+       \endcode
+     */
+    class CsvReader
+    {
+            friend class CsvParallelReader;
+
+#if __cplusplus >= 201103L
+            CsvReader(const CsvReader&) = delete;
+            CsvReader& operator=(const CsvReader&) = delete;
+#else
+            CsvReader(const CsvReader&) { }
+            CsvReader& operator=(const CsvReader&) { return *this; }
+#endif
+
+        public:
+            /// A field of the current row; valid until the next row is read.
+            class Field
+            {
+                    friend class CsvReader;
+                    friend class CsvParallelReader;
+
+                    const char* _data;
+                    std::size_t _size;
+                    char _quote;
+                    bool _escaped;
+
+                public:
+                    Field()
+                        : _data(0),
+                          _size(0),
+                          _quote('\0'),
+                          _escaped(false)
+                    { }
+
+                    /// The content of the field without surrounding quotes.
+                    const char* data() const
+                    { return _data; }
+
+                    std::size_t size() const
+                    { return _size; }
+
+                    bool empty() const
+                    { return _size == 0; }
+
+                    /// Returns true, when the field was enclosed in quotes.
+                    bool quoted() const
+                    { return _quote != '\0'; }
+
+                    /// Returns true, when data() contains doubled quote characters.
+                    bool escaped() const
+                    { return _escaped; }
+
+                    /// Returns the value with doubled quotes resolved.
+                    std::string str() const
+                    {
+                        std::string ret;
+                        get(ret);
+                        return ret;
+                    }
+
+                    void get(std::string& value) const;
+
+                    /// Returns the utf-8 decoded value.
+                    String ustr() const;
+            };
+
+            CsvReader();
+
+            /// Reads csv from a stream.
+            explicit CsvReader(std::istream& in);
+
+            /// Reads csv from memory; the data must stay valid while reading.
+            CsvReader(const char* data, std::size_t size);
+
+            ~CsvReader();
+
+            /// Reads csv from a file, which is mapped into memory if possible.
+            void open(const std::string& fileName);
+
+            void close();
+
+            Char delimiter() const
+            { return Char(static_cast<unsigned char>(_delimiter)); }
+
+            /// Sets the delimiter; only ascii characters are supported.
+            void delimiter(Char ch);
+
+            bool readTitle() const
+            { return _readTitle; }
+
+            void readTitle(bool sw)
+            { _readTitle = sw; }
+
+            static const Char autoDelimiter;
+
+            /// Reads the next row; returns false at the end of the input.
+            bool next();
+
+            /// Returns the number of fields in the current row.
+            unsigned size() const
+            { return _fields.size(); }
+
+            const Field& operator[](unsigned n) const
+            { return _fields[n]; }
+
+            /// Returns the field with the given title; throws SerializationError if not found.
+            const Field& field(const std::string& title) const;
+
+            const std::vector<std::string>& titles() const
+            { return _titles; }
+
+            /// Returns the number of the line, where the current row ends.
+            /// Line feeds within quoted fields are counted as lines.
+            unsigned lineNo() const
+            { return _lineNo; }
+
+            /** Fills the current row into a SerializationInfo.
+
+                The row is an array of values. When titles are read, the
+                titles are used as member names.
+             */
+            void get(SerializationInfo& si) const;
+
+        private:
+            enum ScanResult
+            {
+                scan_row,
+                scan_more,
+                scan_end
+            };
+
+            void init();
+            bool fill();
+            ScanResult scanRow();
+            void readTitles();
+
+            std::istream* _in;
+            std::ifstream _file;
+
+            const char* _pos;
+            const char* _end;
+            bool _eof;
+
+            std::vector<char> _buffer;
+            void* _map;
+            std::size_t _mapSize;
+
+            char _delimiter;
+            bool _readTitle;
+            bool _started;
+            unsigned _lineNo;
+
+            std::vector<std::string> _titles;
+            std::vector<Field> _fields;
+    };
+
+    /// Deserializes the current row of the reader.
+    template <typename T>
+    void operator>>= (const CsvReader& reader, T& obj)
+    {
+        SerializationInfo si;
+        reader.get(si);
+        si >>= obj;
+    }
+}
+
+#endif // CXXTOOLS_CSVREADER_H
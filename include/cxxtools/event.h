@@ -30,6 +30,8 @@
 #define cxxtools_EVENT_H
 
 #include <typeinfo>
+#include <cstddef>
+#include <new>
 
 namespace cxxtools
 {
@@ -54,6 +56,18 @@ namespace cxxtools
             virtual void destroy() = 0;
 
             virtual const std::type_info& typeInfo() const = 0;
+
+            /** \brief Copies the event into the given storage.
+
+                Returns 0, when the event does not fit into size bytes, the
+                storage is not aligned for the event type or the event type
+                does not support it. An event created here is released by
+                calling its destructor instead of destroy().
+             */
+            virtual Event* cloneTo(void* /*storage*/, std::size_t /*size*/) const
+            {
+                return 0;
+            }
     };
 
     template <typename T>
@@ -82,6 +96,14 @@ namespace cxxtools
             {
                 delete this;
             }
+
+            virtual Event* cloneTo(void* storage, std::size_t size) const
+            {
+                if (sizeof(T) > size
+                    || reinterpret_cast<std::size_t>(storage) % __alignof__(T) != 0)
+                    return 0;
+                return new (storage) T(*static_cast<const T*>(this));
+            }
     };
 
 } // namespace cxxtools
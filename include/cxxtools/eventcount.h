@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_EVENTCOUNT_H
+#define CXXTOOLS_EVENTCOUNT_H
+
+#include <cxxtools/atomicity.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/timespan.h>
+
+namespace cxxtools
+{
+    /** @brief Lets threads wait for a condition checked without locking.
+
+        An event count is used to block on lock free data structures. A
+        waiting thread calls prepareWait, checks its condition again and
+        then either calls cancelWait, when the condition is met, or wait
+        with the key returned by prepareWait. A thread, which changes the
+        condition calls notify or notifyAll afterwards.
+
+        The notifying side takes no lock unless there are waiting threads.
+
+        @code
+          for (;;)
+          {
+            if (tryGet(element))
+              break;
+
+            cxxtools::EventCount::Key key = eventCount.prepareWait();
+            if (tryGet(element))
+            {
+              eventCount.cancelWait();
+              break;
+            }
+
+            eventCount.wait(key);
+          }
+        @endcode
+     */
+    class EventCount
+    {
+#if __cplusplus >= 201103L
+            EventCount(const EventCount&) = delete;
+            EventCount& operator=(const EventCount&) = delete;
+#else
+            EventCount(const EventCount&) { }
+            EventCount& operator=(const EventCount&) { return *this; }
+#endif
+
+        public:
+            typedef atomic_t Key;
+
+            EventCount()
+                : _epoch(0),
+                  _waiters(0)
+            { }
+
+            /// @brief Registers the calling thread as waiter and returns the key to wait for.
+            Key prepareWait();
+
+            /// @brief Unregisters the calling thread after prepareWait.
+            void cancelWait();
+
+            /// @brief Blocks until notified after the key was returned by prepareWait.
+            void wait(Key key);
+
+            /** @brief Blocks until notified or the timeout has passed.
+
+                Returns false, if the timeout has passed.
+             */
+            bool wait(Key key, const Milliseconds& timeout);
+
+            /// @brief Wakes up one waiting thread.
+            void notify();
+
+            /// @brief Wakes up all waiting threads.
+            void notifyAll();
+
+            /// @brief Returns true, if threads are waiting or about to wait.
+            bool hasWaiters()
+            { return atomicGet(_waiters) > 0; }
+
+        private:
+            volatile atomic_t _epoch;
+            volatile atomic_t _waiters;
+            Mutex _mutex;
+            Condition _condition;
+    };
+}
+
+#endif // CXXTOOLS_EVENTCOUNT_H
@@ -163,6 +163,22 @@ namespace cxxtools
              */
             void eventsPerLoop(unsigned n);
 
+            /** Switches waiting for I/O between io_uring and poll.
+
+                With io_uring the poll requests of all devices stay armed in
+                the kernel and only changed requests are submitted, in a
+                single system call per loop cycle. Reads of connected tcp
+                sockets are submitted as recv requests, so that the kernel
+                receives into the buffer passed to beginRead, which must stay
+                valid until endRead or cancel. Writes, accepts and connects
+                keep waiting for readiness. Returns false when io_uring is
+                not available at runtime; the loop keeps using poll then.
+             */
+            bool useIoUring(bool sw = true);
+
+            /// Returns true, when the loop waits for I/O using io_uring.
+            bool usesIoUring() const;
+
         protected:
             virtual void onAdd( Selectable& s );
 
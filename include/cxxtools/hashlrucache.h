@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HASHLRUCACHE_H
+#define CXXTOOLS_HASHLRUCACHE_H
+
+#include <cxxtools/cachehash.h>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace cxxtools
+{
+  /**
+     Implements a lru cache with constant time operations.
+
+     The elements are held in a hash table and in a doubly linked list
+     ordered by the last access. get, put and dropping the least recently
+     used element take constant time.
+
+     The lookup methods are templates, so that any type, which the hash
+     function accepts and which can be compared with the key, may be used.
+     A cache with std::string keys can be searched with a const char*
+     without constructing a temporary std::string.
+
+     The interface is compatible with LruCache.
+   */
+  template <typename Key, typename Value, typename Hash = CacheHash<Key> >
+  class HashLruCache
+  {
+#if __cplusplus >= 201103L
+      HashLruCache(const HashLruCache&) = delete;
+      HashLruCache& operator=(const HashLruCache&) = delete;
+#else
+      HashLruCache(const HashLruCache&) { }
+      HashLruCache& operator=(const HashLruCache&) { return *this; }
+#endif
+
+      struct Node
+      {
+        Key key;
+        Value value;
+        std::size_t hash;
+        Node* hnext;   // next node in the hash bucket
+        Node* prev;    // more recently used node
+        Node* next;    // less recently used node
+
+        Node(const Key& key_, const Value& value_, std::size_t hash_)
+          : key(key_),
+            value(value_),
+            hash(hash_)
+          { }
+      };
+
+      std::vector<Node*> _buckets;
+      Node* _head;     // most recently used
+      Node* _tail;     // least recently used
+      std::size_t _size;
+      std::size_t _maxElements;
+      Hash _hash;
+      unsigned _hits;
+      unsigned _misses;
+
+      Node*& _bucket(std::size_t h)
+      { return _buckets[h & (_buckets.size() - 1)]; }
+
+      template <typename K>
+      Node* _find(const K& key, std::size_t h)
+      {
+        for (Node* n = _bucket(h); n; n = n->hnext)
+          if (n->hash == h && n->key == key)
+            return n;
+        return 0;
+      }
+
+      void _unlinkList(Node* n)
+      {
+        if (n->prev)
+          n->prev->next = n->next;
+        else
+          _head = n->next;
+
+        if (n->next)
+          n->next->prev = n->prev;
+        else
+          _tail = n->prev;
+      }
+
+      void _pushFront(Node* n)
+      {
+        n->prev = 0;
+        n->next = _head;
+        if (_head)
+          _head->prev = n;
+        else
+          _tail = n;
+        _head = n;
+      }
+
+      void _moveToFront(Node* n)
+      {
+        if (n != _head)
+        {
+          _unlinkList(n);
+          _pushFront(n);
+        }
+      }
+
+      void _remove(Node* n)
+      {
+        Node** p = &_bucket(n->hash);
+        while (*p != n)
+          p = &(*p)->hnext;
+        *p = n->hnext;
+
+        _unlinkList(n);
+        delete n;
+        --_size;
+      }
+
+      void _rehash(std::size_t size)
+      {
+        std::vector<Node*> buckets(size, static_cast<Node*>(0));
+        for (typename std::vector<Node*>::iterator it = _buckets.begin(); it != _buckets.end(); ++it)
+        {
+          Node* n = *it;
+          while (n)
+          {
+            Node* next = n->hnext;
+            Node*& b = buckets[n->hash & (size - 1)];
+            n->hnext = b;
+            b = n;
+            n = next;
+          }
+        }
+
+        _buckets.swap(buckets);
+      }
+
+    public:
+      typedef std::size_t size_type;
+      typedef Value value_type;
+
+      explicit HashLruCache(size_type maxElements_, const Hash& hash = Hash())
+        : _buckets(16, static_cast<Node*>(0)),
+          _head(0),
+          _tail(0),
+          _size(0),
+          _maxElements(maxElements_),
+          _hash(hash),
+          _hits(0),
+          _misses(0)
+        { }
+
+      ~HashLruCache()
+      { clear(); }
+
+      /// returns the number of elements currently in the cache
+      size_type size() const        { return _size; }
+
+      /// returns the maximum number of elements in the cache
+      size_type getMaxElements() const      { return _maxElements; }
+
+      void setMaxElements(size_type maxElements_)
+      {
+        _maxElements = maxElements_;
+        while (_size > _maxElements)
+          _remove(_tail);
+      }
+
+      /// removes a element from the cache and returns true, if found
+      template <typename K>
+      bool erase(const K& key)
+      {
+        Node* n = _find(key, cacheHashMix(_hash(key)));
+        if (n == 0)
+          return false;
+
+        _remove(n);
+        return true;
+      }
+
+      /// clears the cache.
+      void clear(bool stats = false)
+      {
+        Node* n = _head;
+        while (n)
+        {
+          Node* next = n->next;
+          delete n;
+          n = next;
+        }
+
+        _head = _tail = 0;
+        _size = 0;
+        _buckets.assign(_buckets.size(), static_cast<Node*>(0));
+
+        if (stats)
+          _hits = _misses = 0;
+      }
+
+      /// puts a new element in the cache. If the element is already found in
+      /// the cache, its value is replaced and it is pushed to the top of the
+      /// list.
+      Value& put(const Key& key, const Value& value)
+      {
+        std::size_t h = cacheHashMix(_hash(key));
+        Node* n = _find(key, h);
+        if (n)
+        {
+          n->value = value;
+          _moveToFront(n);
+          return n->value;
+        }
+
+        if (_size >= _maxElements && _tail)
+          _remove(_tail);
+
+        if (_size >= _buckets.size())
+          _rehash(_buckets.size() * 2);
+
+        n = new Node(key, value, h);
+        Node*& b = _bucket(h);
+        n->hnext = b;
+        b = n;
+        _pushFront(n);
+        ++_size;
+
+        return n->value;
+      }
+
+      template <typename K>
+      Value* getptr(const K& key)
+      {
+        Node* n = _find(key, cacheHashMix(_hash(key)));
+        if (n == 0)
+        {
+          ++_misses;
+          return 0;
+        }
+
+        _moveToFront(n);
+
+        ++_hits;
+        return &n->value;
+      }
+
+      /// returns a pair of values - a flag, if the value was found and the
+      /// value if found or the passed default otherwise. If the value is
+      /// found it is a cache hit and pushed to the top of the list.
+      template <typename K>
+      std::pair<bool, Value> getx(const K& key, Value def = Value())
+      {
+        Value* v = getptr(key);
+        return v ? std::pair<bool, Value>(true, *v)
+                 : std::pair<bool, Value>(false, def);
+      }
+
+      /// returns the value to a key or the passed default value if not found.
+      /// If the value is found it is a cache hit and pushed to the top of the
+      /// list.
+      template <typename K>
+      Value get(const K& key, Value def = Value())
+      {
+        return getx(key, def).second;
+      }
+
+      /// returns the number of hits.
+      unsigned getHits() const    { return _hits; }
+      /// returns the number of misses.
+      unsigned getMisses() const  { return _misses; }
+      /// returns the cache hit ratio between 0 and 1.
+      double hitRatio() const     { return _hits+_misses > 0 ? static_cast<double>(_hits)/static_cast<double>(_hits+_misses) : 0; }
+      /// returns the ratio, between held elements and maximum elements.
+      double fillfactor() const   { return static_cast<double>(_size) / static_cast<double>(_maxElements); }
+
+  };
+
+}
+
+#endif // CXXTOOLS_HASHLRUCACHE_H
@@ -45,12 +45,34 @@ class MessageHeader
         static const unsigned MAXHEADERSIZE = 4096;
 
     private:
+        static const unsigned INDEXSIZE = 64;  // must be a power of 2
+
         char _rawdata[MAXHEADERSIZE];  // key_1\0value_1\0key_2\0value_2\0...key_n\0value_n\0\0
         unsigned _endOffset;
         char* eptr() { return _rawdata + _endOffset; }
         unsigned _httpVersionMajor;
         unsigned _httpVersionMinor;
 
+        // Lookup index into _rawdata, which is kept up to date by the
+        // modifying methods, so that lookups do not modify the object. It is
+        // a open addressed hash table of the case insensitive key hashes.
+        // The slots hold the offset of the key plus one, so that 0 marks an
+        // empty slot. When there are too many keys for the table,
+        // _indexComplete is false and lookups of keys, which are not found
+        // in the index, fall back to a linear scan.
+        bool _indexComplete;
+        unsigned _indexCount;
+        unsigned short _index[INDEXSIZE];
+        unsigned _indexHash[INDEXSIZE];
+
+        // the parsed value of Content-Length, when it is in the index
+        std::size_t _contentLength;
+
+        void clearIndex();
+        void buildIndex();
+        void addIndex(const char* key);
+        const char* findHeader(const char* key, unsigned hash) const;
+
     public:
         typedef std::pair<const char*, const char*> value_type;
         class const_iterator
@@ -112,9 +134,13 @@ class MessageHeader
         MessageHeader()
             : _endOffset(0),
               _httpVersionMajor(1),
-              _httpVersionMinor(1)
+              _httpVersionMinor(1),
+              _indexComplete(true),
+              _indexCount(0),
+              _contentLength(0)
         {
             _rawdata[0] = _rawdata[1] = '\0';
+            std::memset(_index, 0, sizeof(_index));
         }
 
         virtual ~MessageHeader()  {}
@@ -126,8 +152,14 @@ class MessageHeader
         void addHeader(const char* key, const char* value)
         { setHeader(key, value, false); }
 
+        /// Adds a header, where key and value are given with their sizes and need not be zero terminated.
+        void addHeader(const char* key, std::size_t keySize, const char* value, std::size_t valueSize);
+
         void removeHeader(const char* key);
 
+        /// Returns the value of the first header with the key or 0 if not found.
+        /// The key is compared case insensitive. Lookups use a hash index,
+        /// which is updated when headers are modified.
         const char* getHeader(const char* key) const;
 
         bool hasHeader(const char* key) const
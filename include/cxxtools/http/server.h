@@ -93,8 +93,26 @@ class Server
         void listen(unsigned short int port, const std::string& certificateFile = std::string(), const std::string& privateKeyFile = std::string(), int sslVerifyLevel = 0, const std::string& sslCa = std::string())
             { listen(std::string(), port, certificateFile, privateKeyFile, sslVerifyLevel, sslCa); }
 
+        /// Adds a service, which is called when the url matches exactly.
         void addService(const std::string& url, Service& service);
+
+        /// Adds a service, which is called when the url matches the regular expression.
         void addService(const Regex& url, Service& service);
+
+        /// Adds a service, which is called for all urls starting with the prefix.
+        void addPrefixService(const std::string& prefix, Service& service);
+
+        /** Adds a service, which is called when the url matches the pattern.
+
+            The pattern may contain placeholders in curly braces like
+            "/user/{id}/profile". A placeholder matches a single non empty
+            path segment.
+
+            When multiple services match a url, they are tried in the order
+            they were added.
+         */
+        void addPatternService(const std::string& pattern, Service& service);
+
         void removeService(Service& service);
 
         Milliseconds readTimeout() const;
@@ -74,6 +74,14 @@ inline IOS_OpenMode operator~(IOS_OpenMode a)
 
 class IODeviceImpl;
 
+/** @brief Describes a buffer for scatter/gather writes
+*/
+struct IOVec
+{
+    const char* data;
+    size_t size;
+};
+
 /** @brief Endpoint for I/O operations
 
     This class serves as the base class for all kinds of I/O devices. The
@@ -146,6 +154,20 @@ class IODevice : public Selectable
          */
         size_t write(const char* buffer, size_t n);
 
+        //! @brief Write data from multiple buffers to I/O device
+        /**
+            Writes the buffers in order with a single system call where the
+            device supports it. Returns the number of bytes written, which may
+            be less than the total size of the buffers. A asynchronous write
+            started with beginWrite must not be pending.
+
+            \param vec array of buffers to be written.
+            \param count number of buffers.
+            \return number of bytes written.
+            \throw IOError
+         */
+        size_t writev(const IOVec* vec, size_t count);
+
         /** @brief Cancels asynchronous reading and writing
         */
         void cancel();
@@ -275,6 +297,9 @@ class IODevice : public Selectable
         //! @brief Write bytes to device
         virtual size_t onWrite(const char* buffer, size_t count);
 
+        //! @brief Write bytes from multiple buffers to device
+        virtual size_t onWritev(const IOVec* vec, size_t count);
+
         virtual void onClose();
 
         virtual void onCancel();
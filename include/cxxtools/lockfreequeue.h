@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_LOCKFREEQUEUE_H
+#define CXXTOOLS_LOCKFREEQUEUE_H
+
+#include <cxxtools/atomicity.h>
+#include <cxxtools/eventcount.h>
+#include <cxxtools/timespan.h>
+#include <utility>
+#include <cstddef>
+
+namespace cxxtools
+{
+    /** @brief A bounded lock free queue for multiple producers and consumers.
+
+        The queue is a ring buffer, where every cell has a sequence number,
+        which tells producers and consumers whether the cell may be written
+        or read. Producers and consumers synchronize only with a compare and
+        exchange on the write or read position. Blocking operations wait on
+        an EventCount, so no lock is taken unless a thread has to wait.
+
+        The interface follows cxxtools::Queue. Unlike Queue the capacity is
+        fixed at construction and rounded up to a power of 2. put blocks
+        while the queue is full.
+     */
+    template <typename T>
+    class LockFreeQueue
+    {
+#if __cplusplus >= 201103L
+            LockFreeQueue(const LockFreeQueue&) = delete;
+            LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+#else
+            LockFreeQueue(const LockFreeQueue&) { }
+            LockFreeQueue& operator=(const LockFreeQueue&) { return *this; }
+#endif
+
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+            typedef const T& const_reference;
+
+        private:
+            struct Cell
+            {
+                volatile atomic_t sequence;
+                value_type data;
+            };
+
+            // keep the positions of producers and consumers in different cache lines
+            char _pad0[64];
+            volatile atomic_t _writePos;
+            char _pad1[64 - sizeof(atomic_t)];
+            volatile atomic_t _readPos;
+            char _pad2[64 - sizeof(atomic_t)];
+
+            Cell* _cells;
+            atomic_t _mask;
+            volatile atomic_t _numWaiting;
+            EventCount _notEmpty;
+            EventCount _notFull;
+
+        public:
+            /// @brief Creates a queue with room for at least capacity elements.
+            explicit LockFreeQueue(size_type capacity = 1024);
+
+            ~LockFreeQueue()
+            { delete[] _cells; }
+
+            /** @brief Returns the next element.
+
+                If the queue is empty, the thread is blocked until a element
+                is available.
+             */
+            value_type get();
+
+            /** @brief Returns the next element if the queue is not empty.
+
+                If the queue is empty, the thread waits up to timeout
+                milliseconds until a element is available. When the queue
+                is still empty, a pair of a default constructed value_type
+                and false is returned.
+             */
+            std::pair<value_type, bool> get(const Milliseconds& timeout);
+
+            /** @brief Returns the next element if the queue is not empty.
+
+                If the queue is empty, a default constructed value_type is returned.
+                The returned flag is set to false, if the queue was empty.
+             */
+            std::pair<value_type, bool> tryGet();
+
+            /** @brief Adds a element to the queue.
+
+                If the queue is full, the method blocks until another thread
+                fetches a element.
+             */
+            void put(const_reference element);
+
+            /// @brief Adds a element to the queue and returns false, if the queue is full.
+            bool tryPut(const_reference element);
+
+            /// @brief Returns true, if the queue is empty.
+            bool empty()
+            { return size() == 0; }
+
+            /** @brief Returns the number of elements currently in queue.
+
+                The size is just a snapshot, since other threads may modify
+                the queue at any time.
+             */
+            size_type size()
+            {
+                atomic_t r = atomicGet(_readPos);
+                atomic_t w = atomicGet(_writePos);
+                atomic_t d = distance(w, r);
+                return d > 0 ? static_cast<size_type>(d) : 0;
+            }
+
+            /// @brief returns the maximum size of the queue.
+            size_type maxSize() const
+            { return static_cast<size_type>(_mask + 1); }
+
+            /// @brief returns the number of threads blocked in the get method.
+            size_type numWaiting()
+            { return static_cast<size_type>(atomicGet(_numWaiting)); }
+
+        private:
+            bool pop(value_type& element);
+
+            // Positions wrap around, so the arithmetic is done unsigned. The
+            // difference of two positions is small and may be negative.
+            static atomic_t advance(atomic_t pos, std::size_t n)
+            { return static_cast<atomic_t>(static_cast<std::size_t>(pos) + n); }
+
+            static atomic_t distance(atomic_t to, atomic_t from)
+            { return static_cast<atomic_t>(static_cast<std::size_t>(to) - static_cast<std::size_t>(from)); }
+
+            Cell& cellAt(atomic_t pos)
+            { return _cells[static_cast<std::size_t>(pos) & static_cast<std::size_t>(_mask)]; }
+    };
+
+    template <typename T>
+    LockFreeQueue<T>::LockFreeQueue(size_type capacity)
+        : _writePos(0),
+          _readPos(0),
+          _numWaiting(0)
+    {
+        size_type size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        _cells = new Cell[size];
+        _mask = static_cast<atomic_t>(size - 1);
+
+        for (size_type n = 0; n < size; ++n)
+            _cells[n].sequence = static_cast<atomic_t>(n);
+    }
+
+    template <typename T>
+    bool LockFreeQueue<T>::tryPut(const_reference element)
+    {
+        // the position is just a hint, which is verified by the compare and exchange
+        atomic_t pos = _writePos;
+        Cell* cell;
+
+        for (;;)
+        {
+            cell = &cellAt(pos);
+            atomic_t dif = distance(atomicGet(cell->sequence), pos);
+            if (dif == 0)
+            {
+                atomic_t p = atomicCompareExchange(_writePos, advance(pos, 1), pos);
+                if (p == pos)
+                    break;
+                pos = p;
+            }
+            else if (dif < 0)
+            {
+                // the cell still holds the element of the previous round
+                return false;
+            }
+            else
+            {
+                pos = _writePos;
+            }
+        }
+
+        cell->data = element;
+        atomicSet(cell->sequence, advance(pos, 1));
+
+        _notEmpty.notify();
+        return true;
+    }
+
+    template <typename T>
+    bool LockFreeQueue<T>::pop(value_type& element)
+    {
+        // the position is just a hint, which is verified by the compare and exchange
+        atomic_t pos = _readPos;
+        Cell* cell;
+
+        for (;;)
+        {
+            cell = &cellAt(pos);
+            atomic_t dif = distance(atomicGet(cell->sequence), advance(pos, 1));
+            if (dif == 0)
+            {
+                atomic_t p = atomicCompareExchange(_readPos, advance(pos, 1), pos);
+                if (p == pos)
+                    break;
+                pos = p;
+            }
+            else if (dif < 0)
+            {
+                // the cell is not written yet
+                return false;
+            }
+            else
+            {
+                pos = _readPos;
+            }
+        }
+
+        element = cell->data;
+        cell->data = value_type();
+        atomicSet(cell->sequence, advance(pos, static_cast<std::size_t>(_mask) + 1));
+
+        _notFull.notify();
+        return true;
+    }
+
+    template <typename T>
+    std::pair<typename LockFreeQueue<T>::value_type, bool> LockFreeQueue<T>::tryGet()
+    {
+        std::pair<value_type, bool> ret(value_type(), false);
+        ret.second = pop(ret.first);
+        return ret;
+    }
+
+    template <typename T>
+    typename LockFreeQueue<T>::value_type LockFreeQueue<T>::get()
+    {
+        value_type element = value_type();
+        if (pop(element))
+            return element;
+
+        atomicIncrement(_numWaiting);
+
+        for (;;)
+        {
+            EventCount::Key key = _notEmpty.prepareWait();
+            if (pop(element))
+            {
+                _notEmpty.cancelWait();
+                break;
+            }
+
+            _notEmpty.wait(key);
+        }
+
+        atomicDecrement(_numWaiting);
+        return element;
+    }
+
+    template <typename T>
+    std::pair<typename LockFreeQueue<T>::value_type, bool> LockFreeQueue<T>::get(const Milliseconds& timeout)
+    {
+        std::pair<value_type, bool> ret(value_type(), false);
+        if (pop(ret.first))
+        {
+            ret.second = true;
+            return ret;
+        }
+
+        atomicIncrement(_numWaiting);
+
+        Timespan until = Timespan::gettimeofday() + timeout;
+        for (;;)
+        {
+            EventCount::Key key = _notEmpty.prepareWait();
+            if (pop(ret.first))
+            {
+                _notEmpty.cancelWait();
+                ret.second = true;
+                break;
+            }
+
+            Timespan remaining = until - Timespan::gettimeofday();
+            if (remaining <= Timespan(0))
+            {
+                _notEmpty.cancelWait();
+                break;
+            }
+
+            _notEmpty.wait(key, remaining);
+        }
+
+        atomicDecrement(_numWaiting);
+        return ret;
+    }
+
+    template <typename T>
+    void LockFreeQueue<T>::put(const_reference element)
+    {
+        while (!tryPut(element))
+        {
+            EventCount::Key key = _notFull.prepareWait();
+            if (tryPut(element))
+            {
+                _notFull.cancelWait();
+                break;
+            }
+
+            _notFull.wait(key);
+        }
+    }
+}
+
+#endif // CXXTOOLS_LOCKFREEQUEUE_H
@@ -30,7 +30,14 @@
 
 #include <cxxtools/config.h>
 
-#if defined(CXXTOOLS_ATOMICITY_SUN)
+#if defined(CXXTOOLS_ATOMICITY_STDCXX)
+    #if __cplusplus >= 201103L
+        #include <cxxtools/membar.stdcxx.h>
+    #else
+        #include <cxxtools/membar.gcc.h>
+    #endif
+
+#elif defined(CXXTOOLS_ATOMICITY_SUN)
     #include <cxxtools/membar.sun.h>
 
 #elif defined(CXXTOOLS_ATOMICITY_WINDOWS)
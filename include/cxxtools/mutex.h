@@ -33,12 +33,29 @@
 
 namespace cxxtools {
 
+/** @brief Hint to the processor, that the caller is in a spin loop.
+
+    On x86 this executes the pause instruction, which reduces the power
+    consumption and the penalty when leaving the loop.
+*/
+inline void cpuRelax()
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+    asm volatile ("yield" : : : "memory");
+#endif
+}
+
 /** @brief Mutual exclusion device.
 
     A Mutex is a mutual exclusion device. It is used to synchronize
     the access to data which is accessed by more than one thread or
     process at the same time. Mutexes are not recursive, that is the
     same thread can not lock a mutex multiple times without deadlocking.
+
+    On Linux the mutex spins shortly with exponential backoff, when it is
+    locked by another thread, and then sleeps on a futex.
 */
 class Mutex
 {
@@ -355,6 +372,155 @@ class ReadWriteMutex
 };
 
 
+/** @brief Read/write mutex for read mostly data
+
+    The %ShardedReadWriteMutex keeps the count of readers in one counter per
+    CPU, each in its own cache line. Readers therefore do not contend on a
+    shared counter and read locks scale with the number of CPUs. A writer
+    has to check all counters, which makes write locks more expensive
+    than with a ReadWriteMutex.
+
+    Unlike ReadWriteMutex, read and write locks are released with
+    readUnlock() and writeUnlock().
+*/
+class ShardedReadWriteMutex
+{
+#if __cplusplus >= 201103L
+        ShardedReadWriteMutex(const ShardedReadWriteMutex&) = delete;
+        ShardedReadWriteMutex& operator=(const ShardedReadWriteMutex&) = delete;
+#else
+        ShardedReadWriteMutex(const ShardedReadWriteMutex&) { }
+        ShardedReadWriteMutex& operator=(const ShardedReadWriteMutex&) { return *this; }
+#endif
+    public:
+        ShardedReadWriteMutex();
+
+        ~ShardedReadWriteMutex();
+
+        //! @brief Acquires a read lock, waiting for a writer to finish.
+        void readLock();
+
+        bool tryReadLock();
+
+        void readUnlock();
+
+        //! @brief Acquires a write lock, waiting for all readers to finish.
+        void writeLock();
+
+        bool tryWriteLock();
+
+        void writeUnlock();
+
+    private:
+        //! @internal
+        class ShardedReadWriteMutexImpl* _impl;
+};
+
+
+class ShardedReadLock
+{
+#if __cplusplus >= 201103L
+        ShardedReadLock(const ShardedReadLock&) = delete;
+        ShardedReadLock& operator=(const ShardedReadLock&) = delete;
+#else
+        ShardedReadLock(const ShardedReadLock&);
+        ShardedReadLock& operator=(const ShardedReadLock&);
+#endif
+
+    public:
+        explicit ShardedReadLock(ShardedReadWriteMutex& m, bool doLock = true, bool isLocked = false)
+        : _mutex(m)
+        , _locked(isLocked)
+        {
+            if (doLock)
+                this->lock();
+        }
+
+        ~ShardedReadLock()
+        {
+            if (_locked)
+                _mutex.readUnlock();
+        }
+
+        void lock()
+        {
+            if ( !_locked )
+            {
+                _mutex.readLock();
+                _locked = true;
+            }
+        }
+
+        void unlock()
+        {
+            if ( _locked)
+            {
+                _mutex.readUnlock();
+                _locked = false;
+            }
+        }
+
+        ShardedReadWriteMutex& mutex()
+        { return _mutex; }
+
+    private:
+        ShardedReadWriteMutex& _mutex;
+        bool _locked;
+};
+
+
+class ShardedWriteLock
+{
+#if __cplusplus >= 201103L
+        ShardedWriteLock(const ShardedWriteLock&) = delete;
+        ShardedWriteLock& operator=(const ShardedWriteLock&) = delete;
+#else
+        ShardedWriteLock(const ShardedWriteLock&);
+        ShardedWriteLock& operator=(const ShardedWriteLock&);
+#endif
+
+    public:
+        explicit ShardedWriteLock(ShardedReadWriteMutex& m, bool doLock = true, bool isLocked = false)
+        : _mutex(m)
+        , _locked(isLocked)
+        {
+            if (doLock)
+                this->lock();
+        }
+
+        ~ShardedWriteLock()
+        {
+            if (_locked)
+                _mutex.writeUnlock();
+        }
+
+        void lock()
+        {
+            if ( !_locked )
+            {
+                _mutex.writeLock();
+                _locked = true;
+            }
+        }
+
+        void unlock()
+        {
+            if ( _locked)
+            {
+                _mutex.writeUnlock();
+                _locked = false;
+            }
+        }
+
+        ShardedReadWriteMutex& mutex()
+        { return _mutex; }
+
+    private:
+        ShardedReadWriteMutex& _mutex;
+        bool _locked;
+};
+
+
 class ReadLock
 {
 #if __cplusplus >= 201103L
@@ -502,10 +668,19 @@ class SpinMutex
         */
         inline void lock()
         {
-            // busy loop until unlock
+            // busy loop with exponential backoff until unlock; give up the
+            // CPU only when the lock is held longer
+            unsigned backoff = 1;
             while( atomicCompareExchange(_count, 1, 0) )
             {
-                Thread::yield();
+                if (backoff <= 1024)
+                {
+                    for (unsigned n = 0; n < backoff && _count != 0; ++n)
+                        cpuRelax();
+                    backoff <<= 1;
+                }
+                else
+                    Thread::yield();
             }
         }
 
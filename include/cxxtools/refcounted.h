@@ -68,8 +68,8 @@ namespace cxxtools
 
       virtual ~AtomicRefCounted()  { }
 
-      virtual atomic_t addRef()  { return atomicIncrement(rc); }
-      virtual atomic_t release() { atomic_t ret = atomicDecrement(rc); return ret; }
+      virtual atomic_t addRef()  { return atomicRefIncrement(rc); }
+      virtual atomic_t release() { return atomicRefDecrement(rc); }
       atomic_t refs() const      { return rc; }
   };
 
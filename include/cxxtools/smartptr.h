@@ -192,7 +192,7 @@ namespace cxxtools
 
       bool unlink(ObjectType* object)
       {
-        if (object && atomicDecrement(*rc) <= 0)
+        if (object && atomicRefDecrement(*rc) <= 0)
         {
           delete rc;
           rc = 0;
@@ -211,7 +211,7 @@ namespace cxxtools
           else
           {
             rc = ptr.rc;
-            atomicIncrement(*rc);
+            atomicRefIncrement(*rc);
           }
         }
         else
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_SPINLOCKEDSMARTPTR_H
+#define CXXTOOLS_SPINLOCKEDSMARTPTR_H
+
+#include <cxxtools/smartptr.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/thread.h>
+
+namespace cxxtools
+{
+  /** A SmartPtr, which can be read and replaced concurrently.
+
+      A plain SmartPtr must not be copied by one thread while another thread
+      assigns to it. SpinLockedSmartPtr guards the pointer with a spin lock,
+      which is held only while the reference is copied or replaced. It is
+      not lock free: a thread, which is preempted while holding the lock,
+      delays the other threads accessing the same pointer. Since the critical
+      section is only a reference count update, this is rare and much cheaper
+      than a mutex. It is suitable for shared snapshots like configuration
+      data: readers load() a SmartPtr, which stays valid until they release
+      it, while a writer store()s a new snapshot.
+
+      The destruction of a replaced object happens outside the critical
+      section in the thread, which releases the last reference.
+   */
+  template <typename ObjectType,
+            template <class> class OwnershipPolicy = InternalRefCounted,
+            template <class> class DestroyPolicy = DefaultDestroyPolicy>
+  class SpinLockedSmartPtr
+  {
+    public:
+      typedef SmartPtr<ObjectType, OwnershipPolicy, DestroyPolicy> PtrType;
+
+    private:
+      PtrType _ptr;
+      mutable volatile atomic_t _locked;
+
+#if __cplusplus >= 201103L
+      SpinLockedSmartPtr(const SpinLockedSmartPtr&) = delete;
+      SpinLockedSmartPtr& operator=(const SpinLockedSmartPtr&) = delete;
+#else
+      SpinLockedSmartPtr(const SpinLockedSmartPtr&) { }
+      SpinLockedSmartPtr& operator=(const SpinLockedSmartPtr&) { return *this; }
+#endif
+
+      void lock() const
+      {
+        unsigned spin = 0;
+        while (atomicCompareExchange(_locked, 1, 0) != 0)
+        {
+          if (++spin >= 64)
+          {
+            Thread::yield();
+            spin = 0;
+          }
+        }
+      }
+
+      void unlock() const
+      { atomicExchange(_locked, 0); }
+
+    public:
+      SpinLockedSmartPtr()
+        : _locked(0)
+        { }
+
+      explicit SpinLockedSmartPtr(const PtrType& ptr)
+        : _ptr(ptr),
+          _locked(0)
+        { }
+
+      /// Returns a copy of the current pointer.
+      PtrType load() const
+      {
+        lock();
+        PtrType ret = _ptr;
+        unlock();
+        return ret;
+      }
+
+      /// Replaces the current pointer.
+      void store(const PtrType& ptr)
+      {
+        exchange(ptr);
+      }
+
+      /// Replaces the current pointer and returns the previous one.
+      PtrType exchange(const PtrType& ptr)
+      {
+        // the previous object is kept by ret, so that it is never
+        // destroyed while locked
+        lock();
+        PtrType ret = _ptr;
+        _ptr = ptr;
+        unlock();
+        return ret;
+      }
+
+      /** Replaces the pointer with desired, when it still points to the
+          object of expected.
+
+          Returns true, when the pointer was replaced. Otherwise expected is
+          set to the current pointer.
+       */
+      bool compareExchange(PtrType& expected, const PtrType& desired)
+      {
+        PtrType old;
+        lock();
+        if (_ptr.getPointer() == expected.getPointer())
+        {
+          old = _ptr;
+          _ptr = desired;
+          unlock();
+          return true;
+        }
+
+        old = expected;
+        expected = _ptr;
+        unlock();
+        return false;
+      }
+  };
+
+}
+
+#endif // CXXTOOLS_SPINLOCKEDSMARTPTR_H
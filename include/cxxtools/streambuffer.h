@@ -30,6 +30,7 @@
 
 #include <ios>
 #include <streambuf>
+#include <vector>
 #include <cxxtools/iodevice.h>
 
 namespace cxxtools
@@ -50,6 +51,22 @@ class BasicStreamBuffer : public std::basic_streambuf<CharT>
              return 0;
         }
 
+        /** Returns a pointer to the characters in the get area.
+
+            The characters can be inspected in place without copying. The
+            number of characters available is returned by in_size().
+         */
+        const CharT* in_data() const
+        { return this->gptr(); }
+
+        /// Returns the number of characters in the get area without reading from the device.
+        std::streamsize in_size() const
+        { return this->gptr() ? this->egptr() - this->gptr() : 0; }
+
+        /// Consumes n characters from the get area, which must be available.
+        void in_skip(std::streamsize n)
+        { this->gbump(static_cast<int>(n)); }
+
     protected:
         virtual std::streamsize xspeekn(CharT* buffer, std::streamsize size)
         {
@@ -141,6 +158,19 @@ class StreamBuffer : public BasicStreamBuffer<char>,
          */
         void discard();
 
+        /** Queues data to be written after the current content of the output buffer.
+
+            The data is not copied into the buffer but referenced and written
+            directly to the device. Blocking flushes pass the buffered and
+            referenced data to the device in a single gather write. The
+            caller must keep the data valid until it is written, i.e. until
+            sync returns or out_avail returns 0.
+         */
+        void writeRef(const char* data, size_t size);
+
+        /// Returns the number of bytes to be written including referenced data.
+        std::streamsize out_avail();
+
         /** Signals, that the underlying I/O device has data to read.
          */
         Signal<StreamBuffer&> inputReady;
@@ -173,6 +203,20 @@ class StreamBuffer : public BasicStreamBuffer<char>,
 
         void onWrite(IODevice& dev);
 
+        void chunkTail();
+        void consumeChunks(size_t n);
+        void flushChunks();
+
+        struct OChunk
+        {
+            const char* data;   // referenced data or 0 for data in the output buffer
+            size_t offset;      // offset in the output buffer
+            size_t size;
+
+            const char* begin(const char* obuffer) const
+            { return data ? data : obuffer + offset; }
+        };
+
     private:
         IODevice* _ioDevice;
         size_t _ibufferSize;
@@ -181,6 +225,11 @@ class StreamBuffer : public BasicStreamBuffer<char>,
         char* _obuffer;
         const size_t _pbmax;
         bool _oextend;
+
+        // output queued with writeRef; the buffer content starting at
+        // _omark is not yet part of the queue
+        std::vector<OChunk> _ochunks;
+        size_t _omark;
 };
 
 } // namespace cxxtools
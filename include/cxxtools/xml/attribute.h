@@ -49,9 +49,12 @@ namespace xml {
      */
     class Attribute
     {
+            friend class XmlReaderImpl;
+
         public:
             //! Constructs a new Attribute object with an empty name and value.
             Attribute()
+            : _nameId(0)
             { }
 
             /**
@@ -61,19 +64,19 @@ namespace xml {
              * @param value The value of the XML attribute.
              */
             Attribute(const String& name, const String& value)
-            : _name(name), _value(value)
+            : _name(name), _value(value), _nameId(0)
             { }
 
             Attribute(const String& name, const Date& value)
-            : _name(name), _value(value.toString("%Y-%m-%d"))
+            : _name(name), _value(value.toString("%Y-%m-%d")), _nameId(0)
             { }
 
             Attribute(const String& name, const Time& value)
-            : _name(name), _value(value.toString("%H:%M:%S"))
+            : _name(name), _value(value.toString("%H:%M:%S")), _nameId(0)
             { }
 
             Attribute(const String& name, const DateTime& value)
-            : _name(name), _value(value.toString("%Y-%m-%dT%H:%M:%S"))
+            : _name(name), _value(value.toString("%Y-%m-%dT%H:%M:%S")), _nameId(0)
             { }
 
             /**
@@ -91,7 +94,11 @@ namespace xml {
              * @param name The new name of this attribute.
              */
             void setName(const String& name)
-            { _name = name; }
+            { _name = name; _nameId = 0; }
+
+            //! Returns the id of the name in the name table of the reader or 0.
+            unsigned nameId() const
+            { return _nameId; }
 
             /**
              * @brief Returns the value of this attribute.
@@ -111,7 +118,7 @@ namespace xml {
             { _value = value; }
 
             void clear()
-            { _name.clear(); _value.clear(); }
+            { _name.clear(); _value.clear(); _nameId = 0; }
 
         private:
             //! The name of this attribute.
@@ -119,6 +126,9 @@ namespace xml {
 
             //! The value of this attribute.
             String _value;
+
+            //! The id of the name in the name table of the reader.
+            unsigned _nameId;
     };
 
     typedef std::vector<Attribute> Attributes;
@@ -53,6 +53,8 @@ namespace cxxtools {
          */
         class EndElement : public Node
         {
+                friend class XmlReaderImpl;
+
             public:
                 /**
                  * @brief Constructs a new EndElement object with the given (optional) string as tag name.
@@ -62,7 +64,8 @@ namespace cxxtools {
                  */
                 explicit EndElement(const String& name = String())
                 : Node(Node::EndElement),
-                  _name(name)
+                  _name(name),
+                  _nameId(0)
                 { }
 
                 /**
@@ -73,7 +76,7 @@ namespace cxxtools {
                 {return new EndElement(*this);}
 
                 void clear()
-                { _name.clear(); }
+                { _name.clear(); _nameId = 0; }
 
                 /**
                  * @brief Returns the tag name of the closing tag for which this EndElement object was created.
@@ -104,7 +107,14 @@ namespace cxxtools {
                  * @param name The new name for this EndElement object.
                  */
                 void setName(const String& name)
-                { _name = name; }
+                { _name = name; _nameId = 0; }
+
+                /**
+                 * @brief Returns the id of the name in the name table of the reader or 0.
+                 * @see StartElement::nameId()
+                 */
+                unsigned nameId() const
+                { return _nameId; }
 
                 /**
                  * @brief Compares this EndElement object with the given node.
@@ -120,6 +130,9 @@ namespace cxxtools {
             private:
                 //! The tag name of this end tag.
                 String _name;
+
+                //! The id of the name in the name table of the reader.
+                unsigned _nameId;
         };
 
     }
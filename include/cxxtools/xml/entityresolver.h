@@ -27,6 +27,7 @@
 #define cxxtools_xml_EntityResolver_h
 
 #include <cxxtools/string.h>
+#include <string>
 #include <map>
 
 namespace cxxtools
@@ -104,6 +105,22 @@ class EntityResolver
          */
         void getEntity(std::basic_ostream<Char>& os, Char ch) const;
 
+        /**
+         * @brief Outputs the text with all characters replaced by their entities where needed.
+         *
+         * The output is the same as calling getEntity() for each character, but characters,
+         * which need no replacement, are written in runs.
+         */
+        void getEntities(std::basic_ostream<Char>& os, const String& text) const;
+
+        /**
+         * @brief Appends the text with all characters replaced by their entities where needed.
+         *
+         * All characters, which are not printable ascii, are replaced, so the result is valid
+         * utf-8 (and ascii) without further encoding.
+         */
+        void getEntities(std::string& out, const String& text) const;
+
     private:
         //! Entity map containing entities which are associated to their resolved entity value.
         typedef std::map<String, String> EntityMap;
@@ -56,10 +56,13 @@ namespace xml {
      */
     class StartElement : public Node
     {
+            friend class XmlReaderImpl;
+
         public:
             //! Constructs a new StartElement object with no name and an empty attribute list.
             StartElement()
-            : Node(Node::StartElement)
+            : Node(Node::StartElement),
+              _nameId(0)
             { }
 
             /**
@@ -70,7 +73,8 @@ namespace xml {
              */
             StartElement(const String& name)
             : Node(Node::StartElement),
-              _name(name)
+              _name(name),
+              _nameId(0)
             { }
 
             /**
@@ -84,6 +88,7 @@ namespace xml {
             void clear()
             {
                 _name.clear();
+                _nameId = 0;
                 _attributes.clear();
             }
 
@@ -115,7 +120,19 @@ namespace xml {
              * @param name The new name for this StartElement object.
              */
             void setName(const String& name)
-            {_name = name;}
+            {_name = name; _nameId = 0;}
+
+            /**
+             * @brief Returns the id of the name in the name table of the reader, which created this StartElement.
+             *
+             * Names with equal ids are equal, so that they can be compared without comparing strings.
+             * The id is 0, when the name was not interned, e.g. when the StartElement was not created by
+             * a XmlReader. Modifying the name through name() does not update the id.
+             *
+             * @see XmlReader::nameId()
+             */
+            unsigned nameId() const
+            {return _nameId;}
 
             /**
              * @brief Add the given attribute to the attribute list of this start tag.
@@ -213,6 +230,9 @@ namespace xml {
             //! The name of the underlying tag.
             String _name;
 
+            //! The id of the name in the name table of the reader.
+            unsigned _nameId;
+
             //! The list which contains all attributes of the underlying tag.
             Attributes _attributes;
 
@@ -32,7 +32,9 @@
 #include <cxxtools/deserializer.h>
 #include "cxxtools/xml/xmlreader.h"
 #include "cxxtools/xml/startelement.h"
+#include "cxxtools/xml/endelement.h"
 #include <sstream>
+#include <vector>
 
 namespace cxxtools
 {
@@ -56,7 +58,12 @@ namespace xml
              */
             explicit XmlDeserializer(bool readAttributes = false, const String& attributePrefix = cxxtools::String())
                 : _readAttributes(readAttributes),
-                  _attributePrefix(attributePrefix)
+                  _nodeNameId(0),
+                  _typeId(0),
+                  _categoryId(0),
+                  _attributePrefix(attributePrefix),
+                  _reader(0),
+                  _matchDepth(0)
             { }
 
             /** Initializes a deserializer and reads a xml structure into the underlying SerializationInfo.
@@ -79,6 +86,30 @@ namespace xml
              */
             void parse(std::basic_istream<Char>& is);
 
+            /** Reads the next element at the given path into the underlying SerializationInfo.
+
+                The path lists the names of the elements from the root element
+                down to the selected elements separated by '/', e.g.
+                "/root/record". Other elements are skipped. Each call replaces
+                the content of the SerializationInfo, so that documents with
+                many repeated elements can be processed with memory bounded by
+                the largest selected element:
+
+                @code
+                  cxxtools::xml::XmlReader reader(in);
+                  cxxtools::xml::XmlDeserializer d;
+                  while (d.parseNext(reader, L"/root/record"))
+                  {
+                      Record record;
+                      d.deserialize(record);
+                      process(record);
+                  }
+                @endcode
+
+                Returns false, when the end of the document is reached.
+             */
+            bool parseNext(XmlReader& reader, const String& path);
+
             /** Specifies whether xml attributes should be read into members.
 
                 By default attributes are ignored. When the flag is set,
@@ -128,8 +159,32 @@ namespace xml
                d.deserialize(type);
             }
 
+            /** Deserializes each element at the given path and passes it to a callback.
+
+                The callback is called with a `const T&` once for every
+                selected element. See parseNext for the syntax of the path.
+             */
+            template <typename T, typename F>
+            static void forEach(std::istream& in, const String& path, F f, bool readAttributes = false)
+            {
+               XmlReader reader(in);
+               XmlDeserializer d(readAttributes);
+               while (d.parseNext(reader, path))
+               {
+                   T type;
+                   d.deserialize(type);
+                   f(static_cast<const T&>(type));
+               }
+            }
+
         private:
 
+            //! @internal
+            void setReader(XmlReader& reader);
+
+            //! @internal
+            void parseElement(XmlReader& reader);
+
             //! @internal
             void beginDocument(XmlReader& reader);
 
@@ -161,6 +216,17 @@ namespace xml
             //! @internal
             String _nodeName;
 
+            //! id of _nodeName in the name table of the reader
+            unsigned _nodeNameId;
+
+            //! ids of the "type" and "category" attributes
+            unsigned _typeId;
+            unsigned _categoryId;
+
+            //! narrowed node names indexed by name id
+            std::vector<std::string> _narrowNames;
+            std::string _narrowName;
+
             String _nodeId;
 
             String _nodeType;
@@ -171,8 +237,29 @@ namespace xml
 
             String _attributePrefix;
 
+            //! reader, the name ids are taken from
+            XmlReader* _reader;
+
+            //! selected path of parseNext
+            String _path;
+            std::vector<String> _pathNames;
+            std::vector<unsigned> _pathIds;
+
+            //! number of path elements matched by the currently open elements
+            size_t _matchDepth;
+
             SerializationInfo::Category nodeCategory() const;
 
+            void setNode(const StartElement& se);
+
+            void setNode(const EndElement& ee);
+
+            bool isNode(const EndElement& ee) const;
+
+            const std::string& nodeName();
+
+            void beginNodeMember();
+
             void processAttributes(const Attributes& attributes);
 
     };
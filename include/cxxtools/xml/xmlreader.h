@@ -141,6 +141,12 @@ class XmlReader
                      - ReportComments
                      - ReportDocumentStart
         */
+        /** @brief Creates a reader without input.
+
+            One of the reset methods must be called before reading.
+         */
+        XmlReader();
+
         XmlReader(std::istream& is, int flags = 0);
 
         XmlReader(std::basic_istream<Char>& is, int flags = 0);
@@ -187,6 +193,17 @@ class XmlReader
 
         std::size_t line() const;
 
+        /** @brief Returns the id of a element or attribute name.
+
+            The reader assigns ids to the names it reads, which are returned
+            by StartElement::nameId(), EndElement::nameId() and
+            Attribute::nameId(). Looking up the id of a name once allows
+            comparing names of nodes without comparing strings. The ids are
+            kept, when the reader is reset. A return value of 0 means, that
+            the name table of the reader is full.
+         */
+        unsigned nameId(const String& name);
+
     private:
         class XmlReaderImpl* _impl;
 };
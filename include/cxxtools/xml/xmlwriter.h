@@ -27,21 +27,44 @@
 #define cxxtools_Xml_XmlWriter_h
 
 #include <cxxtools/string.h>
-#include <cxxtools/textstream.h>
 #include <cxxtools/xml/attribute.h>
-#include <stack>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace cxxtools {
 
 namespace xml {
 
+    /**
+       Writes xml as utf-8 to a std::ostream.
+
+       The output is collected in a buffer and written to the stream, when
+       it grows large, on flush(), when a new stream is set with begin() and
+       when the writer is destroyed.
+
+       Element names may be passed as cxxtools::String or as std::string.
+       The latter is treated like cxxtools::String::widen() of it. The
+       utf-8 encoded open and close tags are kept for repeated names.
+     */
     class XmlWriter
     {
+#if __cplusplus >= 201103L
+            XmlWriter(const XmlWriter&) = delete;
+            XmlWriter& operator=(const XmlWriter&) = delete;
+#else
+            XmlWriter(const XmlWriter&);
+            XmlWriter& operator=(const XmlWriter&);
+#endif
+
         public:
             XmlWriter();
 
             XmlWriter(std::ostream& os, int format =  UseXmlDeclaration | UseIndent | UseEndl);
 
+            ~XmlWriter();
+
             void begin(std::ostream& os);
 
             void writeStartElement(const cxxtools::String& localName);
@@ -51,6 +74,10 @@ namespace xml {
             void writeStartElement(const cxxtools::String& localName, const Attributes& attr)
                 { writeStartElement(localName, &attr[0], attr.size()); }
 
+            void writeStartElement(const std::string& localName);
+
+            void writeStartElement(const std::string& localName, const Attribute* attr, size_t attrCount);
+
             void writeEndElement();
 
             void writeElement(const cxxtools::String& localName, const cxxtools::String& content);
@@ -60,6 +87,10 @@ namespace xml {
             void writeElement(const cxxtools::String& localName, const Attributes& attr, const cxxtools::String& content)
                 { writeElement(localName, &attr[0], attr.size(), content); }
 
+            void writeElement(const std::string& localName, const cxxtools::String& content);
+
+            void writeElement(const std::string& localName, const Attribute* attr, size_t attrCount, const cxxtools::String& content);
+
             void writeContent(const cxxtools::String& text);
 
             void writeCharacters(const cxxtools::String& text);
@@ -119,16 +150,39 @@ namespace xml {
             };
 
         private:
+            // utf-8 encoded element name and close tag
+            struct Tag
+            {
+                std::string name;
+                std::string close;
+            };
+
+            const Tag& tag(const cxxtools::String& name);
+            const Tag& tag(const std::string& name);
+            void startElement(const Tag& tag, const Attribute* attr, size_t attrCount);
+            void element(const Tag& tag, const Attribute* attr, size_t attrCount, const cxxtools::String& content);
+            void writeAttributes(const Attribute* attr, size_t attrCount);
+            void write();
+
             void indent(size_t size);
             void indent();
 
-            TextOStream _tos;
-            std::stack<cxxtools::String> _elements;
+            std::ostream* _out;
+            std::string _buffer;
+
+            // close tags of the open elements; the strings are reused
+            std::vector<std::string> _elements;
+            size_t _depth;
+
+            std::map<cxxtools::String, Tag> _tags;
+            std::map<std::string, Tag> _stdTags;
+            Tag _tag;
+
             int _flags;
     };
 
     inline void XmlWriter::indent()
-    { indent(_elements.size()); }
+    { indent(_depth); }
 }
 
 }
@@ -36,7 +36,6 @@
 #include <cxxtools/xml/xmlwriter.h>
 #include <cxxtools/http/responder.h>
 #include <cxxtools/deserializer.h>
-#include <cxxtools/textstream.h>
 
 namespace cxxtools
 {
@@ -84,7 +83,6 @@ class XmlRpcResponder : public http::Responder
 
     private:
         State _state;
-        TextIStream _ts;
         xml::XmlReader _reader;
         xml::XmlWriter _writer;
         Scanner _scanner;
@@ -40,6 +40,9 @@ namespace xml
 {
 
 class Node;
+class StartElement;
+class EndElement;
+class XmlReader;
 
 }
 
@@ -73,26 +76,53 @@ class Scanner
         OnArrayEnd
     };
 
+    enum Element
+    {
+        ValueElement,
+        StructElement,
+        ArrayElement,
+        MemberElement,
+        NameElement,
+        DataElement,
+        ParamElement,
+        FaultElement,
+        ElementCount
+    };
+
     public:
         Scanner()
         : _state(OnParam)
         , _deserializer(0)
         , _composer(0)
-        {}
+        {
+            for (unsigned n = 0; n < ElementCount; ++n)
+                _ids[n] = 0;
+        }
 
         ~Scanner()
         {}
 
         void begin(Deserializer& handler, IComposer& composer);
 
+        /** Like begin(handler, composer), but the element names of the
+            XML-RPC grammar are compared by their ids in the name table of
+            the reader instead of as strings.
+         */
+        void begin(Deserializer& handler, IComposer& composer, xml::XmlReader& reader);
+
         bool advance(const xml::Node& node);
 
     private:
+        bool isElement(const xml::StartElement& se, Element element) const;
+
+        bool isElement(const xml::EndElement& ee, Element element) const;
+
         State _state;
         Deserializer* _deserializer;
         IComposer* _composer;
         String _value;
         String _type;
+        unsigned _ids[ElementCount];
 };
 
 }
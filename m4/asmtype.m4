@@ -49,13 +49,24 @@ AC_DEFUN([AC_CXXTOOLS_ATOMICTYPE],
     [atomictype],
     AS_HELP_STRING([--with-atomictype],
                    [force atomic type. Accepted arguments:
-                    sun, windows, att_x86, att_x86_64, att_arm, att_mips, att_ppc, att_sparc32, att_sparc64, pthread,
+                    stdcxx (C++11 std::atomic, never probed), sun, windows, att_x86, att_x86_64, att_arm, att_mips, att_ppc, att_sparc32, att_sparc64, pthread,
                     generic, probe]),
     [ ac_cxxtools_atomicity=$withval ],
     [ ac_cxxtools_atomicity=probe ])
 
   dnl check, if atomictype is valid
 
+  dnl C++11 std::atomic
+  dnl It is not probed but must be selected explicitly, since it changes
+  dnl atomic_t and makes the functions inline, so that applications built
+  dnl against the installed headers depend on the selected type.
+  if test "$ac_cxxtools_atomicity" = "stdcxx"
+  then
+    AC_CHECKATOMICTYPE([stdcxx], [CXXTOOLS_ATOMICITY_STDCXX],
+        [ #include <atomic>
+          std::atomic<long> value(0);
+          int main() { value.fetch_add(1, std::memory_order_relaxed); } ])
+  fi
   dnl sun
   AC_CHECKATOMICTYPE([sun], [CXXTOOLS_ATOMICITY_SUN],
       [ #include <sys/atomic.h>
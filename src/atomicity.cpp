@@ -27,7 +27,10 @@
  */
 #include "cxxtools/atomicity.h"
 
-#if defined(CXXTOOLS_ATOMICITY_GCC_ARM)
+#if defined(CXXTOOLS_ATOMICITY_STDCXX)
+    #include "atomicity.stdcxx.cpp"
+
+#elif defined(CXXTOOLS_ATOMICITY_GCC_ARM)
     #include "atomicity.gcc.arm.cpp"
 
 #elif defined(CXXTOOLS_ATOMICITY_GCC_MIPS)
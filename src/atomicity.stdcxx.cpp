@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/atomicity.stdcxx.h>
+#include <atomic>
+
+namespace cxxtools {
+
+
+atomic_t atomicGet(volatile atomic_t& val)
+{
+    return atomicObject(val).load();
+}
+
+
+void atomicSet(volatile atomic_t& val, atomic_t n)
+{
+    atomicObject(val).store(n);
+}
+
+
+atomic_t atomicIncrement(volatile atomic_t& val)
+{
+    return atomicObject(val).fetch_add(1) + 1;
+}
+
+
+atomic_t atomicDecrement(volatile atomic_t& val)
+{
+    return atomicObject(val).fetch_sub(1) - 1;
+}
+
+
+atomic_t atomicExchangeAdd(volatile atomic_t& val, atomic_t add)
+{
+    return atomicObject(val).fetch_add(add);
+}
+
+
+atomic_t atomicCompareExchange(volatile atomic_t& val, atomic_t exch, atomic_t comp)
+{
+    atomicObject(val).compare_exchange_strong(comp, exch);
+    return comp;
+}
+
+
+void* atomicCompareExchange(void* volatile& ptr, void* exch, void* comp)
+{
+    reinterpret_cast<volatile std::atomic<void*>&>(ptr).compare_exchange_strong(comp, exch);
+    return comp;
+}
+
+
+atomic_t atomicExchange(volatile atomic_t& val, atomic_t exch)
+{
+    return atomicObject(val).exchange(exch);
+}
+
+
+void* atomicExchange(void* volatile& dest, void* exch)
+{
+    return reinterpret_cast<volatile std::atomic<void*>&>(dest).exchange(exch);
+}
+
+} // namespace cxxtools
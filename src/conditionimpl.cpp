@@ -33,9 +33,77 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <errno.h>
+#include <limits.h>
 
 namespace cxxtools {
 
+#ifdef CXXTOOLS_HAVE_FUTEX
+
+ConditionImpl::ConditionImpl()
+    : _sequence(0),
+      _waiters(0)
+{
+}
+
+
+ConditionImpl::~ConditionImpl()
+{
+}
+
+
+void ConditionImpl::wait(Mutex& mtx)
+{
+    __atomic_add_fetch(&_waiters, 1, __ATOMIC_SEQ_CST);
+    int sequence = __atomic_load_n(&_sequence, __ATOMIC_SEQ_CST);
+
+    mtx.unlock();
+    futexWait(&_sequence, sequence);
+    __atomic_sub_fetch(&_waiters, 1, __ATOMIC_SEQ_CST);
+    mtx.lock();
+}
+
+
+bool ConditionImpl::wait(Mutex& mtx, const Timespan& ts)
+{
+    if (ts < Timespan(0))
+    {
+        wait(mtx);
+        return true;
+    }
+
+    struct timespec tv;
+    tv.tv_sec = ts.totalUSecs() / 1000000;
+    tv.tv_nsec = (ts.totalUSecs() % 1000000) * 1000;
+
+    __atomic_add_fetch(&_waiters, 1, __ATOMIC_SEQ_CST);
+    int sequence = __atomic_load_n(&_sequence, __ATOMIC_SEQ_CST);
+
+    mtx.unlock();
+    bool ret = futexWait(&_sequence, sequence, &tv);
+    __atomic_sub_fetch(&_waiters, 1, __ATOMIC_SEQ_CST);
+    mtx.lock();
+
+    return ret;
+}
+
+
+void ConditionImpl::signal()
+{
+    __atomic_add_fetch(&_sequence, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) > 0)
+        futexWake(&_sequence, 1);
+}
+
+
+void ConditionImpl::broadcast()
+{
+    __atomic_add_fetch(&_sequence, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) > 0)
+        futexWake(&_sequence, INT_MAX);
+}
+
+#else
+
 ConditionImpl::ConditionImpl()
 {
     int rc = pthread_cond_init( &_cond, NULL );
@@ -103,4 +171,6 @@ void ConditionImpl::broadcast()
         throw SystemError( rc, "pthread_cond_broadcast failed");
 }
 
+#endif
+
 }
@@ -26,6 +26,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "cxxtools/mutex.h"
+#include "futex.h"
 #include <pthread.h>
 
 namespace cxxtools {
@@ -48,7 +49,14 @@ namespace cxxtools {
             void broadcast();
 
         private:
+#ifdef CXXTOOLS_HAVE_FUTEX
+            // incremented on every signal; waiters sleep on the value they
+            // have seen before unlocking the mutex
+            volatile int _sequence;
+            volatile int _waiters;
+#else
             pthread_cond_t _cond;
+#endif
     };
 
 }
@@ -27,39 +27,200 @@
  */
 
 #include <cxxtools/csvformatter.h>
+#include <cxxtools/convert.h>
 #include <cxxtools/log.h>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <stdint.h>
 
 log_define("cxxtools.csv.formatter")
 
 namespace cxxtools
 {
+    namespace
+    {
+        void appendUtf8(std::string& s, const String& value)
+        {
+            for (String::const_iterator it = value.begin(); it != value.end(); ++it)
+            {
+                uint32_t ch = static_cast<uint32_t>(it->value());
+                if (ch < 0x80)
+                    s += static_cast<char>(ch);
+                else if (ch < 0x800)
+                {
+                    s += static_cast<char>(0xc0 | (ch >> 6));
+                    s += static_cast<char>(0x80 | (ch & 0x3f));
+                }
+                else if (ch < 0x10000)
+                {
+                    s += static_cast<char>(0xe0 | (ch >> 12));
+                    s += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+                    s += static_cast<char>(0x80 | (ch & 0x3f));
+                }
+                else if (ch < 0x110000)
+                {
+                    s += static_cast<char>(0xf0 | (ch >> 18));
+                    s += static_cast<char>(0x80 | ((ch >> 12) & 0x3f));
+                    s += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+                    s += static_cast<char>(0x80 | (ch & 0x3f));
+                }
+                else
+                {
+                    // not representable; pass the low byte like the codec does
+                    s += static_cast<char>(ch);
+                }
+            }
+        }
+
+        // Decodes a row for output through a TextOStream. Cells of
+        // std::string values are copied as they are and need not be valid
+        // utf-8, so bytes, which do not form a valid sequence, are passed
+        // as single characters instead of failing.
+        void decodeUtf8(String& s, const std::string& bytes)
+        {
+            s.clear();
+            s.reserve(bytes.size());
+
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes.data());
+            const unsigned char* e = p + bytes.size();
+            while (p < e)
+            {
+                uint32_t ch = *p;
+                unsigned follow = 0;
+                uint32_t min = 0;
+
+                if (ch < 0x80)
+                {
+                    s += Char(ch);
+                    ++p;
+                    continue;
+                }
+                else if (ch >= 0xc2 && ch < 0xe0)
+                {
+                    follow = 1;
+                    ch &= 0x1f;
+                    min = 0x80;
+                }
+                else if (ch >= 0xe0 && ch < 0xf0)
+                {
+                    follow = 2;
+                    ch &= 0x0f;
+                    min = 0x800;
+                }
+                else if (ch >= 0xf0 && ch < 0xf5)
+                {
+                    follow = 3;
+                    ch &= 0x07;
+                    min = 0x10000;
+                }
+
+                bool valid = follow > 0 && static_cast<std::size_t>(e - p) > follow;
+                for (unsigned n = 1; valid && n <= follow; ++n)
+                {
+                    if ((p[n] & 0xc0) != 0x80)
+                        valid = false;
+                    ch = (ch << 6) | (p[n] & 0x3f);
+                }
+
+                if (valid && ch >= min && ch < 0x110000 && (ch < 0xd800 || ch > 0xdfff))
+                {
+                    s += Char(ch);
+                    p += follow + 1;
+                }
+                else
+                {
+                    s += Char(static_cast<uint32_t>(*p));
+                    ++p;
+                }
+            }
+        }
+
+        inline uint64_t hasByte(uint64_t v, uint64_t pattern)
+        {
+            const uint64_t ones = 0x0101010101010101ull;
+            const uint64_t highs = 0x8080808080808080ull;
+            v ^= pattern;
+            return (v - ones) & ~v & highs;
+        }
+
+        // Returns the first occurrence of one of the bytes a, b or c.
+        // 8 bytes are checked at once using a word wide zero byte test.
+        const char* findAny(const char* p, const char* e, char a, char b, char c)
+        {
+            const uint64_t ones = 0x0101010101010101ull;
+            const uint64_t pa = ones * static_cast<unsigned char>(a);
+            const uint64_t pb = ones * static_cast<unsigned char>(b);
+            const uint64_t pc = ones * static_cast<unsigned char>(c);
+
+            for ( ; e - p >= 8; p += 8)
+            {
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                if (hasByte(v, pa) | hasByte(v, pb) | hasByte(v, pc))
+                    break;
+            }
+
+            for ( ; p < e; ++p)
+                if (*p == a || *p == b || *p == c)
+                    return p;
+
+            return e;
+        }
+
+        inline bool startsWith(const char* p, const char* e, const std::string& s)
+        {
+            return !s.empty()
+                && static_cast<std::size_t>(e - p) >= s.size()
+                && std::memcmp(p, s.data(), s.size()) == 0;
+        }
+    }
+
     CsvFormatter::CsvFormatter(std::ostream& os, TextCodec<Char, char>* codec)
-        : _firstline(true),
-          _collectTitles(true),
-          _level(0),
-          _delimiter(L","),
-          _quote('"'),
-          _lineEnding(L"\n"),
-          _ts(new TextOStream(os, codec)),
-          _os(*_ts)
-    { }
+        : _out(0),
+          _ts(0),
+          _os(0)
+    {
+        init();
+
+        if (dynamic_cast<Utf8Codec*>(codec))
+        {
+            _out = &os;
+            if (codec->refs() == 0)
+                delete codec;
+        }
+        else
+        {
+            _ts = new TextOStream(os, codec);
+            _os = _ts;
+        }
+    }
 
     CsvFormatter::CsvFormatter(TextOStream& os)
-        : _firstline(true),
-          _collectTitles(true),
-          _level(0),
-          _delimiter(L","),
-          _quote('"'),
-          _lineEnding(L"\n"),
+        : _out(0),
           _ts(0),
-          _os(os)
-    { }
+          _os(&os)
+    {
+        init();
+    }
 
     CsvFormatter::~CsvFormatter()
     {
         delete _ts;
     }
 
+    void CsvFormatter::init()
+    {
+        _firstline = true;
+        _collectTitles = true;
+        _level = 0;
+        _nextTitle = 0;
+        _columns = 0;
+        delimiter(L",");
+        quote('"');
+        lineEnding(L"\n");
+    }
+
     void CsvFormatter::selectColumn(const std::string& title)
     {
         _titles.resize(_titles.size() + 1);
@@ -76,30 +237,120 @@ namespace cxxtools
         _collectTitles = false;
     }
 
-    void CsvFormatter::toCsvData(String& ret, const std::string& /*type*/, const String& value)
+    std::string* CsvFormatter::cell()
     {
-        if (value.find(Char(_quote)) == String::npos
-                && value.find(_delimiter) == String::npos
-                && value.find(_lineEnding) == String::npos)
+        unsigned n;
+
+        if (_memberName.empty())
         {
-            ret = value;
+            n = _columns;
         }
         else
         {
-            ret.clear();
-            ret += _quote;
-            for (String::const_iterator it = value.begin(); it != value.end(); ++it)
+            // members usually come in the order of the titles, so the
+            // search starts after the last column found
+            unsigned count = _titles.size();
+            n = _nextTitle < count ? _nextTitle : 0;
+            for (unsigned c = 0; c < count && _titles[n]._memberName != _memberName; ++c)
+                n = n + 1 < count ? n + 1 : 0;
+
+            if (count == 0 || _titles[n]._memberName != _memberName)
+                return 0;
+
+            log_debug("column " << n);
+            _nextTitle = n + 1;
+            _memberName.clear();
+        }
+
+        if (_data.size() <= n)
+            _data.resize(n + 1);
+
+        while (_columns <= n)
+            _data[_columns++].clear();
+
+        _data[n].clear();
+        return &_data[n];
+    }
+
+    void CsvFormatter::quoteCell(std::string& data)
+    {
+        const char* p = data.data();
+        const char* e = p + data.size();
+
+        // quote, when the value contains the quote, delimiter or line ending
+        const char q = _quoteBytes[0];
+        const char d = _delimiterBytes.empty() ? q : _delimiterBytes[0];
+        const char l = _lineEndingBytes.empty() ? q : _lineEndingBytes[0];
+
+        while ((p = findAny(p, e, q, d, l)) != e)
+        {
+            if (startsWith(p, e, _quoteBytes)
+                || startsWith(p, e, _delimiterBytes)
+                || startsWith(p, e, _lineEndingBytes))
+                break;
+            ++p;
+        }
+
+        if (p == e)
+            return;
+
+        _tmp.clear();
+        _tmp += _quoteBytes;
+
+        for (p = data.data(); p < e; )
+        {
+            const char* f = findAny(p, e, q, q, q);
+            _tmp.append(p, f);
+            if (f == e)
+                break;
+
+            if (startsWith(f, e, _quoteBytes))
             {
-                if (*it == _quote)
-                {
-                    ret += _quote;
-                    ret += _quote;
-                }
-                else
-                    ret += *it;
+                _tmp += _quoteBytes;
+                _tmp += _quoteBytes;
+                p = f + _quoteBytes.size();
+            }
+            else
+            {
+                _tmp += *f;
+                p = f + 1;
             }
-            ret += _quote;
         }
+
+        _tmp += _quoteBytes;
+        data.swap(_tmp);
+    }
+
+    void CsvFormatter::rowOut()
+    {
+        if (_out)
+        {
+            std::streamsize n = _out->rdbuf()->sputn(_row.data(), _row.size());
+            if (n != static_cast<std::streamsize>(_row.size()))
+                _out->setstate(std::ios::badbit);
+        }
+        else
+        {
+            String row;
+            decodeUtf8(row, _row);
+            *_os << row;
+        }
+    }
+
+    void CsvFormatter::titlesOut()
+    {
+        log_debug("print " << _titles.size() << " titles");
+
+        _row.clear();
+        for (unsigned n = 0; n < _titles.size(); ++n)
+        {
+            if (n > 0)
+                _row += _delimiterBytes;
+            _row += _titles[n]._title;
+        }
+
+        _row += _lineEndingBytes;
+        rowOut();
     }
 
     void CsvFormatter::dataOut()
@@ -107,61 +358,135 @@ namespace cxxtools
         if (_firstline)
         {
             if (!_titles.empty())
-            {
-                log_debug("print " << _titles.size() << " titles");
-                for (unsigned n = 0; n < _titles.size(); ++n)
-                {
-                    if (n > 0)
-                        _os << _delimiter;
-                    _os << String(_titles[n]._title);
-                }
-
-                _os << _lineEnding;
-            }
+                titlesOut();
 
             _firstline = false;
             _collectTitles = false;
         }
 
-        log_debug("output " << _data.size() << " columns");
-        for (unsigned n = 0; n < _data.size(); ++n)
+        log_debug("output " << _columns << " columns");
+
+        _row.clear();
+        for (unsigned n = 0; n < _columns; ++n)
         {
             if (n > 0)
-                _os << _delimiter;
-            _os << _data[n];
+                _row += _delimiterBytes;
+            _row += _data[n];
         }
-        _os << _lineEnding;
+        _row += _lineEndingBytes;
+
+        rowOut();
 
-        _data.clear();
+        _columns = 0;
+        _nextTitle = 0;
     }
 
-    void CsvFormatter::addValueString(const std::string& /*name*/, const std::string& type,
+    void CsvFormatter::addValueString(const std::string& /*name*/, const std::string& /*type*/,
                           const String& value)
     {
-        if (_memberName.empty())
+        std::string* c = cell();
+        if (c)
         {
-            log_debug("addValue plain value \"" << value << '"');
-            _data.push_back(String());
-            toCsvData(_data.back(), type, value);
+            appendUtf8(*c, value);
+            quoteCell(*c);
         }
-        else
+    }
+
+    void CsvFormatter::addValueStdString(const std::string& /*name*/, const std::string& /*type*/,
+                          const std::string& value)
+    {
+        // bytes are passed unchanged like the utf-8 codec does with
+        // characters widened from std::string
+        std::string* c = cell();
+        if (c)
         {
-            log_debug("addValue member \"" << _memberName << "\" value \"" << value << '"');
-            for (unsigned n = 0; n < _titles.size(); ++n)
-            {
-                if (_titles[n]._memberName == _memberName)
-                {
-                    log_debug("column " << n);
-                    if (_data.size() <= n)
-                        _data.resize(n + 1);
-                    toCsvData(_data[n], type, value);
-                    _memberName.clear();
-                    break;
-                }
-            }
+            *c = value;
+            quoteCell(*c);
         }
     }
 
+    void CsvFormatter::addValueChar(const std::string& /*name*/, const std::string& /*type*/,
+                          char value)
+    {
+        std::string* c = cell();
+        if (c)
+        {
+            *c += value;
+            quoteCell(*c);
+        }
+    }
+
+    void CsvFormatter::addValueBool(const std::string& /*name*/, const std::string& /*type*/,
+                          bool value)
+    {
+        std::string* c = cell();
+        if (c)
+        {
+            *c = value ? "true" : "false";
+            quoteCell(*c);
+        }
+    }
+
+    void CsvFormatter::addValueInt(const std::string& /*name*/, const std::string& /*type*/,
+                          int_type value)
+    {
+        std::string* c = cell();
+        if (c)
+        {
+            putInt(std::back_inserter(*c), value);
+            quoteCell(*c);
+        }
+    }
+
+    void CsvFormatter::addValueUnsigned(const std::string& /*name*/, const std::string& /*type*/,
+                          unsigned_type value)
+    {
+        std::string* c = cell();
+        if (c)
+        {
+            putInt(std::back_inserter(*c), value);
+            quoteCell(*c);
+        }
+    }
+
+    void CsvFormatter::addValueFloat(const std::string& /*name*/, const std::string& /*type*/,
+                          float value)
+    {
+        std::string* c = cell();
+        if (c)
+        {
+            putFloat(std::back_inserter(*c), value);
+            quoteCell(*c);
+        }
+    }
+
+    void CsvFormatter::addValueDouble(const std::string& /*name*/, const std::string& /*type*/,
+                          double value)
+    {
+        std::string* c = cell();
+        if (c)
+        {
+            putFloat(std::back_inserter(*c), value);
+            quoteCell(*c);
+        }
+    }
+
+    void CsvFormatter::addValueLongDouble(const std::string& /*name*/, const std::string& /*type*/,
+                          long double value)
+    {
+        std::string* c = cell();
+        if (c)
+        {
+            putFloat(std::back_inserter(*c), value);
+            quoteCell(*c);
+        }
+    }
+
+    void CsvFormatter::addNull(const std::string& /*name*/, const std::string& /*type*/)
+    {
+        cell();
+    }
+
     void CsvFormatter::beginArray(const std::string& /*name*/, const std::string& /*type*/)
     {
         ++_level;
@@ -219,18 +544,11 @@ namespace cxxtools
         log_debug("finish");
 
         if (_firstline && !_titles.empty())
-        {
-            log_debug("print " << _titles.size() << " titles");
-            for (unsigned n = 0; n < _titles.size(); ++n)
-            {
-                if (n > 0)
-                    _os << _delimiter;
-                _os << String(_titles[n]._title);
-            }
+            titlesOut();
 
-            _os << _lineEnding;
-        }
-
-        _os.flush();
+        if (_out)
+            _out->flush();
+        else
+            _os->flush();
     }
 }
@@ -0,0 +1,442 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/csvparallelreader.h>
+#include <cxxtools/serializationerror.h>
+#include <cxxtools/threadpool.h>
+#include <cxxtools/method.h>
+#include <cxxtools/log.h>
+
+#include <deque>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#if __cplusplus >= 201103L
+#include <exception>
+#endif
+
+log_define("cxxtools.csv.parallelreader")
+
+namespace cxxtools
+{
+
+namespace
+{
+    // returns the start of the first line at or after pos
+    const char* lineStart(const char* pos, const char* end)
+    {
+        for (const char* p = pos - 1; p < end; ++p)
+        {
+            if (*p == '\n')
+                return p + 1;
+
+            if (*p == '\r')
+                return p + 1 < end && p[1] == '\n' ? p + 2 : p + 1;
+        }
+
+        return end;
+    }
+
+    unsigned processors()
+    {
+        long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+        return n > 0 ? static_cast<unsigned>(n) : 1;
+    }
+
+    // Keeps an exception caught in a worker thread, so that it can be
+    // rethrown in the reading thread. Without C++11 only the message is
+    // kept and a std::runtime_error is thrown.
+    class ChunkError
+    {
+#if __cplusplus >= 201103L
+            std::exception_ptr _ptr;
+
+        public:
+            /// must be called in a catch block
+            void capture()
+            { _ptr = std::current_exception(); }
+
+            bool empty() const
+            { return !_ptr; }
+
+            void clear()
+            { _ptr = std::exception_ptr(); }
+
+            void rethrow() const
+            { std::rethrow_exception(_ptr); }
+#else
+            bool _set;
+            std::string _msg;
+
+        public:
+            ChunkError()
+                : _set(false)
+            { }
+
+            /// must be called in a catch block
+            void capture()
+            {
+                _set = true;
+                try
+                {
+                    throw;
+                }
+                catch (const std::exception& e)
+                {
+                    _msg = e.what();
+                }
+                catch (...)
+                {
+                    _msg = "unknown exception in csv row callback";
+                }
+            }
+
+            bool empty() const
+            { return !_set; }
+
+            void clear()
+            {
+                _set = false;
+                _msg.clear();
+            }
+
+            void rethrow() const
+            { throw std::runtime_error(_msg); }
+#endif
+    };
+}
+
+struct CsvParallelReader::Chunk
+{
+    const CsvParallelReader* reader;
+    const Callable<void, const CsvReader&>* cb;
+
+    const char* start;   // nominal start of the chunk
+    const char* begin;   // start of the first row; 0 until the chunk is scanned
+    const char* limit;   // rows starting before limit belong to the chunk
+    const char* end;     // start of the first row after the chunk
+
+    std::vector<CsvReader::Field> fields;
+    std::vector<unsigned> rows;   // number of fields of each row
+    std::vector<unsigned> lines;  // line of the end of each row relative to lineNo
+    bool bad;                     // the row after the last row has the wrong number of columns
+    unsigned badColumns;
+    unsigned badLine;
+    unsigned long lineNo;         // line number before the first row
+
+    unsigned lineCount() const
+    { return lines.empty() ? 0 : lines.back(); }
+
+    ChunkError error;
+    ThreadPool::Future future;
+
+    void scan()
+    {
+        try
+        {
+            reader->scanChunk(*this);
+        }
+        catch (...)
+        {
+            error.capture();
+        }
+    }
+
+    void deliver()
+    {
+        try
+        {
+            reader->deliverChunk(*this);
+        }
+        catch (...)
+        {
+            error.capture();
+        }
+    }
+};
+
+CsvParallelReader::CsvParallelReader()
+    : _threads(processors()),
+      _chunkSize(4 * 1024 * 1024),
+      _ordered(true),
+      _misspeculations(0)
+{ }
+
+CsvParallelReader::CsvParallelReader(const char* data, std::size_t size)
+    : _reader(data, size),
+      _threads(processors()),
+      _chunkSize(4 * 1024 * 1024),
+      _ordered(true),
+      _misspeculations(0)
+{ }
+
+void CsvParallelReader::open(const std::string& fileName)
+{
+    _reader.open(fileName);
+}
+
+void CsvParallelReader::close()
+{
+    _reader.close();
+}
+
+void CsvParallelReader::scanChunk(Chunk& chunk) const
+{
+    const char* dataEnd = _reader._end;
+
+    if (chunk.begin == 0)
+        chunk.begin = lineStart(chunk.start, dataEnd);
+
+    chunk.fields.clear();
+    chunk.rows.clear();
+    chunk.lines.clear();
+    chunk.bad = false;
+
+    CsvReader r(chunk.begin, dataEnd - chunk.begin);
+    r._delimiter = _reader._delimiter;
+
+    const bool check = _reader._readTitle;
+    const unsigned columns = _reader._titles.size();
+
+    while (r._pos < chunk.limit && r.scanRow() == CsvReader::scan_row)
+    {
+        if (check && r._fields.size() != columns)
+        {
+            chunk.bad = true;
+            chunk.badColumns = r._fields.size();
+            chunk.badLine = r._lineNo;
+            break;
+        }
+
+        chunk.fields.insert(chunk.fields.end(), r._fields.begin(), r._fields.end());
+        chunk.rows.push_back(r._fields.size());
+        chunk.lines.push_back(r._lineNo);
+    }
+
+    chunk.end = r._pos;
+}
+
+void CsvParallelReader::deliverChunk(Chunk& chunk) const
+{
+    CsvReader r;
+    r._delimiter = _reader._delimiter;
+    r._readTitle = _reader._readTitle;
+    r._started = true;
+    r._titles = _reader._titles;
+
+    std::vector<CsvReader::Field>::const_iterator f = chunk.fields.begin();
+    for (unsigned n = 0; n < chunk.rows.size(); ++n)
+    {
+        r._fields.assign(f, f + chunk.rows[n]);
+        f += chunk.rows[n];
+        r._lineNo = chunk.lineNo + chunk.lines[n];
+        chunk.cb->call(r);
+    }
+}
+
+void CsvParallelReader::checkChunk(const Chunk& chunk) const
+{
+    if (!chunk.bad)
+        return;
+
+    std::ostringstream msg;
+    msg << "number of columns " << chunk.badColumns << " in line " << (chunk.lineNo + chunk.badLine) << " does not match expected number of columns " << _reader._titles.size() << " in csv";
+    SerializationError::doThrow(msg.str());
+}
+
+unsigned long CsvParallelReader::readSequential(const Callable<void, const CsvReader&>& cb)
+{
+    unsigned long count = 0;
+    while (_reader.next())
+    {
+        cb.call(_reader);
+        ++count;
+    }
+
+    return count;
+}
+
+unsigned long CsvParallelReader::read(const Callable<void, const CsvReader&>& cb)
+{
+    _misspeculations = 0;
+
+    // streams (files, which could not be mapped) are read sequentially
+    if (_threads <= 1 || _reader._in != 0 || _reader._started)
+        return readSequential(cb);
+
+    _reader._started = true;
+    if (_reader._readTitle)
+        _reader.readTitles();
+    else if (_reader._delimiter == '\0')
+        throw std::logic_error("can't read csv data with auto delimiter but without title");
+
+    const char* const begin = _reader._pos;
+    const char* const end = _reader._end;
+    const std::size_t chunkSize = _chunkSize > 0 ? _chunkSize : 1;
+    const unsigned window = 2 * _threads;
+
+    log_debug("parse " << (end - begin) << " bytes in chunks of " << chunkSize << " bytes with " << _threads << " threads");
+
+    unsigned long lineNo = _reader._lineNo;
+    unsigned long count = 0;
+
+    const char* next = begin;    // nominal start of the next chunk
+    const char* valid = begin;   // start of the next row after the validated chunks
+
+    std::deque<Chunk*> scanning;
+    std::deque<Chunk*> delivering;
+    std::vector<Chunk*> spare;
+    Chunk* current = 0;
+
+    ThreadPool pool(_threads);
+
+    try
+    {
+        while (true)
+        {
+            while (scanning.size() + delivering.size() < window && next < end)
+            {
+                Chunk* chunk;
+                if (spare.empty())
+                {
+                    chunk = new Chunk();
+                }
+                else
+                {
+                    chunk = spare.back();
+                    spare.pop_back();
+                }
+
+                scanning.push_back(chunk);
+
+                chunk->reader = this;
+                chunk->cb = &cb;
+                chunk->start = next;
+                chunk->begin = next == begin ? begin : 0;
+                chunk->limit = static_cast<std::size_t>(end - next) > chunkSize ? next + chunkSize : end;
+                chunk->error.clear();
+                chunk->future = pool.schedule(callable(*chunk, &Chunk::scan));
+
+                next = chunk->limit;
+            }
+
+            // release finished chunks; wait for one, when nothing else is to do
+            while (!delivering.empty() && (scanning.empty() || delivering.front()->future.isFinished()))
+            {
+                current = delivering.front();
+                delivering.pop_front();
+                current->future.wait();
+                if (!current->error.empty())
+                    current->error.rethrow();
+                spare.push_back(current);
+                current = 0;
+
+                if (scanning.empty())
+                    break;
+            }
+
+            if (scanning.empty())
+            {
+                if (delivering.empty())
+                    break;
+                continue;
+            }
+
+            current = scanning.front();
+            scanning.pop_front();
+            current->future.wait();
+            if (!current->error.empty())
+                current->error.rethrow();
+
+            if (current->begin != valid)
+            {
+                // the chunk was split inside of a quoted field or a row
+                // of the previous chunk reaches into it
+                log_debug("chunk at offset " << (current->start - begin) << " misspeculated");
+                ++_misspeculations;
+                current->begin = valid;
+                scanChunk(*current);
+            }
+
+            valid = current->end;
+            current->lineNo = lineNo;
+            lineNo += current->lineCount();
+            count += current->rows.size();
+
+            if (_ordered || current->bad)
+            {
+                deliverChunk(*current);
+
+                if (current->bad)
+                {
+                    while (!delivering.empty())
+                    {
+                        delivering.front()->future.wait();
+                        spare.push_back(delivering.front());
+                        delivering.pop_front();
+                    }
+
+                    checkChunk(*current);
+                }
+
+                spare.push_back(current);
+            }
+            else
+            {
+                delivering.push_back(current);
+                current->future = pool.schedule(callable(*current, &Chunk::deliver));
+            }
+
+            current = 0;
+        }
+    }
+    catch (...)
+    {
+        pool.stop(true);
+
+        delete current;
+        for (unsigned n = 0; n < scanning.size(); ++n)
+            delete scanning[n];
+        for (unsigned n = 0; n < delivering.size(); ++n)
+            delete delivering[n];
+        for (unsigned n = 0; n < spare.size(); ++n)
+            delete spare[n];
+
+        throw;
+    }
+
+    for (unsigned n = 0; n < spare.size(); ++n)
+        delete spare[n];
+
+    _reader._pos = end;
+
+    return count;
+}
+
+}
@@ -0,0 +1,510 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/csvreader.h>
+#include <cxxtools/serializationerror.h>
+#include <cxxtools/ioerror.h>
+#include <cxxtools/utf8codec.h>
+#include <cxxtools/log.h>
+#include "error.h"
+
+#include <cstring>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+log_define("cxxtools.csv.reader")
+
+namespace cxxtools
+{
+
+namespace
+{
+    const std::size_t bufferSize = 65536;
+
+    bool isTitleChar(char ch)
+    {
+        return (ch >= 'a' && ch <= 'z')
+            || (ch >= 'A' && ch <= 'Z')
+            || (ch >= '0' && ch <= '9')
+            || ch == '_' || ch == ' ';
+    }
+
+    // counts the line feeds, which are part of quoted fields
+    unsigned countLines(const char* p, const char* e)
+    {
+        unsigned n = 0;
+        while ((p = static_cast<const char*>(std::memchr(p, '\n', e - p))) != 0)
+        {
+            ++n;
+            ++p;
+        }
+
+        return n;
+    }
+
+    bool isAscii(const char* data, std::size_t size)
+    {
+        for (std::size_t n = 0; n < size; ++n)
+            if (static_cast<unsigned char>(data[n]) >= 0x80)
+                return false;
+        return true;
+    }
+}
+
+const Char CsvReader::autoDelimiter = L'\0';
+
+void CsvReader::Field::get(std::string& value) const
+{
+    if (!_escaped)
+    {
+        value.assign(_data, _size);
+        return;
+    }
+
+    // doubled quotes stand for a single quote character
+    value.clear();
+    value.reserve(_size);
+    for (std::size_t n = 0; n < _size; ++n)
+    {
+        value += _data[n];
+        if (_data[n] == _quote)
+            ++n;
+    }
+}
+
+String CsvReader::Field::ustr() const
+{
+    if (!_escaped)
+        return Utf8Codec::decode(_data, _size);
+
+    return Utf8Codec::decode(str());
+}
+
+CsvReader::CsvReader()
+    : _in(0),
+      _map(0),
+      _mapSize(0),
+      _delimiter('\0'),
+      _readTitle(true)
+{
+    init();
+}
+
+CsvReader::CsvReader(std::istream& in)
+    : _in(&in),
+      _map(0),
+      _mapSize(0),
+      _delimiter('\0'),
+      _readTitle(true)
+{
+    init();
+    _eof = false;
+}
+
+CsvReader::CsvReader(const char* data, std::size_t size)
+    : _in(0),
+      _map(0),
+      _mapSize(0),
+      _delimiter('\0'),
+      _readTitle(true)
+{
+    init();
+    _pos = data;
+    _end = data + size;
+}
+
+CsvReader::~CsvReader()
+{
+    close();
+}
+
+void CsvReader::init()
+{
+    _pos = _end = 0;
+    _eof = true;
+    _started = false;
+    _lineNo = 0;
+    _titles.clear();
+    _fields.clear();
+}
+
+void CsvReader::open(const std::string& fileName)
+{
+    close();
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw AccessFailed(getErrnoString("open") + ": " + fileName);
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void* p = ::mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            ::close(fd);
+
+            ::madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+            _map = p;
+            _mapSize = st.st_size;
+            _pos = static_cast<const char*>(p);
+            _end = _pos + _mapSize;
+
+            log_debug("file " << fileName << " with " << _mapSize << " bytes mapped");
+            return;
+        }
+
+        log_debug("mmap of " << fileName << " failed; errno=" << errno);
+    }
+
+    ::close(fd);
+
+    // no regular file or mapping not possible; read it as a stream
+    _file.open(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!_file)
+        throw AccessFailed("failed to open " + fileName);
+
+    _in = &_file;
+    _eof = false;
+}
+
+void CsvReader::close()
+{
+    if (_map)
+    {
+        ::munmap(_map, _mapSize);
+        _map = 0;
+        _mapSize = 0;
+    }
+
+    if (_file.is_open())
+        _file.close();
+
+    _file.clear();
+    _in = 0;
+    init();
+}
+
+void CsvReader::delimiter(Char ch)
+{
+    if (ch.value() >= 0x80)
+        throw std::logic_error("only ascii characters are supported as csv delimiter");
+
+    _delimiter = static_cast<char>(ch.value());
+}
+
+bool CsvReader::fill()
+{
+    if (_eof)
+        return false;
+
+    // move the unprocessed rest of the data to the start of the buffer
+    std::size_t rest = _end - _pos;
+    if (rest > 0 && _pos != &_buffer[0])
+        std::memmove(&_buffer[0], _pos, rest);
+
+    // a row, which does not fit into the buffer, lets it grow
+    if (_buffer.size() < bufferSize)
+        _buffer.resize(bufferSize);
+    else if (rest >= _buffer.size() / 2)
+        _buffer.resize(_buffer.size() * 2);
+
+    std::streamsize n = _in->rdbuf()->sgetn(&_buffer[rest], _buffer.size() - rest);
+    if (n <= 0)
+    {
+        _eof = true;
+        n = 0;
+    }
+
+    _pos = &_buffer[0];
+    _end = _pos + rest + n;
+
+    return n > 0;
+}
+
+CsvReader::ScanResult CsvReader::scanRow()
+{
+    const char* p = _pos;
+    const char* e = _end;
+    const char delimiter = _delimiter;
+    unsigned lines = 1;
+
+    _fields.clear();
+
+    if (p == e)
+        return _eof ? scan_end : scan_more;
+
+    while (true)
+    {
+        Field field;
+        const char* start = p;
+
+        if (*p == '"' || *p == '\'')
+        {
+            const char quote = *p;
+            const char* q = p + 1;
+            bool escaped = false;
+
+            while (true)
+            {
+                q = static_cast<const char*>(std::memchr(q, quote, e - q));
+                if (q == 0)
+                {
+                    if (!_eof)
+                        return scan_more;
+
+                    // unterminated quote; the rest is the value including the quote
+                    q = e;
+                    break;
+                }
+
+                if (q + 1 == e && !_eof)
+                    return scan_more;  // may be a doubled quote
+
+                if (q + 1 < e && q[1] == quote)
+                {
+                    escaped = true;
+                    q += 2;
+                    continue;
+                }
+
+                break;
+            }
+
+            lines += countLines(start + 1, q);
+
+            if (q == e)
+            {
+                field._data = start;
+                field._size = e - start;
+                p = e;
+            }
+            else if (q + 1 == e || q[1] == delimiter || q[1] == '\n' || q[1] == '\r')
+            {
+                field._data = start + 1;
+                field._size = q - start - 1;
+                field._quote = quote;
+                field._escaped = escaped;
+                p = q + 1;
+            }
+            else
+            {
+                // text after the closing quote; take the field as it is
+                p = q + 1;
+                while (p < e && *p != delimiter && *p != '\n' && *p != '\r')
+                    ++p;
+
+                if (p == e && !_eof)
+                    return scan_more;
+
+                field._data = start;
+                field._size = p - start;
+            }
+        }
+        else
+        {
+            while (p < e && *p != delimiter && *p != '\n' && *p != '\r')
+                ++p;
+
+            if (p == e && !_eof)
+                return scan_more;
+
+            field._data = start;
+            field._size = p - start;
+        }
+
+        _fields.push_back(field);
+
+        if (p == e)
+            break;
+
+        if (*p == delimiter)
+        {
+            ++p;
+            if (p < e)
+                continue;
+
+            if (!_eof)
+                return scan_more;
+
+            // the row ends with a delimiter and an empty field
+            Field empty;
+            empty._data = p;
+            _fields.push_back(empty);
+            break;
+        }
+
+        // end of line
+        if (*p == '\r')
+        {
+            if (p + 1 == e && !_eof)
+                return scan_more;
+
+            if (p + 1 < e && p[1] == '\n')
+                ++p;
+        }
+
+        ++p;
+        break;
+    }
+
+    _pos = p;
+    _lineNo += lines;
+
+    return scan_row;
+}
+
+void CsvReader::readTitles()
+{
+    if (_delimiter == '\0')
+    {
+        // detect the delimiter from the first character of the title
+        // line, which is not part of a title
+        while (true)
+        {
+            const char* p = _pos;
+            while (p < _end)
+            {
+                if (*p == '"' || *p == '\'')
+                {
+                    const char* q = static_cast<const char*>(std::memchr(p + 1, *p, _end - p - 1));
+                    if (q == 0)
+                    {
+                        p = _end;
+                        break;
+                    }
+                    p = q + 1;
+                }
+                else if (isTitleChar(*p))
+                    ++p;
+                else
+                    break;
+            }
+
+            if (p < _end || !fill())
+            {
+                if (p < _end && *p != '\n' && *p != '\r')
+                    _delimiter = *p;
+                break;
+            }
+        }
+
+        log_debug("delimiter=" << _delimiter);
+    }
+
+    ScanResult r;
+    while ((r = scanRow()) == scan_more)
+        fill();
+
+    if (r == scan_end)
+        return;
+
+    _titles.resize(_fields.size());
+    for (unsigned n = 0; n < _fields.size(); ++n)
+    {
+        _fields[n].get(_titles[n]);
+        log_debug("title=\"" << _titles[n] << '"');
+    }
+}
+
+bool CsvReader::next()
+{
+    if (!_started)
+    {
+        _started = true;
+
+        if (_readTitle)
+            readTitles();
+        else if (_delimiter == '\0')
+            throw std::logic_error("can't read csv data with auto delimiter but without title");
+    }
+
+    ScanResult r;
+    while ((r = scanRow()) == scan_more)
+        fill();
+
+    if (r == scan_end)
+    {
+        _fields.clear();
+        return false;
+    }
+
+    if (_readTitle && _fields.size() != _titles.size())
+    {
+        std::ostringstream msg;
+        msg << "number of columns " << _fields.size() << " in line " << _lineNo << " does not match expected number of columns " << _titles.size() << " in csv";
+        SerializationError::doThrow(msg.str());
+    }
+
+    return true;
+}
+
+const CsvReader::Field& CsvReader::field(const std::string& title) const
+{
+    for (unsigned n = 0; n < _titles.size() && n < _fields.size(); ++n)
+        if (_titles[n] == title)
+            return _fields[n];
+
+    SerializationError::doThrow("csv column \"" + title + "\" not found");
+    return _fields[0];  // never reached
+}
+
+void CsvReader::get(SerializationInfo& si) const
+{
+    si.clear();
+    si.setCategory(SerializationInfo::Array);
+
+    std::string value;
+    for (unsigned n = 0; n < _fields.size(); ++n)
+    {
+        const Field& f = _fields[n];
+        SerializationInfo& m = si.addMember(n < _titles.size() ? _titles[n] : std::string());
+
+        // pure ascii needs no decoding
+        if (isAscii(f.data(), f.size()))
+        {
+            f.get(value);
+            m.setValue(value);
+        }
+        else
+        {
+            m.setValue(f.ustr());
+        }
+    }
+}
+
+}
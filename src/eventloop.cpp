@@ -28,9 +28,10 @@
  */
 #include "selectorimpl.h"
 #include "cxxtools/eventloop.h"
-#include "cxxtools/mutex.h"
+#include "cxxtools/atomicity.h"
+#include "cxxtools/membar.h"
 #include "cxxtools/log.h"
-#include <deque>
+#include <vector>
 
 log_define("cxxtools.eventloop")
 
@@ -38,16 +39,213 @@ namespace cxxtools
 {
 namespace
 {
-    struct EvPtr
+    /// Queue entry; small events are copied into the node itself.
+    struct EventNode
     {
-        Event* ev;
-        explicit EvPtr(Event* ev_)
-            : ev(ev_)
+        EventNode* volatile next;
+        Event* event;
+        bool inplace;
+        unsigned index;
+
+        enum { StorageSize = 64 };
+
+        union
+        {
+            void* ptr;
+            double d;
+            long double ld;
+            long l;
+            char data[StorageSize];
+        } storage;
+
+        EventNode()
+            : next(0),
+              event(0),
+              inplace(false),
+              index(0)
         { }
 
-        ~EvPtr()
-        { if (ev) ev->destroy(); }
+        void setEvent(const Event& ev)
+        {
+            event = ev.cloneTo(storage.data, StorageSize);
+            inplace = event != 0;
+            if (!inplace)
+                event = ev.clone();
+        }
+
+        void releaseEvent()
+        {
+            if (inplace)
+                event->~Event();
+            else if (event)
+                event->destroy();
+            event = 0;
+        }
+    };
+
+    /** Nodes for events of one loop.
+
+        The free nodes form a stack of indexes, which is accessed lock free.
+        The upper bits of the head are a tag to avoid the ABA problem. When
+        all nodes are in use, nodes are allocated on the heap.
+     */
+    class EventNodePool
+    {
+        enum {
+            PoolSize = 256,
+            IndexBits = 16,
+            Nil = (1 << IndexBits) - 1,
+            Heap = Nil
+        };
+
+        std::vector<EventNode> _nodes;
+        std::vector<atomic_t> _next;
+        volatile atomic_t _free;
+
+        static atomic_t nextHead(atomic_t head, atomic_t index)
+        {
+            static const atomic_t tagMask = (static_cast<atomic_t>(1) << (sizeof(atomic_t) * 8 - IndexBits - 1)) - 1;
+            atomic_t tag = ((head >> IndexBits) + 1) & tagMask;
+            return (tag << IndexBits) | index;
+        }
+
+        void push(atomic_t index)
+        {
+            atomic_t head = atomicGet(_free);
+            while (true)
+            {
+                _next[index] = head & Nil;
+                atomic_t h = atomicCompareExchange(_free, nextHead(head, index), head);
+                if (h == head)
+                    return;
+                head = h;
+            }
+        }
 
+    public:
+        EventNodePool()
+            : _nodes(PoolSize),
+              _next(PoolSize),
+              _free(Nil)
+        {
+            for (atomic_t n = PoolSize; n > 0; --n)
+            {
+                _nodes[n - 1].index = n - 1;
+                push(n - 1);
+            }
+        }
+
+        EventNode* get()
+        {
+            atomic_t head = atomicGet(_free);
+            while (true)
+            {
+                atomic_t index = head & Nil;
+                if (index == Nil)
+                {
+                    EventNode* node = new EventNode();
+                    node->index = Heap;
+                    return node;
+                }
+
+                atomic_t h = atomicCompareExchange(_free, nextHead(head, _next[index]), head);
+                if (h == head)
+                {
+                    EventNode* node = &_nodes[index];
+                    node->next = 0;
+                    return node;
+                }
+
+                head = h;
+            }
+        }
+
+        void put(EventNode* node)
+        {
+            node->releaseEvent();
+            if (node->index == Heap)
+                delete node;
+            else
+                push(node->index);
+        }
+    };
+
+    /** Intrusive multi producer single consumer queue of events.
+
+        Producers link nodes with a single atomic exchange of the head. The
+        consumer follows the next pointers from the tail. A stub node keeps
+        the queue non empty, so that producers never touch the tail.
+     */
+    class EventQueue
+    {
+        EventNode* volatile _head;
+        EventNode* _tail;
+        EventNode _stub;
+
+        void link(EventNode* node)
+        {
+            node->next = 0;
+            void* volatile& head = reinterpret_cast<void* volatile&>(_head);
+            EventNode* prev = static_cast<EventNode*>(atomicExchange(head, node));
+            prev->next = node;
+        }
+
+    public:
+        EventQueue()
+            : _head(&_stub),
+              _tail(&_stub)
+        { }
+
+        // may be called by any thread
+        void push(EventNode* node)
+        {
+            link(node);
+        }
+
+        // consumer only; returns 0 when no complete node is available
+        EventNode* pop()
+        {
+            EventNode* tail = _tail;
+            EventNode* next = tail->next;
+
+            if (tail == &_stub)
+            {
+                if (next == 0)
+                    return 0;
+                membar_read();
+                _tail = next;
+                tail = next;
+                next = next->next;
+            }
+
+            if (next)
+            {
+                membar_read();
+                _tail = next;
+                return tail;
+            }
+
+            if (tail != _head)
+                return 0;  // a producer is just linking a node
+
+            link(&_stub);
+
+            next = tail->next;
+            if (next)
+            {
+                membar_read();
+                _tail = next;
+                return tail;
+            }
+
+            return 0;
+        }
+
+        // consumer only; a node, which is being linked, counts as content
+        bool empty()
+        {
+            return _tail == &_stub && _head == &_stub;
+        }
     };
 }
 
@@ -55,38 +253,55 @@ class EventLoop::Impl
 {
 public:
     Impl()
-        : _exitLoop(false),
+        : _exitLoop(0),
+          _wakePending(0),
           _selector(new SelectorImpl()),
           _eventsPerLoop(16)
         { }
     ~Impl();
 
     bool eventQueueEmpty()
-    { return _eventQueue.empty() && _priorityEventQueue.empty() && _activeEventQueue.empty(); }
+    { return _priorityEventQueue.empty() && _eventQueue.empty(); }
 
-    Event* front()
+    // consumer only
+    EventNode* pop()
     {
-        if (_priorityEventQueue.empty())
-            return _eventQueue.front();
-        else
-            return _priorityEventQueue.front();
+        EventNode* node = _priorityEventQueue.pop();
+        return node ? node : _eventQueue.pop();
     }
 
-    void pop_front()
+    void queueEvent(const Event& ev, bool priority)
     {
-        if (_priorityEventQueue.empty())
-            _eventQueue.pop_front();
+        EventNode* node = _pool.get();
+        try
+        {
+            node->setEvent(ev);
+        }
+        catch (...)
+        {
+            _pool.put(node);
+            throw;
+        }
+
+        if (priority)
+            _priorityEventQueue.push(node);
         else
-            _priorityEventQueue.pop_front();
+            _eventQueue.push(node);
     }
 
-    bool _exitLoop;
+    // wakes the selector unless a wakeup is already pending
+    void wake()
+    {
+        if (atomicExchange(_wakePending, 1) == 0)
+            _selector->wake();
+    }
+
+    volatile atomic_t _exitLoop;
+    volatile atomic_t _wakePending;
     SelectorImpl* _selector;
-    std::deque<Event*> _eventQueue;
-    std::deque<Event*> _priorityEventQueue;
-    std::deque<Event*> _activeEventQueue;
-    bool _activeEventQueueIsPriority;
-    Mutex _queueMutex;
+    EventNodePool _pool;
+    EventQueue _eventQueue;
+    EventQueue _priorityEventQueue;
     unsigned _eventsPerLoop;
 };
 
@@ -94,28 +309,9 @@ EventLoop::Impl::~Impl()
 {
     try
     {
-        while ( ! _eventQueue.empty() )
-        {
-            Event* ev = _eventQueue.front();
-            _eventQueue.pop_front();
-            ev->destroy();
-        }
-
-        while ( ! _priorityEventQueue.empty() )
-        {
-            Event* ev = _priorityEventQueue.front();
-            _priorityEventQueue.pop_front();
-            ev->destroy();
-        }
-
-        while ( ! _activeEventQueue.empty() )
-        {
-            Event* ev = _activeEventQueue.front();
-            _activeEventQueue.pop_front();
-            if (ev)
-                ev->destroy();
-        }
-
+        EventNode* node;
+        while ((node = pop()) != 0)
+            _pool.put(node);
     }
     catch(...)
     {}
@@ -144,6 +340,16 @@ void EventLoop::eventsPerLoop(unsigned n)
     _impl->_eventsPerLoop = n;
 }
 
+bool EventLoop::useIoUring(bool sw)
+{
+    return _impl->_selector->useIoUring(sw);
+}
+
+bool EventLoop::usesIoUring() const
+{
+    return _impl->_selector->usesIoUring();
+}
+
 
 void EventLoop::onAdd( Selectable& s )
 {
@@ -174,24 +380,21 @@ void EventLoop::onRun()
 
     while (true)
     {
-        MutexLock lock(_impl->_queueMutex);
-
-        if (_impl->_exitLoop)
-        {
-            _impl->_exitLoop = false;
+        if (atomicExchange(_impl->_exitLoop, 0) != 0)
             break;
-        }
+
+        // Reset the pending wakeup before looking at the queues. Producers
+        // queue first and then check the flag, so every event queued after
+        // this point wakes the selector again.
+        atomicExchange(_impl->_wakePending, 0);
 
         bool eventQueueEmpty = _impl->eventQueueEmpty();
         if (!eventQueueEmpty)
         {
-            lock.unlock();
             processEvents(_impl->_eventsPerLoop);
             eventQueueEmpty = _impl->eventQueueEmpty();
         }
 
-        lock.unlock();
-
         if (eventQueueEmpty)
         {
             idle();
@@ -215,13 +418,12 @@ bool EventLoop::onWaitUntil(Timespan timeout)
 {
     if (_impl->_selector->waitUntil(timeout))
     {
-        MutexLock lock(_impl->_queueMutex);
+        // The loop may be driven by wait() without onRun, so the pending
+        // wakeup is reset here too, before the queues are examined.
+        atomicExchange(_impl->_wakePending, 0);
 
         if (!_impl->eventQueueEmpty())
-        {
-            lock.unlock();
             processEvents(_impl->_eventsPerLoop);
-        }
 
         return true;
     }
@@ -240,10 +442,7 @@ void EventLoop::onExit()
 {
     log_debug("exit loop");
 
-    {
-        MutexLock lock(_impl->_queueMutex);
-        _impl->_exitLoop = true;
-    }
+    atomicExchange(_impl->_exitLoop, 1);
 
     wake();
 }
@@ -252,23 +451,14 @@ void EventLoop::onQueueEvent(const Event& ev, bool priority)
 {
     log_debug("queue event");
 
-    MutexLock lock( _impl->_queueMutex );
-
-    EvPtr cloned(ev.clone());
-
-    if (priority)
-        _impl->_priorityEventQueue.push_back(cloned.ev);
-    else
-        _impl->_eventQueue.push_back(cloned.ev);
-
-    cloned.ev = 0;
+    _impl->queueEvent(ev, priority);
 }
 
 
 void EventLoop::onCommitEvent(const Event& ev, bool priority)
 {
-    onQueueEvent(ev, priority);
-    _impl->_selector->wake();
+    _impl->queueEvent(ev, priority);
+    _impl->wake();
 }
 
 
@@ -276,69 +466,38 @@ void EventLoop::onProcessEvents(unsigned max)
 {
     unsigned count = 0;
 
-    bool& exitLoop = _impl->_exitLoop;
-    std::deque<Event*>& eventQueue = _impl->_eventQueue;
-    std::deque<Event*>& priorityEventQueue = _impl->_priorityEventQueue;
-    std::deque<Event*>& activeEventQueue = _impl->_activeEventQueue;
-    bool& activeEventQueueIsPriority = _impl->_activeEventQueueIsPriority;
-    Mutex& queueMutex = _impl->_queueMutex;
+    // Events are consumed only by the thread running the loop, so the
+    // queues need no lock here.
+    log_debug("processEvents(max:" << max << ')');
 
-    log_debug("processEvents(max:" << max << ") normal/priority/active(priority): " << eventQueue.size() << '/' << priorityEventQueue.size() << '/' << activeEventQueue.size() << '(' << activeEventQueueIsPriority << ')');
+    // see onRun
+    atomicExchange(_impl->_wakePending, 0);
 
-    if (!activeEventQueue.empty() && !activeEventQueueIsPriority)
+    while (atomicGet(_impl->_exitLoop) == 0)
     {
-        MutexLock lock(queueMutex);
-        if (!priorityEventQueue.empty())
+        // priority events always bypass normal events
+        EventNode* node = _impl->pop();
+        if (node == 0)
         {
-            log_debug("priority events bypass active events");
-
-            if (eventQueue.empty())
-            {
-                eventQueue.swap(activeEventQueue);
-            }
-            else
-            {
-                eventQueue.insert(eventQueue.begin(), activeEventQueue.begin(), activeEventQueue.end()); 
-                activeEventQueue.clear();
-            }
-
-            priorityEventQueue.swap(activeEventQueue);
-            activeEventQueueIsPriority = true;
-        }
-    }
-
-    while (!exitLoop)
-    {
-        if (activeEventQueue.empty())
-        {
-            MutexLock lock(queueMutex);
-            if (!priorityEventQueue.empty())
-            {
-                log_debug("move " << priorityEventQueue.size() << " priority events to active event queue");
-                activeEventQueueIsPriority = true;
-                activeEventQueue.swap(priorityEventQueue);
-            }
-            else if (!eventQueue.empty())
-            {
-                log_debug("move " << eventQueue.size() << " events to active event queue");
-                activeEventQueueIsPriority = false;
-                activeEventQueue.swap(eventQueue);
-            }
-        }
-
-        if (exitLoop || activeEventQueue.empty())
-        {
-            log_debug_if(activeEventQueue.empty(), "no events to process");
+            log_debug("no events to process");
             break;
         }
 
-        EvPtr ev(activeEventQueue.front());
-        activeEventQueue.pop_front();
+        struct NodeReleaser
+        {
+            EventNodePool& pool;
+            EventNode* node;
+            NodeReleaser(EventNodePool& pool_, EventNode* node_)
+                : pool(pool_), node(node_)
+            { }
+            ~NodeReleaser()
+            { pool.put(node); }
+        } releaser(_impl->_pool, node);
 
         ++count;
 
         log_debug("send event " << count);
-        event.send(*ev.ev);
+        event.send(*node->event);
 
         if (max != 0 && count >= max)
         {
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef CXXTOOLS_FUTEX_H
+#define CXXTOOLS_FUTEX_H
+
+#if defined(__linux__)
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+#define CXXTOOLS_HAVE_FUTEX
+
+namespace cxxtools {
+
+/** Sleeps as long as *addr equals expected.
+
+    Returns false, when the timeout expired. Spurious wakeups are possible,
+    so the caller has to check its condition again.
+*/
+inline bool futexWait(volatile int* addr, int expected, const struct timespec* timeout = 0)
+{
+    int rc = syscall(SYS_futex, const_cast<int*>(addr), FUTEX_WAIT_PRIVATE, expected, timeout, 0, 0);
+    return rc == 0 || errno != ETIMEDOUT;
+}
+
+/// Wakes up to count threads waiting on addr.
+inline void futexWake(volatile int* addr, int count)
+{
+    syscall(SYS_futex, const_cast<int*>(addr), FUTEX_WAKE_PRIVATE, count, 0, 0, 0);
+}
+
+} // !namespace cxxtools
+
+#endif
+
+#endif // CXXTOOLS_FUTEX_H
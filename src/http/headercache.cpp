@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "headercache.h"
+#include <cxxtools/http/messageheader.h>
+#include <cxxtools/thread.h>
+#include <ostream>
+#include <cstring>
+
+namespace cxxtools
+{
+namespace http
+{
+
+DateHeader::DateHeader()
+    : _seq(0),
+      _size(0)
+{
+    update();
+}
+
+void DateHeader::update()
+{
+    char line[sizeof(_line)];
+    std::strcpy(line, "Date: ");
+    MessageHeader::htdateCurrent(line + 6);
+    std::strcat(line, "\r\n");
+
+    atomicIncrement(_seq);
+    std::memcpy(_line, line, sizeof(_line));
+    _size = std::strlen(line);
+    atomicIncrement(_seq);
+}
+
+void DateHeader::write(std::ostream& out) const
+{
+    char line[sizeof(_line)];
+    unsigned size;
+
+    while (true)
+    {
+        atomic_t seq = atomicGet(const_cast<volatile atomic_t&>(_seq));
+        if ((seq & 1) == 0)
+        {
+            std::memcpy(line, _line, sizeof(_line));
+            size = _size;
+            if (atomicGet(const_cast<volatile atomic_t&>(_seq)) == seq)
+                break;
+        }
+
+        Thread::yield();
+    }
+
+    out.write(line, size);
+}
+
+namespace
+{
+    struct StatusLine
+    {
+        unsigned code;
+        const char* text;
+        const char* line;
+    };
+
+    const StatusLine statusLines[] = {
+        { 200, "OK",                    "HTTP/1.1 200 OK\r\n" },
+        { 201, "Created",               "HTTP/1.1 201 Created\r\n" },
+        { 204, "No Content",            "HTTP/1.1 204 No Content\r\n" },
+        { 301, "Moved Permanently",     "HTTP/1.1 301 Moved Permanently\r\n" },
+        { 302, "Found",                 "HTTP/1.1 302 Found\r\n" },
+        { 304, "Not Modified",          "HTTP/1.1 304 Not Modified\r\n" },
+        { 400, "Bad Request",           "HTTP/1.1 400 Bad Request\r\n" },
+        { 401, "Unauthorized",          "HTTP/1.1 401 Unauthorized\r\n" },
+        { 401, "not authorized",        "HTTP/1.1 401 not authorized\r\n" },
+        { 403, "Forbidden",             "HTTP/1.1 403 Forbidden\r\n" },
+        { 404, "Not Found",             "HTTP/1.1 404 Not Found\r\n" },
+        { 404, "Not found",             "HTTP/1.1 404 Not found\r\n" },
+        { 500, "Internal Server Error", "HTTP/1.1 500 Internal Server Error\r\n" },
+        { 500, "internal server error", "HTTP/1.1 500 internal server error\r\n" }
+    };
+}
+
+const char* statusLine(unsigned major, unsigned minor, unsigned code, const std::string& text, std::size_t& size)
+{
+    if (major != 1 || minor != 1)
+        return 0;
+
+    for (unsigned n = 0; n < sizeof(statusLines) / sizeof(statusLines[0]); ++n)
+    {
+        if (statusLines[n].code == code && text == statusLines[n].text)
+        {
+            size = std::strlen(statusLines[n].line);
+            return statusLines[n].line;
+        }
+    }
+
+    return 0;
+}
+
+}
+}
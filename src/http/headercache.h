@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HTTP_HEADERCACHE_H
+#define CXXTOOLS_HTTP_HEADERCACHE_H
+
+#include <cxxtools/atomicity.h>
+#include <iosfwd>
+#include <string>
+
+namespace cxxtools
+{
+namespace http
+{
+
+/**
+ Keeps the formatted "Date" header line of the current second.
+
+ The line is updated by a timer once a second and read by the threads,
+ which send replies. Readers copy the line and retry, when an update
+ happened in between, so that neither side takes a lock.
+ */
+class DateHeader
+{
+#if __cplusplus >= 201103L
+        DateHeader(const DateHeader&) = delete;
+        DateHeader& operator=(const DateHeader&) = delete;
+#else
+        DateHeader(const DateHeader&);
+        DateHeader& operator=(const DateHeader&);
+#endif
+
+    public:
+        DateHeader();
+
+        /// Formats the current time.
+        void update();
+
+        /// Writes the header line including the line end.
+        void write(std::ostream& out) const;
+
+    private:
+        volatile atomic_t _seq;  // odd while an update is in progress
+        char _line[64];
+        unsigned _size;
+};
+
+/**
+ Returns a preformatted status line like "HTTP/1.1 200 OK\r\n" for common
+ return codes or 0 if there is none for the combination. The size of the
+ line is returned in size.
+ */
+const char* statusLine(unsigned major, unsigned minor, unsigned code, const std::string& text, std::size_t& size);
+
+}
+}
+
+#endif // CXXTOOLS_HTTP_HEADERCACHE_H
@@ -28,7 +28,10 @@
 
 #include <cxxtools/http/service.h>
 #include <cxxtools/http/request.h>
+#include <cxxtools/thread.h>
 #include <cxxtools/log.h>
+#include <algorithm>
+#include <stdexcept>
 #include "mapper.h"
 
 log_define("cxxtools.http.mapper")
@@ -38,63 +41,488 @@ namespace cxxtools
 namespace http
 {
 
+namespace
+{
+    struct Route
+    {
+        unsigned seq;
+        Service* service;
+
+        Route(unsigned seq_, Service* service_)
+            : seq(seq_),
+              service(service_)
+        { }
+
+        bool operator< (const Route& other) const
+        { return seq < other.seq; }
+    };
+
+    typedef std::vector<Route> RoutesType;
+
+    // A part of a sorted route list.
+    struct RouteRange
+    {
+        const Route* cur;
+        const Route* end;
+    };
+
+    // The routes matching a url are collected as ranges of the sorted route
+    // lists, which are precomputed in the tree. Usually there is just one.
+    class RouteRanges
+    {
+            enum { fixedSize = 8 };
+
+            RouteRange _fixed[fixedSize];
+            std::vector<RouteRange> _more;
+            unsigned _size;
+
+        public:
+            RouteRanges()
+                : _size(0)
+            { }
+
+            void add(const RoutesType& routes)
+            {
+                if (routes.empty())
+                    return;
+
+                RouteRange range;
+                range.cur = &routes[0];
+                range.end = range.cur + routes.size();
+
+                if (_size < fixedSize)
+                    _fixed[_size] = range;
+                else
+                    _more.push_back(range);
+
+                ++_size;
+            }
+
+            unsigned size() const
+            { return _size; }
+
+            RouteRange& operator[] (unsigned n)
+            { return n < fixedSize ? _fixed[n] : _more[n - fixedSize]; }
+    };
+
+    // Node of the radix tree. The label is the part of the url leading from
+    // the parent node to this node. Children of a node differ in the first
+    // character of their label. The param child matches one path segment.
+    class RouteNode
+    {
+#if __cplusplus >= 201103L
+            RouteNode(const RouteNode&) = delete;
+            RouteNode& operator=(const RouteNode&) = delete;
+#else
+            RouteNode(const RouteNode&);
+            RouteNode& operator=(const RouteNode&);
+#endif
+
+        public:
+            std::string label;
+            std::vector<RouteNode*> children;
+            RouteNode* param;
+            RoutesType exact;
+            RoutesType prefix;
+
+            // Sorted routes of this node and the prefix routes of its
+            // ancestors, when the url ends here or continues past it.
+            RoutesType matches;
+            RoutesType prefixes;
+
+            explicit RouteNode(const std::string& label_ = std::string())
+                : label(label_),
+                  param(0)
+            { }
+
+            ~RouteNode()
+            {
+                for (std::vector<RouteNode*>::iterator it = children.begin(); it != children.end(); ++it)
+                    delete *it;
+                delete param;
+            }
+
+            RouteNode* child(char ch) const
+            {
+                for (std::vector<RouteNode*>::const_iterator it = children.begin(); it != children.end(); ++it)
+                    if ((*it)->label[0] == ch)
+                        return *it;
+                return 0;
+            }
+
+            RouteNode* insert(const std::string& s, std::string::size_type pos, std::string::size_type end);
+            RouteNode* paramChild();
+
+            void finish(const RoutesType& inherited);
+
+            void collect(const std::string& url, std::string::size_type pos, RouteRanges& result) const;
+    };
+
+    RouteNode* RouteNode::insert(const std::string& s, std::string::size_type pos, std::string::size_type end)
+    {
+        RouteNode* node = this;
+
+        while (pos < end)
+        {
+            std::vector<RouteNode*>::iterator it;
+            for (it = node->children.begin(); it != node->children.end(); ++it)
+                if ((*it)->label[0] == s[pos])
+                    break;
+
+            if (it == node->children.end())
+            {
+                RouteNode* c = new RouteNode(s.substr(pos, end - pos));
+                node->children.push_back(c);
+                return c;
+            }
+
+            RouteNode* c = *it;
+            std::string::size_type n = 1;
+            while (n < c->label.size() && pos + n < end && c->label[n] == s[pos + n])
+                ++n;
+
+            if (n < c->label.size())
+            {
+                // split the edge at the first differing character
+                RouteNode* m = new RouteNode(c->label.substr(0, n));
+                c->label.erase(0, n);
+                m->children.push_back(c);
+                *it = m;
+                c = m;
+            }
+
+            pos += n;
+            node = c;
+        }
+
+        return node;
+    }
+
+    RouteNode* RouteNode::paramChild()
+    {
+        if (param == 0)
+            param = new RouteNode();
+        return param;
+    }
+
+    void RouteNode::finish(const RoutesType& inherited)
+    {
+        prefixes = inherited;
+        prefixes.insert(prefixes.end(), prefix.begin(), prefix.end());
+        std::sort(prefixes.begin(), prefixes.end());
+
+        matches = prefixes;
+        matches.insert(matches.end(), exact.begin(), exact.end());
+        std::sort(matches.begin(), matches.end());
+
+        for (std::vector<RouteNode*>::iterator it = children.begin(); it != children.end(); ++it)
+            (*it)->finish(prefixes);
+
+        // the prefix routes of the ancestors are already collected on the
+        // literal path, when a parameter is matched
+        if (param)
+            param->finish(RoutesType());
+    }
+
+    void RouteNode::collect(const std::string& url, std::string::size_type pos, RouteRanges& result) const
+    {
+        const RouteNode* node = this;
+
+        while (true)
+        {
+            if (pos >= url.size())
+            {
+                result.add(node->matches);
+                return;
+            }
+
+            if (node->param)
+            {
+                std::string::size_type e = url.find('/', pos);
+                if (e == std::string::npos)
+                    e = url.size();
+                if (e > pos)
+                    node->param->collect(url, e, result);
+            }
+
+            const RouteNode* c = node->child(url[pos]);
+            if (c == 0 || url.compare(pos, c->label.size(), c->label) != 0)
+            {
+                result.add(node->prefixes);
+                return;
+            }
+
+            pos += c->label.size();
+            node = c;
+        }
+    }
+}
+
+class Mapper::Routes
+{
+        RouteNode _root;
+
+        struct RegexRoute
+        {
+            Route route;
+            Regex regex;
+
+            RegexRoute(const Route& route_, const Regex& regex_)
+                : route(route_),
+                  regex(regex_)
+            { }
+        };
+
+        std::vector<RegexRoute> _regexRoutes;
+
+    public:
+        class Candidates;
+        friend class Candidates;
+
+        explicit Routes(const EntriesType& entries);
+};
+
+// Iterates the services matching a url in the order they were added.
+class Mapper::Routes::Candidates
+{
+        const std::string& _url;
+        RouteRanges _ranges;
+        std::vector<RegexRoute>::const_iterator _regex;
+        std::vector<RegexRoute>::const_iterator _regexEnd;
+
+    public:
+        Candidates(const Routes& routes, const std::string& url)
+            : _url(url),
+              _regex(routes._regexRoutes.begin()),
+              _regexEnd(routes._regexRoutes.end())
+        {
+            routes._root.collect(url, 0, _ranges);
+        }
+
+        Service* next();
+};
+
+Mapper::Routes::Routes(const EntriesType& entries)
+{
+    for (unsigned seq = 0; seq < entries.size(); ++seq)
+    {
+        const Entry& entry = entries[seq];
+        Route route(seq, entry.service);
+
+        switch (entry.type)
+        {
+            case Literal:
+                _root.insert(entry.url, 0, entry.url.size())->exact.push_back(route);
+                break;
+
+            case Prefix:
+                _root.insert(entry.url, 0, entry.url.size())->prefix.push_back(route);
+                break;
+
+            case Pattern:
+            {
+                const std::string& p = entry.url;
+                RouteNode* node = &_root;
+                std::string::size_type pos = 0;
+                while (pos < p.size())
+                {
+                    std::string::size_type b = p.find('{', pos);
+                    if (b == std::string::npos)
+                        b = p.size();
+
+                    node = node->insert(p, pos, b);
+                    if (b >= p.size())
+                        break;
+
+                    std::string::size_type e = p.find('}', b);
+                    if (e == std::string::npos)
+                        throw std::runtime_error("missing '}' in url pattern \"" + p + '"');
+
+                    node = node->paramChild();
+                    pos = e + 1;
+                }
+
+                node->exact.push_back(route);
+                break;
+            }
+
+            case RegularExpression:
+                _regexRoutes.push_back(RegexRoute(route, entry.regex));
+                break;
+        }
+    }
+
+    _root.finish(RoutesType());
+}
+
+Service* Mapper::Routes::Candidates::next()
+{
+    while (true)
+    {
+        RouteRange* best = 0;
+        for (unsigned n = 0; n < _ranges.size(); ++n)
+        {
+            RouteRange& range = _ranges[n];
+            if (range.cur != range.end && (best == 0 || range.cur->seq < best->cur->seq))
+                best = &range;
+        }
+
+        // regular expressions are only checked, when it is their turn
+        if (_regex != _regexEnd && (best == 0 || _regex->route.seq < best->cur->seq))
+        {
+            const RegexRoute& r = *_regex++;
+            if (r.regex.match(_url))
+                return r.route.service;
+            continue;
+        }
+
+        if (best == 0)
+            return 0;
+
+        return (best->cur++)->service;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Mapper
+//
+class Mapper::ReadGuard
+{
+        Mapper& _mapper;
+        atomic_t _phase;
+
+    public:
+        explicit ReadGuard(Mapper& mapper)
+            : _mapper(mapper),
+              _phase(atomicGet(mapper._phase) & 1)
+        {
+            atomicIncrement(_mapper._readers[_phase]);
+        }
+
+        ~ReadGuard()
+        {
+            atomicDecrement(_mapper._readers[_phase]);
+        }
+
+        const Routes* routes() const
+        { return static_cast<const Routes*>(_mapper._routes); }
+};
+
+Mapper::Mapper()
+    : _routes(new Routes(_entries)),
+      _phase(0)
+{
+    _readers[0] = 0;
+    _readers[1] = 0;
+}
+
+Mapper::~Mapper()
+{
+    delete static_cast<Routes*>(_routes);
+}
+
 void Mapper::addService(const std::string& url, Service& service)
 {
     log_debug("add service for url <" << url << '>');
-
-    WriteLock serviceLock(_serviceMutex);
-    _services.push_back(ServicesType::value_type(url, &service));
+    add(Entry(Literal, url, &service));
 }
 
 void Mapper::addService(const Regex& url, Service& service)
 {
     log_debug("add service for regex");
+    add(Entry(url, &service));
+}
 
-    WriteLock serviceLock(_serviceMutex);
-    _services.push_back(ServicesType::value_type(url, &service));
+void Mapper::addPrefixService(const std::string& prefix, Service& service)
+{
+    log_debug("add service for url prefix <" << prefix << '>');
+    add(Entry(Prefix, prefix, &service));
+}
+
+void Mapper::addPatternService(const std::string& pattern, Service& service)
+{
+    log_debug("add service for url pattern <" << pattern << '>');
+    add(Entry(Pattern, pattern, &service));
+}
+
+void Mapper::add(const Entry& entry)
+{
+    MutexLock lock(_writeMutex);
+    _entries.push_back(entry);
+    try
+    {
+        publish();
+    }
+    catch (...)
+    {
+        _entries.pop_back();
+        throw;
+    }
 }
 
 void Mapper::removeService(Service& service)
 {
-    WriteLock serviceLock(_serviceMutex);
-    service.waitIdle();
+    MutexLock lock(_writeMutex);
 
-    ServicesType::size_type n = 0;
-    while (n < _services.size())
+    EntriesType::size_type n = 0;
+    while (n < _entries.size())
     {
-        if (_services[n].second == &service)
+        if (_entries[n].service == &service)
         {
-            _services.erase(_services.begin() + n);
+            _entries.erase(_entries.begin() + n);
         }
         else
         {
             ++n;
         }
     }
+
+    publish();
+
+    // after publish no new responders are created for the service
+    service.waitIdle();
+}
+
+void Mapper::publish()
+{
+    Routes* routes = new Routes(_entries);
+    Routes* old = static_cast<Routes*>(atomicExchange(_routes, routes));
+    synchronize();
+    delete old;
+}
+
+void Mapper::synchronize()
+{
+    // Switch the readers to the other counter and wait until the old one
+    // drains. Doing that for both counters ensures that no reader started
+    // before the last publish is still active.
+    for (unsigned n = 0; n < 2; ++n)
+    {
+        atomic_t phase = atomicExchangeAdd(_phase, 1) & 1;
+        while (atomicGet(_readers[phase]) != 0)
+            Thread::yield();
+    }
 }
 
 Responder* Mapper::getResponder(const Request& request)
 {
     log_debug("get responder for url <" << request.url() << '>');
 
-    ReadLock serviceLock(_serviceMutex);
+    ReadGuard guard(*this);
 
-    for (ServicesType::const_iterator it = _services.begin();
-         it != _services.end(); ++it)
+    Routes::Candidates candidates(*guard.routes(), request.url());
+    while (Service* service = candidates.next())
     {
-        if (it->first.match(request.url()))
+        if (!service->checkAuth(request))
         {
-            if (!it->second->checkAuth(request))
-            {
-                return _noAuthService.createResponder(request, it->second->realm(), it->second->authContent());
-            }
+            return _noAuthService.createResponder(request, service->realm(), service->authContent());
+        }
 
-            Responder* resp = it->second->doCreateResponder(request);
-            if (resp)
-            {
-                log_debug("got responder");
-                return resp;
-            }
+        Responder* resp = service->doCreateResponder(request);
+        if (resp)
+        {
+            log_debug("got responder");
+            return resp;
         }
     }
 
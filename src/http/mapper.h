@@ -31,19 +31,59 @@
 
 #include "notfoundservice.h"
 #include "notauthenticatedservice.h"
-#include <map>
 #include <cxxtools/regex.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/atomicity.h>
+#include <vector>
 
 namespace cxxtools
 {
 namespace http
 {
 
+/**
+ The mapper finds the service for a request url.
+
+ Literal, prefix and pattern urls are kept in a radix tree, so that finding
+ the candidates takes time proportional to the length of the url. Regular
+ expressions are checked after that. When multiple services match, they
+ are tried in the order they were added.
+
+ The routing table is immutable once built. Modifications build a new
+ table and swap it in, so that getResponder does not need to take any lock.
+ Old tables are released after all readers have left them.
+ */
 class Mapper
 {
+#if __cplusplus >= 201103L
+        Mapper(const Mapper&) = delete;
+        Mapper& operator=(const Mapper&) = delete;
+#else
+        Mapper(const Mapper&);
+        Mapper& operator=(const Mapper&);
+#endif
+
     public:
+        Mapper();
+        ~Mapper();
+
+        /// Adds a service, which matches exactly the url.
         void addService(const std::string& url, Service& service);
+
+        /// Adds a service, which matches all urls, which match the regular expression.
         void addService(const Regex& url, Service& service);
+
+        /// Adds a service, which matches all urls starting with prefix.
+        void addPrefixService(const std::string& prefix, Service& service);
+
+        /** Adds a service, which matches a url pattern.
+
+            The pattern may contain placeholders in curly braces like
+            "/user/{id}/profile". A placeholder matches exactly one non
+            empty path segment.
+         */
+        void addPatternService(const std::string& pattern, Service& service);
+
         void removeService(Service& service);
 
         Responder* getResponder(const Request& request);
@@ -51,24 +91,51 @@ class Mapper
             { return _defaultService.createResponder(request); }
 
     private:
-        struct Key
+        enum Type
         {
-          Regex regex;
+          Literal,
+          Prefix,
+          Pattern,
+          RegularExpression
+        };
+
+        struct Entry
+        {
+          Type type;
           std::string url;
-          Key() { }
-          Key(const Regex& regex_)
-            : regex(regex_)
+          Regex regex;
+          Service* service;
+
+          Entry(Type type_, const std::string& url_, Service* service_)
+            : type(type_),
+              url(url_),
+              service(service_)
           { }
-          Key(const std::string& url_)
-            : url(url_)
+          Entry(const Regex& regex_, Service* service_)
+            : type(RegularExpression),
+              regex(regex_),
+              service(service_)
           { }
-          bool match(const std::string& u) const
-          { return regex.empty() ? url == u
-                                 : regex.match(u); }
         };
-        typedef std::vector<std::pair<Key, Service*> > ServicesType;
-        ReadWriteMutex _serviceMutex;
-        ServicesType _services;
+
+        typedef std::vector<Entry> EntriesType;
+
+        class Routes;
+        class ReadGuard;
+
+        void add(const Entry& entry);
+        void publish();
+        void synchronize();
+
+        // the master list of services; guarded by _writeMutex
+        Mutex _writeMutex;
+        EntriesType _entries;
+
+        // the current routing table and the reader counts of both phases
+        void* volatile _routes;
+        volatile atomic_t _phase;
+        volatile atomic_t _readers[2];
+
         NotFoundService _defaultService;
         NotAuthenticatedService _noAuthService;
 };
@@ -68,20 +68,126 @@ int compareIgnoreCase(const char* s1, const char* s2)
                 : *it2 ? -1 : 0;
 }
 
-} 
+// case insensitive FNV-1a hash
+unsigned hashKey(const char* key)
+{
+    unsigned h = 2166136261u;
+    for (const char* p = key; *p; ++p)
+    {
+        char ch = *p;
+        if (ch >= 'a' && ch <= 'z')
+            ch -= 'a' - 'A';
+        h = (h ^ static_cast<unsigned char>(ch)) * 16777619u;
+    }
+    return h;
+}
 
+// hashes of the headers, we look at for every request
+unsigned connectionHash()
+{
+    static const unsigned hash = hashKey("Connection");
+    return hash;
+}
 
-const char* MessageHeader::getHeader(const char* key) const
+unsigned contentLengthHash()
+{
+    static const unsigned hash = hashKey("Content-Length");
+    return hash;
+}
+
+unsigned transferEncodingHash()
 {
-    for (const_iterator it = begin(); it != end(); ++it)
+    static const unsigned hash = hashKey("Transfer-Encoding");
+    return hash;
+}
+
+std::size_t parseContentLength(const char* s)
+{
+    std::size_t size = 0;
+    if (s != 0)
     {
-        if (compareIgnoreCase(key, it->first) == 0)
-            return it->second;
+        while (*s >= '0' && *s <= '9')
+            size = size * 10 + (*s++ - '0');
+    }
+
+    return size;
+}
+
+}
+
+void MessageHeader::clearIndex()
+{
+    std::memset(_index, 0, sizeof(_index));
+    _indexComplete = true;
+    _indexCount = 0;
+    _contentLength = 0;
+}
+
+void MessageHeader::buildIndex()
+{
+    clearIndex();
+    for (const_iterator it = begin(); it != end() && _indexComplete; ++it)
+        addIndex(it->first);
+}
+
+void MessageHeader::addIndex(const char* key)
+{
+    if (!_indexComplete)
+        return;
+
+    if (_indexCount >= INDEXSIZE / 4 * 3)
+    {
+        _indexComplete = false;
+        return;
+    }
+
+    unsigned h = hashKey(key);
+    unsigned n = h & (INDEXSIZE - 1);
+    while (_index[n] != 0)
+    {
+        // keep the first of multiple headers with the same key
+        if (_indexHash[n] == h && compareIgnoreCase(_rawdata + _index[n] - 1, key) == 0)
+            return;
+        n = (n + 1) & (INDEXSIZE - 1);
+    }
+
+    _index[n] = static_cast<unsigned short>(key - _rawdata + 1);
+    _indexHash[n] = h;
+    ++_indexCount;
+
+    if (h == contentLengthHash() && compareIgnoreCase(key, "Content-Length") == 0)
+        _contentLength = parseContentLength(key + std::strlen(key) + 1);
+}
+
+const char* MessageHeader::findHeader(const char* key, unsigned hash) const
+{
+    for (unsigned n = hash & (INDEXSIZE - 1); _index[n] != 0; n = (n + 1) & (INDEXSIZE - 1))
+    {
+        if (_indexHash[n] == hash)
+        {
+            const char* k = _rawdata + _index[n] - 1;
+            if (compareIgnoreCase(key, k) == 0)
+                return k + std::strlen(k) + 1;
+        }
+    }
+
+    if (!_indexComplete)
+    {
+        for (const_iterator it = begin(); it != end(); ++it)
+        {
+            if (compareIgnoreCase(key, it->first) == 0)
+                return it->second;
+        }
     }
 
     return 0;
 }
 
+const char* MessageHeader::getHeader(const char* key) const
+{
+    return findHeader(key, hashKey(key));
+}
+
 bool MessageHeader::isHeaderValue(const char* key, const char* value) const
 {
     const char* h = getHeader(key);
@@ -92,6 +198,7 @@ bool MessageHeader::isHeaderValue(const char* key, const char* value) const
 
 void MessageHeader::clear()
 {
+    clearIndex();
     _rawdata[0] = _rawdata[1] = '\0';
     _endOffset = 0;
     _httpVersionMajor = 1;
@@ -109,6 +216,7 @@ void MessageHeader::setHeader(const char* key, const char* value, bool replace)
         removeHeader(key);
 
     char* p = eptr();
+    char* k = p;
 
     size_t lk = strlen(key);     // length of key
     size_t lv = strlen(value);   // length of value
@@ -122,6 +230,41 @@ void MessageHeader::setHeader(const char* key, const char* value, bool replace)
     p[lv + 1] = '\0';      // put new message end marker in place
 
     _endOffset = (p + lv + 1) - _rawdata;
+
+    addIndex(k);
+}
+
+void MessageHeader::addHeader(const char* key, std::size_t keySize, const char* value, std::size_t valueSize)
+{
+    if (keySize == 0)
+        throw std::runtime_error("empty key not allowed in messageheader");
+
+    // Headers are stored as "key\0value\0", so a NUL would shift the
+    // following headers. The value ends there, like in the other overloads.
+    const char* nul = static_cast<const char*>(std::memchr(value, '\0', valueSize));
+    if (nul)
+        valueSize = nul - value;
+
+    if (std::memchr(key, '\0', keySize) != 0)
+        throw std::runtime_error("NUL character in messageheader key");
+
+    char* p = eptr();
+    char* k = p;
+
+    if (p - _rawdata + keySize + valueSize + 3 > MAXHEADERSIZE)
+        throw std::runtime_error("message header too big");
+
+    std::memcpy(p, key, keySize);       // copy key
+    p += keySize;
+    *p++ = '\0';
+    std::memcpy(p, value, valueSize);   // copy value
+    p += valueSize;
+    *p++ = '\0';
+    *p = '\0';                          // put new message end marker in place
+
+    _endOffset = p - _rawdata;
+
+    addIndex(k);
 }
 
 void MessageHeader::removeHeader(const char* key)
@@ -130,6 +273,7 @@ void MessageHeader::removeHeader(const char* key)
         throw std::runtime_error("empty key not allowed in messageheader");
 
     char* p = eptr();
+    bool removed = false;
 
     const_iterator it = begin();
     while (it != end())
@@ -144,6 +288,7 @@ void MessageHeader::removeHeader(const char* key)
                 p - it->first + slen);
 
             p -= slen;
+            removed = true;
 
             it.fixup();
         }
@@ -152,29 +297,29 @@ void MessageHeader::removeHeader(const char* key)
     }
 
     _endOffset = p - _rawdata;
+
+    // the offsets of the following keys have changed
+    if (removed)
+        buildIndex();
 }
 
 bool MessageHeader::chunkedTransferEncoding() const
 {
-    return isHeaderValue("Transfer-Encoding", "chunked");
+    const char* h = findHeader("Transfer-Encoding", transferEncodingHash());
+    return h != 0 && compareIgnoreCase(h, "chunked") == 0;
 }
 
 std::size_t MessageHeader::contentLength() const
 {
-    const char* s = getHeader("Content-Length");
-    if (s == 0)
-        return 0;
-
-    std::size_t size = 0;
-    while (*s >= '0' && *s <= '9')
-        size = size * 10 + (*s++ - '0');
+    if (_indexComplete)
+        return _contentLength;
 
-    return size;
+    return parseContentLength(findHeader("Content-Length", contentLengthHash()));
 }
 
 bool MessageHeader::keepAlive() const
 {
-    const char* ch = getHeader("Connection");
+    const char* ch = findHeader("Connection", connectionHash());
 
     if (ch == 0)
         return httpVersionMajor() == 1
@@ -32,6 +32,7 @@
 #include <cctype>
 #include <algorithm>
 #include <string.h>
+#include <cstring>
 
 log_define("cxxtools.http.parser")
 
@@ -96,6 +97,12 @@ namespace http {
     {
     }
 
+    void HeaderParser::Event::onHeader(const char* key, std::size_t keySize, const char* value, std::size_t valueSize)
+    {
+        onKey(std::string(key, keySize));
+        onValue(std::string(value, valueSize));
+    }
+
     void HeaderParser::Event::onHttpReturn(unsigned /*ret*/, const std::string& /*text*/)
     {
     }
@@ -119,6 +126,11 @@ namespace http {
         _header.addHeader(_key, value.c_str());
     }
 
+    void HeaderParser::MessageHeaderEvent::onHeader(const char* key, std::size_t keySize, const char* value, std::size_t valueSize)
+    {
+        _header.addHeader(key, keySize, value, valueSize);
+    }
+
     std::size_t HeaderParser::advance(std::streambuf& sb)
     {
         std::size_t ret = 0;
@@ -133,6 +145,80 @@ namespace http {
         return ret;
     }
 
+    std::size_t HeaderParser::advance(BasicStreamBuffer<char>& sb)
+    {
+        std::size_t ret = 0;
+
+        while (sb.in_avail() > 0)
+        {
+            if (state == &HeaderParser::state_h0)
+            {
+                // fast path: take complete header lines directly from the buffer
+                const char* b = sb.in_data();
+                std::size_t n = parseHeaderLine(b, b + sb.in_size());
+                if (n > 0)
+                {
+                    sb.in_skip(n);
+                    ret += n;
+                    continue;
+                }
+            }
+
+            ++ret;
+            if (parse(sb.sbumpc()))
+                return ret;
+        }
+
+        return ret;
+    }
+
+    // Parses a complete header line "key: value\r\n" starting at b. The
+    // boundaries are found with memchr. Returns the number of characters
+    // consumed or 0 if the line is not complete or not trivial. In that case
+    // the character state machine takes over.
+    std::size_t HeaderParser::parseHeaderLine(const char* b, const char* e)
+    {
+        if (b >= e || *b <= 32 || *b >= 127)
+            return 0;
+
+        const char* nl = static_cast<const char*>(std::memchr(b, '\n', e - b));
+
+        // we need the character after the line to detect continuation lines
+        if (nl == 0 || nl + 1 >= e || nl[1] == ' ' || nl[1] == '\t')
+            return 0;
+
+        const char* colon = static_cast<const char*>(std::memchr(b, ':', nl - b));
+        if (colon == 0)
+            return 0;
+
+        const char* ke = colon;
+        while (ke > b && (ke[-1] == ' ' || ke[-1] == '\t'))
+            --ke;
+
+        for (const char* p = b; p < ke; ++p)
+            if (*p <= 32 || *p >= 127)
+                return 0;
+
+        const char* v = colon + 1;
+        while (v < nl && (*v == ' ' || *v == '\t'))
+            ++v;
+
+        const char* ve = nl;
+        if (ve > v && ve[-1] == '\r')
+            --ve;
+
+        if (std::memchr(v, '\r', ve - v) != 0)
+            return 0;
+
+        // the state machine passes values as c strings, which end at a NUL
+        if (std::memchr(v, '\0', ve - v) != 0)
+            return 0;
+
+        ev.onHeader(b, ke - b, v, ve - v);
+
+        return nl + 1 - b;
+    }
+
     void HeaderParser::state_cmd0(char ch)
     {
         if (istokenchar(ch))
@@ -30,6 +30,7 @@
 #define cxxtools_Http_Parser_h
 
 #include <cxxtools/http/messageheader.h>
+#include <cxxtools/streambuffer.h>
 #include <string>
 #include <iostream>
 
@@ -52,6 +53,9 @@ class HeaderParser
                 virtual void onHttpVersion(unsigned major, unsigned minor);
                 virtual void onKey(const std::string& key);
                 virtual void onValue(const std::string& value);
+                /// Called for complete header lines, which are parsed in bulk;
+                /// the default implementation calls onKey and onValue.
+                virtual void onHeader(const char* key, std::size_t keySize, const char* value, std::size_t valueSize);
                 virtual void onHttpReturn(unsigned ret, const std::string& text);
                 virtual void onEnd();
         };
@@ -69,6 +73,7 @@ class HeaderParser
                 virtual void onHttpVersion(unsigned major, unsigned minor);
                 virtual void onKey(const std::string& key);
                 virtual void onValue(const std::string& value);
+                virtual void onHeader(const char* key, std::size_t keySize, const char* value, std::size_t valueSize);
         };
 
     private:
@@ -114,6 +119,8 @@ class HeaderParser
         void state_end(char ch);
         void state_error(char ch);
 
+        std::size_t parseHeaderLine(const char* b, const char* e);
+
         state_type state;
         Event& ev;
 
@@ -129,6 +136,10 @@ class HeaderParser
         /// parse as many characters as available in buffer without blocking
         std::size_t advance(std::streambuf& sb);
 
+        /// parse as many characters as available in buffer without blocking;
+        /// complete header lines are parsed directly in the buffer
+        std::size_t advance(BasicStreamBuffer<char>& sb);
+
         std::size_t advance(std::istream& is)
         { return advance(*is.rdbuf()); }
 
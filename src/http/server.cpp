@@ -70,6 +70,16 @@ void Server::addService(const Regex& url, Service& service)
     _impl->addService(url, service);
 }
 
+void Server::addPrefixService(const std::string& prefix, Service& service)
+{
+    _impl->addPrefixService(prefix, service);
+}
+
+void Server::addPatternService(const std::string& pattern, Service& service)
+{
+    _impl->addPatternService(pattern, service);
+}
+
 void Server::removeService(Service& service)
 {
     _impl->removeService(service);
@@ -30,6 +30,7 @@
 #include "worker.h"
 #include "socket.h"
 
+#include <cxxtools/clock.h>
 #include <cxxtools/eventloop.h>
 #include <cxxtools/log.h>
 #include <cxxtools/net/tcpserver.h>
@@ -123,6 +124,7 @@ ServerImpl::ServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmod
     _eventLoop.event.subscribe(slot(*this, &ServerImpl::onServerStart));
 
     connect(_eventLoop.exited, *this, &ServerImpl::terminate);
+    connect(_dateTimer.timeout, *this, &ServerImpl::onDateTimer);
 
     _eventLoop.commitEvent(ServerStartEvent(this));
 }
@@ -168,6 +170,14 @@ void ServerImpl::start()
     log_trace("start server");
     runmode(Server::Starting);
 
+    // update the date header at each full second
+    int year;
+    unsigned month, day, hour, min, sec, msec;
+    Clock::getSystemTime().get(year, month, day, hour, min, sec, msec);
+    _dateTimer.setSelector(&_eventLoop);
+    _dateTimer.start(DateTime(year, month, day, hour, min, sec), Seconds(1), false);
+    _dateHeader.update();
+
     MutexLock lock(_threadMutex);
     while (_threads.size() < minThreads())
     {
@@ -185,6 +195,8 @@ void ServerImpl::terminate()
 
     _eventLoop.processEvents();
 
+    _dateTimer.stop();
+
     MutexLock lock(_threadMutex);
 
     runmode(Server::Terminating);
@@ -236,6 +248,11 @@ void ServerImpl::terminate()
     }
 }
 
+void ServerImpl::onDateTimer()
+{
+    _dateHeader.update();
+}
+
 void ServerImpl::noWaitingThreads()
 {
     MutexLock lock(_threadMutex);
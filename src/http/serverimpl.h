@@ -30,10 +30,12 @@
 #define CXXTOOLS_HTTP_SERVERIMPL_H
 
 #include "serverimplbase.h"
+#include "headercache.h"
 #include <set>
 #include <vector>
 #include <cxxtools/queue.h>
 #include <cxxtools/event.h>
+#include <cxxtools/timer.h>
 #include <cxxtools/http/server.h>
 
 namespace cxxtools
@@ -74,8 +76,12 @@ class ServerImpl : public ServerImplBase, public Connectable
         // override from ServerImplBase
         void terminate();
 
+        const DateHeader& dateHeader() const
+        { return _dateHeader; }
+
     private:
         void noWaitingThreads();
+        void onDateTimer();
         void onInput(Socket& _socket);
         void onTimeout(Socket& _socket);
 
@@ -98,6 +104,10 @@ class ServerImpl : public ServerImplBase, public Connectable
         Queue<Socket*> _queue;
         std::set<Socket*> _idleSockets;
 
+        ////////////////////////////////////////////////////
+        Timer _dateTimer;
+        DateHeader _dateHeader;
+
         ////////////////////////////////////////////////////
         typedef std::vector<net::TcpServer*> ListenerType;
         ListenerType _listener;
@@ -71,6 +71,10 @@ class ServerImplBase
         { _mapper.addService(url, service); }
         void addService(const Regex& url, Service& service)
         { _mapper.addService(url, service); }
+        void addPrefixService(const std::string& prefix, Service& service)
+        { _mapper.addPrefixService(prefix, service); }
+        void addPatternService(const std::string& pattern, Service& service)
+        { _mapper.addPatternService(pattern, service); }
         void removeService(Service& service)
         { _mapper.removeService(service); }
 
@@ -337,54 +337,76 @@ void Socket::onTimeout()
 
 void Socket::sendReply()
 {
-    const char* contentLength = "Content-Length";
-    const char* server = "Server";
-    const char* connection = "Connection";
-    const char* date = "Date";
+    static const char contentLength[] = "Content-Length";
+    static const char server[] = "Server";
+    static const char connection[] = "Connection";
+    static const char date[] = "Date";
+
+    static const char serverLine[] = "Server: cxxtools-Http-Server " PACKAGE_VERSION "\r\n";
+    static const char keepAliveLine[] = "Connection: keep-alive\r\n";
+    static const char closeLine[] = "Connection: close\r\n";
 
     log_info("request " << _request.method() << ' ' << _request.header().query()
         << " ready, returncode " << _reply.httpReturnCode() << ' '
         << _reply.httpReturnText());
 
-    _stream << "HTTP/"
-        << _reply.header().httpVersionMajor() << '.'
-        << _reply.header().httpVersionMinor() << ' '
-        << _reply.header().httpReturnCode() << ' '
-        << _reply.header().httpReturnText() << "\r\n";
+    const ReplyHeader& header = _reply.header();
+
+    std::size_t size;
+    const char* status = statusLine(header.httpVersionMajor(), header.httpVersionMinor(),
+        header.httpReturnCode(), header.httpReturnText(), size);
+
+    if (status)
+    {
+        _stream.write(status, size);
+    }
+    else
+    {
+        _stream << "HTTP/"
+            << header.httpVersionMajor() << '.'
+            << header.httpVersionMinor() << ' '
+            << header.httpReturnCode() << ' '
+            << header.httpReturnText() << "\r\n";
+    }
 
-    for (ReplyHeader::const_iterator it = _reply.header().begin();
-        it != _reply.header().end(); ++it)
+    for (ReplyHeader::const_iterator it = header.begin();
+        it != header.end(); ++it)
     {
         _stream << it->first << ": " << it->second << "\r\n";
     }
 
-    if (!_reply.header().hasHeader(contentLength))
+    _body = _reply.body();
+
+    if (!header.hasHeader(contentLength))
     {
-        _stream << "Content-Length: " << _reply.bodySize() << "\r\n";
+        _stream << "Content-Length: " << _body.size() << "\r\n";
     }
 
-    if (!_reply.header().hasHeader(server))
+    if (!header.hasHeader(server))
     {
-        _stream << "Server: cxxtools-Http-Server " PACKAGE_VERSION "\r\n";
+        _stream.write(serverLine, sizeof(serverLine) - 1);
     }
 
-    if (!_reply.header().hasHeader(connection))
+    if (!header.hasHeader(connection))
     {
-        _stream << "Connection: "
-                << (_request.header().keepAlive() ? "keep-alive" : "close")
-                << "\r\n";
+        if (_request.header().keepAlive())
+            _stream.write(keepAliveLine, sizeof(keepAliveLine) - 1);
+        else
+            _stream.write(closeLine, sizeof(closeLine) - 1);
     }
 
-    if (!_reply.header().hasHeader(date))
+    if (!header.hasHeader(date))
     {
-        char buffer[50];
-        _stream << "Date: " << MessageHeader::htdateCurrent(buffer) << "\r\n";
+        _server.dateHeader().write(_stream);
     }
 
     _stream << "\r\n";
 
-    _reply.sendBody(_stream);
-
+    // larger bodies are sent from _body without copying them to the stream buffer
+    if (_body.size() < 1024)
+        _stream.write(_body.data(), _body.size());
+    else
+        _stream.buffer().writeRef(_body.data(), _body.size());
 }
 
 bool Socket::onAcceptSslCertificate(const SslCertificate& cert)
@@ -109,6 +109,7 @@ class Socket : public net::TcpSocket, public Connectable
         HeaderParser _parser;
         Request _request;
         Reply _reply;
+        std::string _body;  // reply body referenced by the output buffer until sent
 
         Timer _timer;
         int _contentLength;
@@ -73,6 +73,11 @@ size_t IODevice::onWrite(const char* buffer, size_t count)
     return ioimpl().write(buffer, count);
 }
 
+size_t IODevice::onWritev(const IOVec* vec, size_t count)
+{
+    return ioimpl().writev(vec, count);
+}
+
 void IODevice::onClose()
 {
     cancel();
@@ -267,6 +272,15 @@ size_t IODevice::write(const char* buffer, size_t n)
 }
 
 
+size_t IODevice::writev(const IOVec* vec, size_t count)
+{
+    if (_wbuf)
+        throw IOPending("write operation pending");
+
+    return this->onWritev(vec, count);
+}
+
+
 void IODevice::cancel()
 {
     onCancel();
@@ -27,14 +27,17 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "iodeviceimpl.h"
+#include "selectorimpl.h"
 #include "cxxtools/ioerror.h"
 #include "error.h"
 #include <cerrno>
 #include <cassert>
+#include <algorithm>
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
 #include <sys/poll.h>
+#include <sys/uio.h>
 #include <cxxtools/log.h>
 #include <cxxtools/hexdump.h>
 
@@ -53,12 +56,16 @@ IODeviceImpl::IODeviceImpl(IODevice& device)
 , _pfd(0)
 , _sentry(0)
 , _errorPending(false)
+, _ring(0)
 { }
 
 
 
 IODeviceImpl::~IODeviceImpl()
 {
+    if (_recv.pending)
+        _ring->cancel(_recv);
+
     assert(_pfd == 0);
 
     if(_sentry)
@@ -142,6 +149,13 @@ void IODeviceImpl::close()
     if (_pfd)
         _pfd->revents = 0;
 
+    // the kernel must not receive into the buffer any more
+    if (_recv.pending)
+        _ring->cancel(_recv);
+
+    _recv.done = false;
+    _readAhead.clear();
+
     if(_fd != -1)
     {
         int fd = _fd;
@@ -160,8 +174,27 @@ void IODeviceImpl::close()
 }
 
 
-size_t IODeviceImpl::beginRead(char* /*buffer*/, size_t /*n*/, bool& /*eof*/)
+size_t IODeviceImpl::beginRead(char* buffer, size_t n, bool& /*eof*/)
 {
+    if (!_readAhead.empty())
+    {
+        // data received by a canceled request is passed on first
+        size_t count = std::min(n, _readAhead.size());
+        _readAhead.copy(buffer, count);
+        _readAhead.erase(0, count);
+
+        _recv.done = true;
+        _recv.res = static_cast<int>(count);
+        return count;
+    }
+
+    if (_ring && canRecvByRing())
+    {
+        // the kernel receives into the buffer, when data arrives
+        _ring->beginRecv(_recv, _fd, buffer, n);
+        return 0;
+    }
+
     if(_pfd)
     {
         _pfd->events |= POLLIN;
@@ -178,6 +211,14 @@ size_t IODeviceImpl::endRead(bool& eof)
         _pfd->events &= ~POLLIN;
     }
 
+    // endRead is called without waiting for inputReady, when reading
+    // synchronously
+    if (_recv.pending)
+        _ring->cancel(_recv);
+
+    if (_recv.done)
+        return recvResult(eof);
+
     if (_errorPending)
     {
         _errorPending = false;
@@ -188,8 +229,43 @@ size_t IODeviceImpl::endRead(bool& eof)
 }
 
 
+size_t IODeviceImpl::recvResult(bool& eof)
+{
+    _recv.done = false;
+    int res = _recv.res;
+
+    log_debug("recv(" << _fd << ", " << _device.rbuflen() << ") returned " << res);
+
+    if (res > 0)
+    {
+        log_finer(hexDump(_device.rbuf(), res));
+        return static_cast<size_t>(res);
+    }
+
+    if (res == 0 || res == -ECONNRESET)
+    {
+        eof = true;
+        return 0;
+    }
+
+    if (res == -EAGAIN)
+        return this->read( _device.rbuf(), _device.rbuflen(), eof );
+
+    errno = -res;
+    throw IOError(getErrnoString("recv"));
+}
+
+
 size_t IODeviceImpl::read( char* buffer, size_t count, bool& eof )
 {
+    if (!_readAhead.empty())
+    {
+        size_t n = std::min(count, _readAhead.size());
+        _readAhead.copy(buffer, n);
+        _readAhead.erase(0, n);
+        return n;
+    }
+
     ssize_t ret = 0;
 
     while(true)
@@ -320,6 +396,54 @@ size_t IODeviceImpl::write( const char* buffer, size_t count )
 }
 
 
+size_t IODeviceImpl::writev( const IOVec* vec, size_t count )
+{
+    iovec iov[IOVMAX];
+    if (count > IOVMAX)
+        count = IOVMAX;
+
+    for (size_t n = 0; n < count; ++n)
+    {
+        iov[n].iov_base = const_cast<char*>(vec[n].data);
+        iov[n].iov_len = vec[n].size;
+    }
+
+    ssize_t ret = 0;
+
+    while(true)
+    {
+        log_debug("::writev(" << _fd << ", iov, " << count << ')');
+
+        ret = ::writev(_fd, iov, count);
+        int e = errno;
+        log_debug("writev returned " << ret);
+        if(ret > 0)
+            break;
+
+        if (ret == 0 || e == ECONNRESET || e == EPIPE)
+            throw IOError("lost connection to peer");
+
+        if (e == EINTR)
+            continue;
+
+        if (e != EAGAIN)
+            throw IOError(getErrnoString("writev"));
+
+        pollfd pfd;
+        pfd.fd = this->fd();
+        pfd.revents = 0;
+        pfd.events = POLLOUT;
+
+        if (!this->wait(_timeout, pfd))
+        {
+            throw IOTimeout();
+        }
+    }
+
+    return static_cast<size_t>(ret);
+}
+
+
 void IODeviceImpl::sigwrite(int sig)
 {
     ::write(_fd, (const void*)&sig, sizeof(sig));
@@ -332,6 +456,32 @@ void IODeviceImpl::cancel()
     {
         _pfd->events &= ~(POLLIN|POLLOUT);
     }
+
+    if (_recv.pending)
+        _ring->cancel(_recv);
+
+    // The request may have received data already. It must not get lost, so
+    // it is passed on to the next read.
+    if (_recv.done)
+    {
+        if (_recv.res > 0)
+            _readAhead.insert(0, _device.rbuf(), _recv.res);
+
+        _recv.done = false;
+    }
+}
+
+
+void IODeviceImpl::cancelRecv()
+{
+    if (!_recv.pending)
+        return;
+
+    _ring->cancel(_recv);
+
+    // the read continues with polling
+    if (!_recv.done && _pfd && _device.reading())
+        _pfd->events |= POLLIN;
 }
 
 
@@ -360,9 +510,12 @@ bool IODeviceImpl::wait(Timespan timeout)
         return true;
     }
 
+    // a device waits by itself with poll
+    cancelRecv();
+
     pollfd pfd;
     this->initWait(pfd);
-    this->wait(timeout, pfd);
+    this->wait(_recv.done ? Timespan(0) : timeout, pfd);
     return this->checkPollEvent(pfd);
 }
 
@@ -394,7 +547,8 @@ void IODeviceImpl::initWait(pollfd& pfd)
     pfd.revents = 0;
     pfd.events = 0;
 
-    if( _device.reading() )
+    // a recv request waits for the data in the kernel
+    if( _device.reading() && !_recv.pending && !_recv.done )
         pfd.events |= POLLIN;
     if( _device.writing() )
         pfd.events |= POLLOUT;
@@ -440,7 +594,7 @@ bool IODeviceImpl::checkPollEvent(pollfd& pfd)
     if( ! _sentry )
         return avail;
 
-    if( pfd.revents & POLLIN_MASK )
+    if( (pfd.revents & POLLIN_MASK) || _recv.done )
     {
         inputReady();
         avail = true;
@@ -495,6 +649,18 @@ bool IODeviceImpl::checkPollEvent(pollfd& pfd)
     return avail;
 }
 
+bool IODeviceImpl::useRing(SelectorImpl* selector)
+{
+    if (selector == _ring)
+        return false;
+
+    cancelRecv();
+    _ring = selector;
+
+    return _recv.done;
+}
+
+
 void IODeviceImpl::inputReady()
 {
     log_debug("send signal inputReady");
@@ -30,6 +30,7 @@
 #define CXXTOOLS_SYSTEM_IODEVICEIMPL_H
 
 #include "selectableimpl.h"
+#include "iouring.h"
 #include <cxxtools/iodevice.h>
 #include <cxxtools/timespan.h>
 #include <string>
@@ -74,6 +75,9 @@ namespace cxxtools {
             static const short POLLIN_MASK;
             static const short POLLOUT_MASK;
 
+            // maximum number of buffers passed to a single writev call
+            static const size_t IOVMAX = 64;
+
             IODeviceImpl(IODevice&);
 
             virtual ~IODeviceImpl();
@@ -105,6 +109,8 @@ namespace cxxtools {
 
             virtual size_t write( const char* buffer, size_t count );
 
+            virtual size_t writev( const IOVec* vec, size_t count );
+
             void sigwrite(int sig);
 
             virtual void cancel();
@@ -130,6 +136,12 @@ namespace cxxtools {
 
             virtual bool checkPollEvent(pollfd& pfd);
 
+            virtual bool useRing(SelectorImpl* selector);
+
+            // true, when reads may be submitted to io_uring as recv requests
+            virtual bool canRecvByRing() const
+            { return false; }
+
             virtual void inputReady();
 
             virtual void outputReady();
@@ -141,6 +153,15 @@ namespace cxxtools {
             pollfd* _pfd;
             DestructionSentry* _sentry;
             bool _errorPending;
+
+        private:
+            void cancelRecv();
+
+            size_t recvResult(bool& eof);
+
+            SelectorImpl* _ring;
+            IoRequest _recv;
+            std::string _readAhead;
     };
 
 } //namespace cxxtools
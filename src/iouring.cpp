@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "iouring.h"
+#include "cxxtools/membar.h"
+#include "cxxtools/systemerror.h"
+#include "cxxtools/log.h"
+#include "config.h"
+#include <cstring>
+#include <errno.h>
+
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(HAVE_LINUX_IO_URING_H) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define CXXTOOLS_USE_IOURING
+#endif
+
+log_define("cxxtools.iouring")
+
+namespace cxxtools
+{
+
+IoUring::IoUring()
+    : _fd(-1),
+      _fastPoll(false),
+      _sqRing(0),
+      _sqRingSize(0),
+      _cqRing(0),
+      _cqRingSize(0),
+      _sqes(0),
+      _sqesSize(0),
+      _sqHead(0),
+      _sqTail(0),
+      _sqArray(0),
+      _sqMask(0),
+      _sqEntries(0),
+      _sqLocalTail(0),
+      _cqHead(0),
+      _cqTail(0),
+      _cqes(0),
+      _cqMask(0)
+{ }
+
+IoUring::~IoUring()
+{
+    close();
+}
+
+#ifdef CXXTOOLS_USE_IOURING
+
+namespace
+{
+    void* mapRing(int fd, std::size_t size, off_t offset)
+    {
+        void* p = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return p == MAP_FAILED ? 0 : p;
+    }
+}
+
+bool IoUring::open(unsigned entries)
+{
+    close();
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    int fd = ::syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0)
+    {
+        log_info("io_uring not available; errno=" << errno);
+        return false;
+    }
+
+    // without IORING_FEAT_NODROP completions may get lost when the
+    // completion queue overflows
+    if (!(params.features & IORING_FEAT_NODROP))
+    {
+        log_info("io_uring does not support IORING_FEAT_NODROP");
+        ::close(fd);
+        return false;
+    }
+
+    _fd = fd;
+#ifdef IORING_FEAT_FAST_POLL
+    _fastPoll = (params.features & IORING_FEAT_FAST_POLL) != 0;
+#endif
+
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) && _cqRingSize > _sqRingSize)
+        _sqRingSize = _cqRingSize;
+
+    _sqRing = mapRing(fd, _sqRingSize, IORING_OFF_SQ_RING);
+    if (_sqRing == 0)
+    {
+        close();
+        throwSystemError("mmap");
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        _cqRing = _sqRing;
+        _cqRingSize = 0;
+    }
+    else
+    {
+        _cqRing = mapRing(fd, _cqRingSize, IORING_OFF_CQ_RING);
+        if (_cqRing == 0)
+        {
+            close();
+            throwSystemError("mmap");
+        }
+    }
+
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = mapRing(fd, _sqesSize, IORING_OFF_SQES);
+    if (_sqes == 0)
+    {
+        close();
+        throwSystemError("mmap");
+    }
+
+    char* sq = static_cast<char*>(_sqRing);
+    _sqHead = reinterpret_cast<volatile unsigned*>(sq + params.sq_off.head);
+    _sqTail = reinterpret_cast<volatile unsigned*>(sq + params.sq_off.tail);
+    _sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    _sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sqEntries = params.sq_entries;
+    _sqLocalTail = *_sqTail;
+
+    char* cq = static_cast<char*>(_cqRing);
+    _cqHead = reinterpret_cast<volatile unsigned*>(cq + params.cq_off.head);
+    _cqTail = reinterpret_cast<volatile unsigned*>(cq + params.cq_off.tail);
+    _cqes = cq + params.cq_off.cqes;
+    _cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+
+    log_debug("io_uring with " << params.sq_entries << " sq entries and " << params.cq_entries << " cq entries set up");
+
+    return true;
+}
+
+void IoUring::close()
+{
+    if (_sqes)
+        ::munmap(_sqes, _sqesSize);
+    if (_cqRing && _cqRing != _sqRing)
+        ::munmap(_cqRing, _cqRingSize);
+    if (_sqRing)
+        ::munmap(_sqRing, _sqRingSize);
+    if (_fd >= 0)
+        ::close(_fd);
+
+    _fd = -1;
+    _fastPoll = false;
+    _sqRing = _cqRing = _sqes = 0;
+}
+
+void* IoUring::getSqe()
+{
+    unsigned head = *_sqHead;
+    membar_read();
+
+    if (_sqLocalTail - head >= _sqEntries)
+        return 0;
+
+    unsigned index = _sqLocalTail & _sqMask;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(_sqes) + index;
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    _sqArray[index] = index;
+    ++_sqLocalTail;
+
+    return sqe;
+}
+
+bool IoUring::pollAdd(int fd, short events, uint64_t userData)
+{
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(getSqe());
+    if (sqe == 0)
+        return false;
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll_events = static_cast<unsigned short>(events);
+    sqe->user_data = userData;
+
+    return true;
+}
+
+bool IoUring::pollRemove(uint64_t target, uint64_t userData)
+{
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(getSqe());
+    if (sqe == 0)
+        return false;
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = userData;
+
+    return true;
+}
+
+bool IoUring::recv(int fd, void* buffer, unsigned n, uint64_t userData)
+{
+#ifdef IORING_FEAT_FAST_POLL
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(getSqe());
+    if (sqe == 0)
+        return false;
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uintptr_t>(buffer);
+    sqe->len = n;
+    sqe->user_data = userData;
+
+    return true;
+#else
+    // the headers know neither IORING_OP_RECV nor internal polling; canRecv
+    // is false then
+    return false;
+#endif
+}
+
+bool IoUring::cancel(uint64_t target, uint64_t userData)
+{
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(getSqe());
+    if (sqe == 0)
+        return false;
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = userData;
+
+    return true;
+}
+
+bool IoUring::submit(unsigned minComplete)
+{
+    // publish the queued entries to the kernel
+    membar_write();
+    *_sqTail = _sqLocalTail;
+
+    while (true)
+    {
+        unsigned head = *_sqHead;
+        membar_read();
+
+        unsigned toSubmit = _sqLocalTail - head;
+
+        // IORING_ENTER_GETEVENTS lets the kernel post pending completions
+        // even when we do not wait
+        int ret = ::syscall(__NR_io_uring_enter, _fd, toSubmit, minComplete, IORING_ENTER_GETEVENTS, 0, 0);
+        if (ret >= 0)
+        {
+            // Not all entries are consumed, when the completion queue
+            // overflows.
+            return static_cast<unsigned>(ret) >= toSubmit;
+        }
+        else if (errno == EBUSY || errno == EAGAIN)
+        {
+            return false;
+        }
+        else if (errno != EINTR)
+        {
+            throwSystemError("io_uring_enter");
+        }
+    }
+}
+
+bool IoUring::complete(uint64_t& userData, int& res)
+{
+    unsigned head = *_cqHead;
+    unsigned tail = *_cqTail;
+    membar_read();
+
+    if (head == tail)
+        return false;
+
+    const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(_cqes) + (head & _cqMask);
+    userData = cqe->user_data;
+    res = cqe->res;
+
+    // the entry must be read before the kernel may overwrite it
+    membar_rw();
+    *_cqHead = head + 1;
+
+    return true;
+}
+
+#else
+
+bool IoUring::open(unsigned)
+{
+    return false;
+}
+
+void IoUring::close()
+{
+}
+
+void* IoUring::getSqe()
+{
+    return 0;
+}
+
+bool IoUring::pollAdd(int, short, uint64_t)
+{
+    return false;
+}
+
+bool IoUring::pollRemove(uint64_t, uint64_t)
+{
+    return false;
+}
+
+bool IoUring::recv(int, void*, unsigned, uint64_t)
+{
+    return false;
+}
+
+bool IoUring::cancel(uint64_t, uint64_t)
+{
+    return false;
+}
+
+bool IoUring::submit(unsigned)
+{
+    return true;
+}
+
+bool IoUring::complete(uint64_t&, int&)
+{
+    return false;
+}
+
+#endif
+
+} // namespace cxxtools
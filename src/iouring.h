@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef CXXTOOLS_IOURING_H
+#define CXXTOOLS_IOURING_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace cxxtools {
+
+/** State of a request, which is executed by the kernel and completed later.
+
+    The request is identified by its address, so it must not move or be
+    destroyed, while it is pending.
+*/
+struct IoRequest
+{
+    IoRequest()
+        : pending(false),
+          canceled(false),
+          done(false),
+          res(0)
+    { }
+
+    bool pending;   ///< submitted; the completion is not fetched yet
+    bool canceled;  ///< the completion does not need to be signaled
+    bool done;      ///< completed and not processed yet; res holds the result
+    int res;        ///< result of the system call or a negative errno
+};
+
+/** Minimal io_uring submission and completion ring.
+
+    Only the operations needed by the selector are supported. The ring is
+    set up with the raw system calls, so that no additional library is
+    needed. When the kernel or the build does not support io_uring, open
+    returns false.
+*/
+class IoUring
+{
+    public:
+        IoUring();
+
+        ~IoUring();
+
+        /// Sets up the ring; returns false if io_uring is not available.
+        bool open(unsigned entries);
+
+        void close();
+
+        bool isOpen() const
+        { return _fd >= 0; }
+
+        /** Returns true, when recv requests wait for data in the kernel.
+
+            Older kernels pass blocking requests to worker threads, so they
+            are used only when the kernel polls internally.
+         */
+        bool canRecv() const
+        { return _fastPoll; }
+
+        /// Queues a one shot poll request; returns false if the submission queue is full.
+        bool pollAdd(int fd, short events, uint64_t userData);
+
+        /// Queues the removal of a poll request; returns false if the submission queue is full.
+        bool pollRemove(uint64_t target, uint64_t userData);
+
+        /// Queues a recv into buffer; returns false if the submission queue is full.
+        bool recv(int fd, void* buffer, unsigned n, uint64_t userData);
+
+        /// Queues the cancellation of a request; returns false if the submission queue is full.
+        bool cancel(uint64_t target, uint64_t userData);
+
+        /** Submits all queued requests and waits for minComplete completions.
+
+            Returns false, when the kernel could not take the requests, because
+            the completion queue is full. The caller has to fetch completions
+            and try again.
+         */
+        bool submit(unsigned minComplete);
+
+        /// Fetches the next completion; returns false if there is none.
+        bool complete(uint64_t& userData, int& res);
+
+    private:
+        void* getSqe();
+
+        int _fd;
+        bool _fastPoll;
+
+        void* _sqRing;
+        std::size_t _sqRingSize;
+        void* _cqRing;
+        std::size_t _cqRingSize;
+        void* _sqes;
+        std::size_t _sqesSize;
+
+        volatile unsigned* _sqHead;
+        volatile unsigned* _sqTail;
+        unsigned* _sqArray;
+        unsigned _sqMask;
+        unsigned _sqEntries;
+        unsigned _sqLocalTail;
+
+        volatile unsigned* _cqHead;
+        volatile unsigned* _cqTail;
+        void* _cqes;
+        unsigned _cqMask;
+
+#if __cplusplus >= 201103L
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+#else
+        IoUring(const IoUring&) { }
+        IoUring& operator=(const IoUring&) { return *this; }
+#endif
+};
+
+} // namespace cxxtools
+
+#endif // CXXTOOLS_IOURING_H
@@ -99,7 +99,8 @@ RpcServerImpl::RpcServerImpl(EventLoopBase& eventLoop, Signal<RpcServer::Runmode
       inputSlot(slot(*this, &RpcServerImpl::onInput)),
       _serviceRegistry(serviceRegistry),
       _minThreads(5),
-      _maxThreads(200)
+      _maxThreads(200),
+      _queue(4096)  // more sockets overflow into a list
 {
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onIdleSocket));
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onNoWaitingThreads));
@@ -33,10 +33,10 @@
 #include <cxxtools/event.h>
 #include <cxxtools/mutex.h>
 #include <cxxtools/condition.h>
-#include <cxxtools/queue.h>
 #include <cxxtools/signal.h>
 #include <cxxtools/delegate.h>
 #include <cxxtools/connectable.h>
+#include "overflowqueue.h"
 
 #include <set>
 #include <vector>
@@ -133,7 +133,7 @@ namespace cxxtools
                 unsigned _maxThreads;
 
                 std::vector<net::TcpServer*> _listener;
-                Queue<Socket*> _queue;
+                OverflowQueue<Socket*> _queue;
 
                 typedef std::set<Socket*> IdleSocket;
                 IdleSocket _idleSocket;
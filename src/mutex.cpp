@@ -172,4 +172,53 @@ bool ReadWriteMutex::unlockNoThrow()
     return false;
 }
 
+
+
+ShardedReadWriteMutex::ShardedReadWriteMutex()
+{
+    _impl = new ShardedReadWriteMutexImpl();
+}
+
+
+ShardedReadWriteMutex::~ShardedReadWriteMutex()
+{
+    delete _impl;
+}
+
+
+void ShardedReadWriteMutex::readLock()
+{
+    _impl->readLock();
+}
+
+
+bool ShardedReadWriteMutex::tryReadLock()
+{
+    return _impl->tryReadLock();
+}
+
+
+void ShardedReadWriteMutex::readUnlock()
+{
+    _impl->readUnlock();
+}
+
+
+void ShardedReadWriteMutex::writeLock()
+{
+    _impl->writeLock();
+}
+
+
+bool ShardedReadWriteMutex::tryWriteLock()
+{
+    return _impl->tryWriteLock();
+}
+
+
+void ShardedReadWriteMutex::writeUnlock()
+{
+    _impl->writeUnlock();
+}
+
 }
@@ -28,10 +28,144 @@
  */
 #include "muteximpl.h"
 #include "cxxtools/systemerror.h"
+#include "cxxtools/thread.h"
 #include <errno.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 namespace cxxtools {
 
+#ifdef CXXTOOLS_HAVE_FUTEX
+
+namespace
+{
+    // Spinning only helps, when the owner of the lock runs on another CPU.
+    unsigned maxSpinRounds()
+    {
+        static const unsigned rounds = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? 10 : 0;
+        return rounds;
+    }
+}
+
+MutexImpl::MutexImpl()
+    : _state(0),
+      _spinRounds(0),
+      _recursive(false)
+{
+}
+
+
+MutexImpl::MutexImpl(bool recursive)
+    : _state(0),
+      _spinRounds(0),
+      _recursive(recursive)
+{
+    if (recursive)
+    {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+        int rc = pthread_mutex_init(&_handle, &attr);
+        if (rc != 0)
+            throw SystemError(rc, "pthread_mutex_init");
+    }
+}
+
+
+MutexImpl::~MutexImpl()
+{
+    if (_recursive)
+        pthread_mutex_destroy(&_handle);
+}
+
+
+void MutexImpl::lock()
+{
+    if (_recursive)
+    {
+        int rc = pthread_mutex_lock(&_handle);
+        if( rc != 0 )
+            throw SystemError(rc, "pthread_mutex_lock failed");
+        return;
+    }
+
+    int c = 0;
+    if (!__atomic_compare_exchange_n(&_state, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        lockSlow();
+}
+
+
+void MutexImpl::lockSlow()
+{
+    // Spin with exponential backoff first. The number of rounds adapts to
+    // the recent success of spinning on this mutex.
+    unsigned rounds = _spinRounds;
+    unsigned maxRounds = maxSpinRounds();
+    if (rounds < maxRounds)
+        ++rounds;
+
+    for (unsigned r = 0; r < rounds; ++r)
+    {
+        for (unsigned n = 0; n < (1u << r); ++n)
+            cpuRelax();
+
+        int c = 0;
+        if (__atomic_load_n(&_state, __ATOMIC_RELAXED) == 0
+            && __atomic_compare_exchange_n(&_state, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            _spinRounds = r + 1;
+            return;
+        }
+    }
+
+    if (_spinRounds > 0)
+        _spinRounds = _spinRounds - 1;
+
+    // mark the mutex as contended and sleep until it is released
+    while (__atomic_exchange_n(&_state, 2, __ATOMIC_ACQUIRE) != 0)
+        futexWait(&_state, 2);
+}
+
+
+bool MutexImpl::tryLock()
+{
+    if (_recursive)
+    {
+        int rc = pthread_mutex_trylock(&_handle);
+
+        if( rc != 0 && rc != EBUSY )
+            throw SystemError(rc, "pthread_mutex_trylock");
+
+        return rc != EBUSY;
+    }
+
+    int c = 0;
+    return __atomic_compare_exchange_n(&_state, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+
+void MutexImpl::unlock()
+{
+    if (_recursive)
+    {
+        int rc = pthread_mutex_unlock(&_handle);
+        if( rc != 0 )
+            throw SystemError(rc, "pthread_mutex_unlock");
+        return;
+    }
+
+    int c = __atomic_exchange_n(&_state, 0, __ATOMIC_RELEASE);
+    if (c == 2)
+        futexWake(&_state, 1);
+    else if (c == 0)
+        throw SystemError(EPERM, "pthread_mutex_unlock");
+}
+
+#else
+
 MutexImpl::MutexImpl()
 {
     pthread_mutexattr_t attr;
@@ -89,6 +223,8 @@ void MutexImpl::unlock()
        throw SystemError(rc, "pthread_mutex_unlock");
 }
 
+#endif
+
 
 ReadWriteMutexImpl::ReadWriteMutexImpl()
 {
@@ -149,4 +285,147 @@ void ReadWriteMutexImpl::unlock()
         throw SystemError(rc, "pthread_rwlock_unlock");
 }
 
+
+ShardedReadWriteMutexImpl::ShardedReadWriteMutexImpl()
+    : _writer(0),
+      _waitingReaders(0),
+      _waitingWriter(0)
+{
+    for (unsigned n = 0; n < Slots; ++n)
+        _slots[n].readers = 0;
+}
+
+
+ShardedReadWriteMutexImpl::~ShardedReadWriteMutexImpl()
+{
+}
+
+
+unsigned ShardedReadWriteMutexImpl::currentSlot()
+{
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0)
+        return static_cast<unsigned>(cpu) % Slots;
+#endif
+
+    static atomic_t nextIndex = 0;
+    static __thread unsigned index = 0;
+    if (index == 0)
+        index = static_cast<unsigned>(atomicIncrement(nextIndex));
+    return index % Slots;
+}
+
+
+atomic_t ShardedReadWriteMutexImpl::readers()
+{
+    // A reader may unlock on another CPU than it locked on, so single
+    // slots may be negative; only the sum is meaningful.
+    atomic_t sum = 0;
+    for (unsigned n = 0; n < Slots; ++n)
+        sum += atomicGet(_slots[n].readers);
+    return sum;
+}
+
+
+void ShardedReadWriteMutexImpl::readLock()
+{
+    while (!tryReadLock())
+    {
+        MutexLock lock(_waitMutex);
+        atomicIncrement(_waitingReaders);
+        while (atomicGet(_writer) != 0)
+            _readerCondition.wait(lock);
+        atomicDecrement(_waitingReaders);
+    }
+}
+
+
+bool ShardedReadWriteMutexImpl::tryReadLock()
+{
+    Slot& slot = _slots[currentSlot()];
+
+    // The increment is a full barrier, so either the writer sees our count
+    // or we see the writer flag.
+    atomicIncrement(slot.readers);
+    if (atomicGet(_writer) == 0)
+        return true;
+
+    // Back off using the same slot, so that the writer never sees the
+    // decrement without the increment.
+    atomicDecrement(slot.readers);
+    if (atomicGet(_waitingWriter) != 0)
+    {
+        MutexLock lock(_waitMutex);
+        _writerCondition.signal();
+    }
+
+    return false;
+}
+
+
+void ShardedReadWriteMutexImpl::readUnlock()
+{
+    atomicDecrement(_slots[currentSlot()].readers);
+    if (atomicGet(_writer) != 0 && atomicGet(_waitingWriter) != 0)
+    {
+        MutexLock lock(_waitMutex);
+        _writerCondition.signal();
+    }
+}
+
+
+void ShardedReadWriteMutexImpl::waitForReaders()
+{
+    for (unsigned r = 0; r < 10 && readers() != 0; ++r)
+    {
+        for (unsigned n = 0; n < (1u << r); ++n)
+            cpuRelax();
+    }
+
+    if (readers() == 0)
+        return;
+
+    MutexLock lock(_waitMutex);
+    atomicSet(_waitingWriter, 1);
+    while (readers() != 0)
+        _writerCondition.wait(lock);
+    atomicSet(_waitingWriter, 0);
+}
+
+
+void ShardedReadWriteMutexImpl::writeLock()
+{
+    _writeMutex.lock();
+    atomicSet(_writer, 1);
+    waitForReaders();
+}
+
+
+bool ShardedReadWriteMutexImpl::tryWriteLock()
+{
+    if (!_writeMutex.tryLock())
+        return false;
+
+    atomicSet(_writer, 1);
+    if (readers() == 0)
+        return true;
+
+    writeUnlock();
+    return false;
+}
+
+
+void ShardedReadWriteMutexImpl::writeUnlock()
+{
+    atomicSet(_writer, 0);
+    if (atomicGet(_waitingReaders) != 0)
+    {
+        MutexLock lock(_waitMutex);
+        _readerCondition.broadcast();
+    }
+
+    _writeMutex.unlock();
+}
+
 } // !namespace cxxtools
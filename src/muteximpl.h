@@ -29,6 +29,10 @@
 #ifndef CXXTOOLS_MUTEXIMPL_H
 #define CXXTOOLS_MUTEXIMPL_H
 
+#include "futex.h"
+#include <cxxtools/atomicity.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
 #include <pthread.h>
 
 namespace cxxtools {
@@ -55,6 +59,17 @@ class MutexImpl
         { return &_handle; }
 
     private:
+#ifdef CXXTOOLS_HAVE_FUTEX
+        void lockSlow();
+
+        // Non recursive mutexes use the futex word instead of the pthread
+        // mutex: 0 = unlocked, 1 = locked, 2 = locked and threads may sleep.
+        volatile int _state;
+        // number of backoff rounds, which were recently sufficient to get
+        // the lock by spinning
+        volatile unsigned char _spinRounds;
+        bool _recursive;
+#endif
         pthread_mutex_t _handle;
 };
 
@@ -80,6 +95,52 @@ class ReadWriteMutexImpl
         pthread_rwlock_t _rwl;
 };
 
+
+class ShardedReadWriteMutexImpl
+{
+    public:
+        ShardedReadWriteMutexImpl();
+
+        ~ShardedReadWriteMutexImpl();
+
+        void readLock();
+
+        bool tryReadLock();
+
+        void readUnlock();
+
+        void writeLock();
+
+        bool tryWriteLock();
+
+        void writeUnlock();
+
+    private:
+        enum { Slots = 32 };
+
+        // reader counts live in separate cache lines, so that readers on
+        // different CPUs do not share a counter
+        struct Slot
+        {
+            volatile atomic_t readers;
+            char pad[64 - sizeof(atomic_t)];
+        };
+
+        static unsigned currentSlot();
+        atomic_t readers();
+        void waitForReaders();
+
+        Slot _slots[Slots];
+        volatile atomic_t _writer;
+        volatile atomic_t _waitingReaders;
+        volatile atomic_t _waitingWriter;
+
+        Mutex _writeMutex;
+        Mutex _waitMutex;
+        Condition _readerCondition;
+        Condition _writerCondition;
+};
+
 } // !namespace cxxtools
 
 #endif // CXXTOOLS_MUTEXIMPL_H
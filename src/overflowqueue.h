@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef CXXTOOLS_OVERFLOWQUEUE_H
+#define CXXTOOLS_OVERFLOWQUEUE_H
+
+#include <cxxtools/lockfreequeue.h>
+#include <cxxtools/mutex.h>
+#include <deque>
+
+namespace cxxtools
+{
+    /** A LockFreeQueue, where put never blocks.
+
+        Elements, which do not fit into the ring buffer, are kept in a list
+        guarded by a mutex. Consumers move them into the ring buffer, after
+        they fetched a element. The order is not strictly first in first out,
+        while elements overflow.
+
+        The servers use it for their socket queue, since the workers, which
+        are the only consumers, put sockets back themselves. A blocking put
+        would deadlock, when all of them wait for room.
+     */
+    template <typename T>
+    class OverflowQueue
+    {
+#if __cplusplus >= 201103L
+            OverflowQueue(const OverflowQueue&) = delete;
+            OverflowQueue& operator=(const OverflowQueue&) = delete;
+#else
+            OverflowQueue(const OverflowQueue&) { }
+            OverflowQueue& operator=(const OverflowQueue&) { return *this; }
+#endif
+
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+            typedef const T& const_reference;
+
+        private:
+            LockFreeQueue<T> _queue;
+            Mutex _mutex;
+            std::deque<T> _overflow;
+            volatile atomic_t _overflowSize;
+
+            void refill()
+            {
+                MutexLock lock(_mutex);
+                while (!_overflow.empty() && _queue.tryPut(_overflow.front()))
+                {
+                    _overflow.pop_front();
+                    atomicDecrement(_overflowSize);
+                }
+            }
+
+        public:
+            explicit OverflowQueue(size_type capacity = 1024)
+                : _queue(capacity),
+                  _overflowSize(0)
+            { }
+
+            /// Returns the next element; blocks while the queue is empty.
+            value_type get()
+            {
+                value_type element = _queue.get();
+                if (atomicGet(_overflowSize) > 0)
+                    refill();
+                return element;
+            }
+
+            /// Adds a element to the queue without blocking.
+            void put(const_reference element)
+            {
+                if (atomicGet(_overflowSize) == 0 && _queue.tryPut(element))
+                    return;
+
+                {
+                    MutexLock lock(_mutex);
+                    _overflow.push_back(element);
+                    atomicIncrement(_overflowSize);
+                }
+
+                // The ring buffer was full, but the consumers may have
+                // emptied it before the element was added to the list.
+                refill();
+            }
+
+            bool empty()
+            { return _queue.empty() && atomicGet(_overflowSize) == 0; }
+
+            size_type size()
+            { return _queue.size() + static_cast<size_type>(atomicGet(_overflowSize)); }
+
+            /// Returns the number of threads blocked in the get method.
+            size_type numWaiting()
+            { return _queue.numWaiting(); }
+    };
+}
+
+#endif // CXXTOOLS_OVERFLOWQUEUE_H
@@ -53,6 +53,16 @@ class SelectorImpl;
             virtual std::size_t initializePoll(pollfd* pfd, std::size_t pollSize) = 0;
 
             virtual bool checkPollEvent() = 0;
+
+            /** Requests are submitted to the io_uring of the selector from
+                now on; a null pointer switches back to polling.
+
+                Pending requests are canceled. Returns true, when a request
+                completed nevertheless, so that the selector has to check the
+                device for events.
+             */
+            virtual bool useRing(SelectorImpl* /*selector*/)
+            { return false; }
     };
 
 } //namespace cxxtools
@@ -38,21 +38,52 @@
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <stdint.h>
 #include "config.h"
 #include "poll.h"
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif
 
 log_define("cxxtools.selector.impl")
 
 namespace cxxtools
 {
 
+namespace
+{
+    // User data of requests is the address of the IoRequest with the highest
+    // bit set. Polls use a 31 bit sequence in the upper half, so they never
+    // have it.
+    const uint64_t RequestTag = static_cast<uint64_t>(1) << 63;
+
+    uint64_t requestData(IoRequest& request)
+    {
+        return RequestTag | reinterpret_cast<uintptr_t>(&request);
+    }
+}
+
 const short SelectorImpl::POLL_ERROR_MASK= POLLERR | POLLHUP | POLLNVAL;
 
 SelectorImpl::SelectorImpl()
-: _isDirty(true)
+: _timerFd(-1),
+  _timerArmed(-1),
+  _isDirty(true),
+  _armSeq(0),
+  _ready(0),
+  _completed(0)
 {
     _current = _devices.end();
 
+#ifdef HAVE_SYS_EVENTFD_H
+    // an eventfd counts the wake ups in a single descriptor
+    _wakePipe[0] = _wakePipe[1] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_wakePipe[0] < 0)
+        throwSystemError("eventfd");
+#else
     //Open a pipe to send wake up message.
     if( ::pipe( _wakePipe ) )
         throwSystemError("pipe");
@@ -72,7 +103,15 @@ SelectorImpl::SelectorImpl()
     ret = ::fcntl(_wakePipe[1], F_SETFL, flags|O_NONBLOCK);
     if(-1 == ret)
         throwSystemError("fcntl");
+#endif
 
+#ifdef HAVE_SYS_TIMERFD_H
+    // The deadline of waitUntil is programmed into a timerfd, which is
+    // polled with the other descriptors. Without it poll gets a timeout.
+    _timerFd = ::timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (_timerFd < 0)
+        log_warn("timerfd_create failed; errno=" << errno);
+#endif
 }
 
 
@@ -85,11 +124,12 @@ SelectorImpl::~SelectorImpl()
         (*it)->setSelector(0);
     }
 
-    if( _wakePipe[0] != -1 && _wakePipe[1] != -1 )
-    {
+    if( _wakePipe[0] != -1 )
         ::close(_wakePipe[0]);
+    if( _wakePipe[1] != -1 && _wakePipe[1] != _wakePipe[0] )
         ::close(_wakePipe[1]);
-    }
+    if( _timerFd != -1 )
+        ::close(_timerFd);
 }
 
 
@@ -97,6 +137,9 @@ void SelectorImpl::add(Selectable& dev)
 {
     _devices.insert(&dev);
     _isDirty = true;
+
+    if (_ring.canRecv())
+        dev.simpl().useRing(this);
 }
 
 
@@ -119,6 +162,9 @@ void SelectorImpl::remove(Selectable& dev)
         _devices.erase(it);
     }
 
+    // requests of the device must not complete after it is removed
+    dev.simpl().useRing(0);
+
     _isDirty = true;
 }
 
@@ -138,15 +184,27 @@ void SelectorImpl::changed( Selectable& s )
 
 bool SelectorImpl::waitUntil(Timespan until)
 {
-    if (!_avail.empty())
+    // requests, which completed outside of the wait, are processed without
+    // blocking
+    if (!_avail.empty() || _completed > 0)
         until = Timespan(0);
 
     if (_isDirty)
     {
+        // the entries are assigned anew, so all armed polls are removed
+        for (std::size_t n = 0; n < _armed.size(); ++n)
+        {
+            if (_armed[n] != 0)
+            {
+                while (!_ring.pollRemove(_armed[n], 0))
+                    flushRing();
+            }
+        }
+
         _pollfds.clear();
 
         // recalculate size
-        size_t pollSize= 1;
+        size_t pollSize= 2;
 
         std::set<Selectable*>::iterator iter;
         for( iter= _devices.begin(); iter != _devices.end(); ++iter)
@@ -161,6 +219,8 @@ bool SelectorImpl::waitUntil(Timespan until)
         pfd.revents = 0;
 
         _pollfds.assign(pollSize, pfd);
+        _armed.assign(pollSize, 0);
+        _armedEvents.assign(pollSize, 0);
 
         // add entries
         pollfd* pCurr= &_pollfds[0];
@@ -171,6 +231,12 @@ bool SelectorImpl::waitUntil(Timespan until)
 
         ++pCurr;
 
+        // insert timer; poll ignores the entry when there is no timerfd
+        pCurr->fd = _timerFd;
+        pCurr->events = POLLIN;
+
+        ++pCurr;
+
         for( iter= _devices.begin(); iter != _devices.end(); ++iter)
         {
             if( (*iter)->enabled() )
@@ -185,59 +251,30 @@ bool SelectorImpl::waitUntil(Timespan until)
         _isDirty= false;
     }
 
-#ifdef HAVE_PPOLL
-    struct timespec pollTimeout = { 0, 0 };
-    struct timespec* pollTimeoutP = 0;
-    if (until >= Timespan(0))
-        pollTimeoutP = &pollTimeout;
-#else
-    int pollTimeout = until == Timespan(0) ? 0 : -1;
-#endif
-
-    int ret = -1;
-    while (true)
+    // With a timerfd the kernel signals the deadline through a descriptor,
+    // so poll blocks without timeout and nothing needs to be recalculated
+    // when it is interrupted.
+    bool timerFd = false;
+    if (_timerFd >= 0)
     {
         if (until > Timespan(0))
         {
-            Timespan remaining = until - Timespan::gettimeofday();
-            if (remaining < Timespan(0))
-                remaining = Timespan(0);
-
-#ifdef HAVE_PPOLL
-            pollTimeout.tv_sec = remaining.totalUSecs() / 1000000;
-            pollTimeout.tv_nsec = (remaining.totalUSecs() % 1000000) * 1000;
-#else
-            if (Milliseconds(remaining) >= std::numeric_limits<int>::max())
-                pollTimeout = std::numeric_limits<int>::max();
-            else
-                pollTimeout = Milliseconds(remaining).ceil();
-#endif
-
-            log_debug("remaining " << remaining);
+            armTimer(until);
+            timerFd = true;
+        }
+        else if (until < Timespan(0))
+        {
+            armTimer(Timespan(-1));
         }
-        else
-            log_debug("no timeout");
-
-#ifdef HAVE_PPOLL
-        log_debug("ppoll with " << _pollfds.size() << " fds, timeout=" << pollTimeout.tv_sec << "s " << pollTimeout.tv_nsec << "ns");
-        ret = ::ppoll(&_pollfds[0], _pollfds.size(), pollTimeoutP, 0);
-        log_debug("ppoll returns " << ret);
-#else
-        log_debug("poll with " << _pollfds.size() << " fds, timeout=" << pollTimeout << "ms");
-        ret = ::poll(&_pollfds[0], _pollfds.size(), pollTimeout);
-        log_debug("poll returns " << ret);
-#endif
-        if( ret != -1 )
-            break;
-
-        if( errno != EINTR )
-            throw IOError("Could not poll on file descriptors");
-
     }
 
-    if( ret == 0 && _avail.empty() )
+    int ret = _ring.isOpen() ? waitIoUring(until) : waitPoll(until, timerFd);
+
+    if( ret == 0 && _avail.empty() && _completed == 0 )
         return false;
 
+    _completed = 0;
+
     bool avail = false;
     try
     {
@@ -249,7 +286,11 @@ bool SelectorImpl::waitUntil(Timespan until)
                 throw IOError("poll error on event pipe");
             }
 
+#ifdef HAVE_SYS_EVENTFD_H
+            uint64_t buffer[1];
+#else
             static char buffer[1024];
+#endif
             while(true)
             {
                 int ret = ::read(_wakePipe[0], buffer, sizeof(buffer));
@@ -272,6 +313,22 @@ bool SelectorImpl::waitUntil(Timespan until)
             }
         }
 
+        if (_pollfds[1].revents != 0)
+        {
+            if ( _pollfds[1].revents & POLL_ERROR_MASK)
+            {
+                throw IOError("poll error on timer");
+            }
+
+            // the timer expired and is disarmed now; reading resets
+            // the expiration count
+            uint64_t expirations;
+            while (::read(_timerFd, &expirations, sizeof(expirations)) == -1 && errno == EINTR)
+                ;
+
+            _timerArmed = Timespan(-1);
+        }
+
         for( _current = _devices.begin(); _current != _devices.end(); )
         {
             Selectable* dev = *_current;
@@ -300,9 +357,296 @@ bool SelectorImpl::waitUntil(Timespan until)
 }
 
 
+int SelectorImpl::waitPoll(Timespan until, bool timerFd)
+{
+#ifdef HAVE_PPOLL
+    struct timespec pollTimeout = { 0, 0 };
+    struct timespec* pollTimeoutP = 0;
+    if (until >= Timespan(0) && !timerFd)
+        pollTimeoutP = &pollTimeout;
+#else
+    int pollTimeout = until == Timespan(0) ? 0 : -1;
+#endif
+
+    int ret = -1;
+    while (true)
+    {
+        if (until > Timespan(0) && !timerFd)
+        {
+            Timespan remaining = until - Timespan::gettimeofday();
+            if (remaining < Timespan(0))
+                remaining = Timespan(0);
+
+#ifdef HAVE_PPOLL
+            pollTimeout.tv_sec = remaining.totalUSecs() / 1000000;
+            pollTimeout.tv_nsec = (remaining.totalUSecs() % 1000000) * 1000;
+#else
+            if (Milliseconds(remaining) >= std::numeric_limits<int>::max())
+                pollTimeout = std::numeric_limits<int>::max();
+            else
+                pollTimeout = Milliseconds(remaining).ceil();
+#endif
+
+            log_debug("remaining " << remaining);
+        }
+        else
+            log_debug("no timeout");
+
+#ifdef HAVE_PPOLL
+        log_debug("ppoll with " << _pollfds.size() << " fds, timeout=" << pollTimeout.tv_sec << "s " << pollTimeout.tv_nsec << "ns");
+        ret = ::ppoll(&_pollfds[0], _pollfds.size(), pollTimeoutP, 0);
+        log_debug("ppoll returns " << ret);
+#else
+        log_debug("poll with " << _pollfds.size() << " fds, timeout=" << pollTimeout << "ms");
+        ret = ::poll(&_pollfds[0], _pollfds.size(), pollTimeout);
+        log_debug("poll returns " << ret);
+#endif
+        if( ret != -1 )
+            break;
+
+        if( errno != EINTR )
+            throw IOError("Could not poll on file descriptors");
+
+    }
+
+    return ret;
+}
+
+
+void SelectorImpl::queuePoll(std::size_t index, int fd, short events)
+{
+    if (_armed[index] != 0)
+    {
+        while (!_ring.pollRemove(_armed[index], 0))
+            flushRing();
+        _armed[index] = 0;
+    }
+
+    if (fd < 0)
+        return;
+
+    // user data 0 marks removals, so the sequence skips 0; the highest bit
+    // is left to requests
+    _armSeq = (_armSeq + 1) & 0x7fffffff;
+    if (_armSeq == 0)
+        ++_armSeq;
+
+    uint64_t userData = (static_cast<uint64_t>(_armSeq) << 32) | index;
+    while (!_ring.pollAdd(fd, events, userData))
+        flushRing();
+
+    _armed[index] = userData;
+    _armedEvents[index] = events;
+}
+
+
+void SelectorImpl::flushRing()
+{
+    while (!_ring.submit(0))
+        _ready += fetchCompletions();
+}
+
+
+unsigned SelectorImpl::fetchCompletions()
+{
+    unsigned count = 0;
+    uint64_t userData;
+    int res;
+    while (_ring.complete(userData, res))
+    {
+        if (userData & RequestTag)
+        {
+            IoRequest* request = reinterpret_cast<IoRequest*>(static_cast<uintptr_t>(userData & ~RequestTag));
+            request->pending = false;
+            request->done = true;
+            request->res = res;
+
+            // the device is checked for events with the next wait
+            if (!request->canceled)
+                ++_completed;
+
+            continue;
+        }
+
+        std::size_t index = static_cast<std::size_t>(userData & 0xffffffff);
+
+        // skip removals and polls, which were replaced in the meantime
+        if (userData == 0 || index >= _armed.size() || _armed[index] != userData)
+            continue;
+
+        // poll requests are one shot
+        _armed[index] = 0;
+
+        if (res == -ECANCELED)
+            continue;
+
+        if (_pollfds[index].revents == 0)
+            ++count;
+
+        _pollfds[index].revents |= res < 0 ? static_cast<short>(POLLNVAL) : static_cast<short>(res);
+    }
+
+    return count;
+}
+
+
+int SelectorImpl::waitIoUring(Timespan until)
+{
+    // Polls stay armed over iterations; only entries, which fired or
+    // changed, are submitted again. All of them go to the kernel in a
+    // single system call, which waits for completions as well.
+    _ready = 0;
+
+    for (std::size_t n = 0; n < _pollfds.size(); ++n)
+        _pollfds[n].revents = 0;
+
+    for (std::size_t n = 0; n < _pollfds.size(); ++n)
+    {
+        const pollfd& pfd = _pollfds[n];
+        if (_armed[n] == 0 ? pfd.fd >= 0 : _armedEvents[n] != pfd.events)
+            queuePoll(n, pfd.fd, pfd.events);
+    }
+
+    unsigned minComplete = _ready > 0 || _completed > 0 || until == Timespan(0) ? 0 : 1;
+    log_debug("io_uring wait for " << minComplete << " completions");
+
+    while (true)
+    {
+        while (!_ring.submit(minComplete))
+        {
+            if ((_ready += fetchCompletions()) > 0 || _completed > 0)
+                minComplete = 0;
+        }
+
+        _ready += fetchCompletions();
+
+        // completions of removed polls and canceled requests do not count
+        if (_ready > 0 || _completed > 0 || minComplete == 0)
+            break;
+    }
+
+    log_debug("io_uring returns " << _ready << " polls and " << _completed << " requests");
+
+    return static_cast<int>(_ready);
+}
+
+
+void SelectorImpl::beginRecv(IoRequest& request, int fd, char* buffer, std::size_t n)
+{
+    assert(!request.pending);
+
+    if (n > std::numeric_limits<unsigned>::max())
+        n = std::numeric_limits<unsigned>::max();
+
+    while (!_ring.recv(fd, buffer, static_cast<unsigned>(n), requestData(request)))
+        flushRing();
+
+    request.pending = true;
+    request.canceled = false;
+    request.done = false;
+}
+
+
+void SelectorImpl::cancel(IoRequest& request)
+{
+    if (!request.pending)
+        return;
+
+    request.canceled = true;
+
+    while (!_ring.cancel(requestData(request), 0))
+        flushRing();
+
+    // the buffer belongs to the kernel until the request completes
+    while (request.pending)
+    {
+        while (!_ring.submit(1))
+            _ready += fetchCompletions();
+
+        _ready += fetchCompletions();
+    }
+
+    request.canceled = false;
+
+    if (request.res == -ECANCELED || request.res == -EINTR)
+        request.done = false;
+}
+
+
+void SelectorImpl::ringChanged(bool sw)
+{
+    // the devices cancel their requests, before the ring goes away
+    SelectorImpl* selector = sw && _ring.canRecv() ? this : 0;
+    for (std::set<Selectable*>::iterator it = _devices.begin(); it != _devices.end(); ++it)
+    {
+        if ((*it)->simpl().useRing(selector))
+            ++_completed;
+    }
+}
+
+
+bool SelectorImpl::useIoUring(bool sw)
+{
+    if (sw == _ring.isOpen())
+        return sw;
+
+    _armed.clear();
+    _armedEvents.clear();
+    _isDirty = true;
+
+    if (!sw)
+    {
+        ringChanged(false);
+        _ring.close();
+        return false;
+    }
+
+    // deadlines are signaled through the timerfd
+    if (_timerFd < 0)
+        return false;
+
+    if (!_ring.open(RingEntries))
+        return false;
+
+    ringChanged(true);
+    return true;
+}
+
+
+void SelectorImpl::armTimer(Timespan until)
+{
+    // the deadline of the next timer rarely changes between iterations
+    if (until == _timerArmed)
+        return;
+
+#ifdef HAVE_SYS_TIMERFD_H
+    // A zero value disarms the timer. An absolute time in the past expires
+    // immediately.
+    struct itimerspec spec = { { 0, 0 }, { 0, 0 } };
+    if (until > Timespan(0))
+    {
+        spec.it_value.tv_sec = until.totalUSecs() / 1000000;
+        spec.it_value.tv_nsec = (until.totalUSecs() % 1000000) * 1000;
+    }
+
+    if (::timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &spec, 0) != 0)
+        throwSystemError("timerfd_settime");
+
+    log_debug("timer armed " << until);
+#endif
+
+    _timerArmed = until;
+}
+
+
 void SelectorImpl::wake()
 {
+#ifdef HAVE_SYS_EVENTFD_H
+    uint64_t one = 1;
+    ::write( _wakePipe[1], &one, sizeof(one));
+#else
     ::write( _wakePipe[1], "W", 1);
+#endif
 }
 
 } //namespace cxxtools
@@ -32,6 +32,7 @@
 #include <cxxtools/selectable.h>
 #include <cxxtools/timespan.h>
 #include <cxxtools/clock.h>
+#include "iouring.h"
 #include <sys/poll.h>
 #include <vector>
 #include <set>
@@ -55,14 +56,59 @@ class SelectorImpl
 
         void wake();
 
+        /// Waits with io_uring instead of poll; returns false if it is not available.
+        bool useIoUring(bool sw);
+
+        bool usesIoUring() const
+        { return _ring.isOpen(); }
+
+        /** Queues a recv into buffer, which is submitted with the next wait.
+
+            The buffer belongs to the kernel until the request completes or
+            is canceled.
+         */
+        void beginRecv(IoRequest& request, int fd, char* buffer, std::size_t n);
+
+        /** Cancels a pending request and waits, until the kernel releases
+            its buffer.
+
+            A request, which completed in the meantime, keeps its result.
+         */
+        void cancel(IoRequest& request);
+
     private:
+        enum { RingEntries = 256 };
+
+        void armTimer(Timespan until);
+
+        int waitPoll(Timespan until, bool timerFd);
+
+        int waitIoUring(Timespan until);
+
+        void queuePoll(std::size_t index, int fd, short events);
+
+        void flushRing();
+
+        unsigned fetchCompletions();
+
+        void ringChanged(bool sw);
+
         static const short POLL_ERROR_MASK;
         int _wakePipe[2];
+        int _timerFd;
+        Timespan _timerArmed;
         bool _isDirty;
         std::vector<pollfd> _pollfds;
         std::set<Selectable*>::iterator _current;
         std::set<Selectable*> _devices;
         std::set<Selectable*> _avail;
+
+        IoUring _ring;
+        std::vector<uint64_t> _armed;
+        std::vector<short> _armedEvents;
+        uint32_t _armSeq;
+        unsigned _ready;
+        unsigned _completed;
 };
 
 }//namespace xpr
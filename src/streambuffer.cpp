@@ -43,7 +43,8 @@ StreamBuffer::StreamBuffer(IODevice& ioDevice, size_t bufferSize, bool extend)
   _obufferSize(bufferSize),
   _obuffer(0),
   _pbmax(4),
-  _oextend(extend)
+  _oextend(extend),
+  _omark(0)
 {
     setg(0, 0, 0);
     setp(0, 0);
@@ -59,7 +60,8 @@ StreamBuffer::StreamBuffer(size_t bufferSize, bool extend)
   _obufferSize(bufferSize),
   _obuffer(0),
   _pbmax(4),
-  _oextend(extend)
+  _oextend(extend),
+  _omark(0)
 {
     setg(0, 0, 0);
     setp(0, 0);
@@ -203,6 +205,12 @@ size_t StreamBuffer::beginWrite()
         return 0;
     }
 
+    if (!_ochunks.empty())
+    {
+        const OChunk& c = _ochunks.front();
+        return _ioDevice->beginWrite(c.begin(_obuffer), c.size);
+    }
+
     if (pptr())
     {
         size_t avail = pptr() - pbase();
@@ -226,6 +234,120 @@ void StreamBuffer::discard()
 
     if (pptr())
         setp(_obuffer, _obuffer + _obufferSize);
+
+    _ochunks.clear();
+    _omark = 0;
+}
+
+
+void StreamBuffer::writeRef(const char* data, size_t size)
+{
+    if (size == 0)
+        return;
+
+    if (!_obuffer)
+    {
+        _obuffer = new char[_obufferSize];
+        setp(_obuffer, _obuffer + _obufferSize);
+    }
+
+    chunkTail();
+
+    OChunk c;
+    c.data = data;
+    c.offset = 0;
+    c.size = size;
+    _ochunks.push_back(c);
+}
+
+
+std::streamsize StreamBuffer::out_avail()
+{
+    std::streamsize avail = BasicStreamBuffer<char>::out_avail() - _omark;
+    for (std::vector<OChunk>::const_iterator it = _ochunks.begin(); it != _ochunks.end(); ++it)
+        avail += it->size;
+    return avail;
+}
+
+
+void StreamBuffer::chunkTail()
+{
+    size_t end = pptr() - _obuffer;
+    if (end > _omark)
+    {
+        OChunk c;
+        c.data = 0;
+        c.offset = _omark;
+        c.size = end - _omark;
+        _ochunks.push_back(c);
+        _omark = end;
+    }
+}
+
+
+void StreamBuffer::consumeChunks(size_t n)
+{
+    std::vector<OChunk>::iterator it = _ochunks.begin();
+    for ( ; it != _ochunks.end() && n >= it->size; ++it)
+        n -= it->size;
+
+    if (it != _ochunks.end())
+    {
+        if (it->data)
+            it->data += n;
+        else
+            it->offset += n;
+        it->size -= n;
+    }
+    else
+    {
+        // the rest was taken from the tail of the output buffer
+        _omark += n;
+    }
+
+    _ochunks.erase(_ochunks.begin(), it);
+
+    if (_ochunks.empty())
+    {
+        // move the unqueued content to the start of the output buffer
+        size_t leftover = pptr() - _obuffer - _omark;
+        if (leftover > 0)
+            traits_type::move(_obuffer, _obuffer + _omark, leftover);
+
+        setp(_obuffer, _obuffer + _obufferSize);
+        pbump(leftover);
+        _omark = 0;
+    }
+}
+
+
+void StreamBuffer::flushChunks()
+{
+    log_debug("flush " << _ochunks.size() << " chunks");
+
+    if (_ioDevice->writing())
+        endWrite();
+
+    while (!_ochunks.empty())
+    {
+        IOVec vec[16];
+        size_t count = 0;
+        for ( ; count < _ochunks.size() && count < 16; ++count)
+        {
+            vec[count].data = _ochunks[count].begin(_obuffer);
+            vec[count].size = _ochunks[count].size;
+        }
+
+        size_t end = pptr() - _obuffer;
+        if (count < 16 && end > _omark)
+        {
+            vec[count].data = _obuffer + _omark;
+            vec[count].size = end - _omark;
+            ++count;
+        }
+
+        consumeChunks(_ioDevice->writev(vec, count));
+    }
 }
 
 
@@ -242,6 +364,14 @@ size_t StreamBuffer::endWrite()
     size_t leftover = 0;
     size_t written = 0;
 
+    if (!_ochunks.empty())
+    {
+        written = _ioDevice->endWrite();
+        log_debug(written << " bytes of " << _ochunks.front().size << " bytes chunk written");
+        consumeChunks(written);
+        return written;
+    }
+
     if (pptr())
     {
         size_t avail = pptr() - pbase();
@@ -271,11 +401,21 @@ StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
     if (!_ioDevice)
         return traits_type::eof();
 
+    if (!_ochunks.empty() && !_oextend)
+    {
+        // referenced data is written before the buffer may be reused
+        flushChunks();
+    }
+
     if (!_obuffer)
     {
         _obuffer = new char[_obufferSize];
         setp(_obuffer, _obuffer + _obufferSize);
     }
+    else if (pptr() < epptr() && !traits_type::eq_int_type( ch, traits_type::eof() ))
+    {
+        // flushChunks made room
+    }
     else if (_oextend && !traits_type::eq_int_type( ch, traits_type::eof() ))
     {
         // break asyncronous I/O if any active
@@ -328,7 +468,7 @@ StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
         log_debug("finish writing");
         endWrite();
     }
-    else
+    else if (pptr() > pbase())
     {
         // normal blocking overflow case
         log_debug("blocking overflow");
@@ -369,6 +509,12 @@ int StreamBuffer::sync()
     if (! _ioDevice)
         return 0;
 
+    if (!_ochunks.empty())
+    {
+        flushChunks();
+        _ioDevice->sync();
+    }
+
     if (pptr())
     {
         while (pptr() > pbase())
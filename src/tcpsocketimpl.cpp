@@ -902,6 +902,66 @@ size_t TcpSocketImpl::write(const char* buffer, size_t n)
     return static_cast<size_t>(ret);
 }
 
+size_t TcpSocketImpl::writev(const IOVec* vec, size_t count)
+{
+#if defined(HAVE_MSG_NOSIGNAL)
+    if (_state == CONNECTED)
+    {
+        iovec iov[IOVMAX];
+        if (count > IOVMAX)
+            count = IOVMAX;
+
+        for (size_t n = 0; n < count; ++n)
+        {
+            iov[n].iov_base = const_cast<char*>(vec[n].data);
+            iov[n].iov_len = vec[n].size;
+        }
+
+        msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        while (true)
+        {
+            log_debug("::sendmsg(" << _fd << ", msg, MSG_NOSIGNAL) with " << count << " buffers");
+
+            ssize_t ret = ::sendmsg(_fd, &msg, MSG_NOSIGNAL);
+            int e = errno;
+            log_debug("sendmsg returned " << ret);
+            if (ret > 0)
+                return static_cast<size_t>(ret);
+
+            if (ret == 0 || e == ECONNRESET || e == EPIPE)
+                throw IOError("lost connection to peer");
+
+            if (e == EINTR)
+                continue;
+
+            if (e != EAGAIN)
+                throw IOError(getErrnoString("sendmsg"));
+
+            pollfd pfd;
+            pfd.fd = _fd;
+            pfd.revents = 0;
+            pfd.events = POLLOUT;
+
+            if (!wait(_timeout, pfd))
+                throw IOTimeout();
+        }
+    }
+#endif
+
+    // without MSG_NOSIGNAL and for ssl we write the buffers one by one
+    for (size_t n = 0; n < count; ++n)
+    {
+        if (vec[n].size > 0)
+            return write(vec[n].data, vec[n].size);
+    }
+
+    return 0;
+}
+
 void TcpSocketImpl::inputReady()
 {
     log_trace("inputReady; state=" << static_cast<int>(_state));
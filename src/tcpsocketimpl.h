@@ -172,9 +172,16 @@ class TcpSocketImpl : public IODeviceImpl
         // override write to use send(2) instead of write(2)
         virtual size_t write(const char* buffer, size_t count);
 
+        // override writev to use sendmsg(2) instead of writev(2)
+        virtual size_t writev(const IOVec* vec, size_t count);
+
         // override for ssl
         virtual size_t read(char* buffer, size_t count, bool& eof);
 
+        // ssl connections and connects are handled with polling
+        virtual bool canRecvByRing() const
+        { return _state == CONNECTED; }
+
         // override for ssl
         virtual void inputReady();
 
@@ -65,15 +65,80 @@ namespace cxxtools
         _stateChanged.broadcast();
     }
 
+    namespace
+    {
+        // the pool and worker index of the current thread
+        __thread ThreadPoolImpl* currentPool = 0;
+        __thread unsigned currentWorker = 0;
+    }
+
+    bool ThreadPoolImpl::WorkDeque::push(ThreadPool::Future::FutureImpl* task)
+    {
+        atomic_t b = _bottom;
+        atomic_t t = atomicGet(_top);
+        if (b - t >= Capacity)
+            return false;
+
+        _tasks[b & (Capacity - 1)] = task;
+        atomicSet(_bottom, b + 1);
+        return true;
+    }
+
+    ThreadPool::Future::FutureImpl* ThreadPoolImpl::WorkDeque::pop()
+    {
+        atomic_t b = _bottom - 1;
+        atomicSet(_bottom, b);
+        atomic_t t = atomicGet(_top);
+
+        if (t > b)
+        {
+            // empty
+            atomicSet(_bottom, b + 1);
+            return 0;
+        }
+
+        void* task = _tasks[b & (Capacity - 1)];
+        if (t == b)
+        {
+            // last element - race against thieves
+            if (atomicCompareExchange(_top, t + 1, t) != t)
+                task = 0;
+            atomicSet(_bottom, b + 1);
+        }
+
+        return static_cast<ThreadPool::Future::FutureImpl*>(task);
+    }
+
+    ThreadPool::Future::FutureImpl* ThreadPoolImpl::WorkDeque::steal()
+    {
+        atomic_t t = atomicGet(_top);
+        atomic_t b = atomicGet(_bottom);
+        if (t >= b)
+            return 0;
+
+        void* task = _tasks[t & (Capacity - 1)];
+        if (atomicCompareExchange(_top, t + 1, t) != t)
+            return 0;
+
+        return static_cast<ThreadPool::Future::FutureImpl*>(task);
+    }
+
     ThreadPoolImpl::~ThreadPoolImpl()
     {
         log_debug("delete " << _threads.size() << " threads");
         for (ThreadsType::iterator it = _threads.begin(); it != _threads.end(); ++it)
             delete *it;
 
-        log_debug("delete " << _queue.size() << " left tasks");
-        while (!_queue.empty())
-            _queue.get()._impl->setCanceled();
+        log_debug("delete " << _injectQueue.size() << " left tasks");
+        for (std::deque<ThreadPool::Future::FutureImpl*>::iterator it = _injectQueue.begin(); it != _injectQueue.end(); ++it)
+        {
+            (*it)->setCanceled();
+            if ((*it)->release() == 0)
+                delete *it;
+        }
+
+        for (std::vector<WorkDeque*>::iterator it = _deques.begin(); it != _deques.end(); ++it)
+            delete *it;
     }
 
     void ThreadPoolImpl::start()
@@ -83,6 +148,13 @@ namespace cxxtools
 
         _state = Starting;
 
+        atomicSet(_stop, 0);
+        atomicSet(_cancel, 0);
+        atomicSet(_nextWorker, 0);
+
+        while (_deques.size() < _size)
+            _deques.push_back(new WorkDeque());
+
         while (_threads.size() < _size)
             _threads.push_back(new AttachedThread(callable(*this, &ThreadPoolImpl::threadFunc)));
 
@@ -103,16 +175,17 @@ namespace cxxtools
         log_debug("stop " << _threads.size() << " threads");
         _state = Stopping;
 
+        // with cancel the workers cancel all tasks they still find
         if (cancel)
+            atomicSet(_cancel, 1);
+
+        atomicSet(_stop, 1);
+
         {
-            std::pair<ThreadPool::Future, bool> p;
-            while ((p = _queue.tryGet()).second)
-                p.first._impl->setCanceled();
+            MutexLock lock(_parkMutex);
+            _parkCondition.broadcast();
         }
 
-        for (ThreadsType::iterator it = _threads.begin(); it != _threads.end(); ++it)
-            _queue.put(0);
-
         for (ThreadsType::iterator it = _threads.begin(); it != _threads.end(); ++it)
         {
             (*it)->join();
@@ -122,40 +195,170 @@ namespace cxxtools
 
         _threads.clear();
 
+        for (std::vector<WorkDeque*>::iterator it = _deques.begin(); it != _deques.end(); ++it)
+            delete *it;
+
+        _deques.clear();
+
         _state = Stopped;
     }
 
     ThreadPool::Future ThreadPoolImpl::schedule(const Callable<void>& cb)
     {
         ThreadPool::Future future(new ThreadPool::Future::FutureImpl(cb));
+        future._impl->addRef();
 
         log_debug("queue new task " << static_cast<void*>(future._impl->_callable));
-        _queue.put(future);
-        log_debug("queue size " << _queue.size());
+
+        // tasks scheduled by a worker of this pool go to its own deque
+        if (currentPool == this && _deques[currentWorker]->push(future._impl))
+            wakeup();
+        else
+            inject(future._impl);
 
         return future;
     }
 
-    void ThreadPoolImpl::threadFunc()
+    void ThreadPoolImpl::inject(ThreadPool::Future::FutureImpl* task)
     {
-        ThreadPool::Future future;
-        while ((future = _queue.get()), future._impl != 0)
         {
-            log_debug("new task " << static_cast<void*>(future._impl->_callable) << " received " << _queue.size() << " tasks left");
+            MutexLock lock(_injectMutex);
+            _injectQueue.push_back(task);
+            atomicIncrement(_injected);
+        }
+
+        wakeup();
+    }
+
+    void ThreadPoolImpl::wakeup()
+    {
+        // atomicGet is a full barrier, so either we see the idle worker
+        // here or the worker sees the new task before it parks
+        if (atomicGet(_idle) > atomicGet(_signaled))
+        {
+            // do not signal again, while a woken worker did not run yet
+            MutexLock lock(_parkMutex);
+            if (_idle > _signaled)
+            {
+                atomicIncrement(_signaled);
+                _parkCondition.signal();
+            }
+        }
+    }
+
+    ThreadPool::Future::FutureImpl* ThreadPoolImpl::takeInjected(WorkDeque& deque)
+    {
+        if (atomicGet(_injected) == 0)
+            return 0;
+
+        MutexLock lock(_injectMutex);
+        if (_injectQueue.empty())
+            return 0;
+
+        ThreadPool::Future::FutureImpl* task = _injectQueue.front();
+        _injectQueue.pop_front();
+
+        // take a share of the queue to the own deque, where other workers
+        // may steal it
+        unsigned count = _injectQueue.size() / _size;
+        while (count-- > 0 && deque.push(_injectQueue.front()))
+            _injectQueue.pop_front();
+
+        atomicSet(_injected, _injectQueue.size());
+
+        return task;
+    }
+
+    ThreadPool::Future::FutureImpl* ThreadPoolImpl::findTask(unsigned self)
+    {
+        WorkDeque& deque = *_deques[self];
+
+        ThreadPool::Future::FutureImpl* task = deque.pop();
+        if (task)
+            return task;
+
+        task = takeInjected(deque);
+        if (task)
+            return task;
+
+        for (unsigned n = 1; n < _deques.size(); ++n)
+        {
+            task = _deques[(self + n) % _deques.size()]->steal();
+            if (task)
+                return task;
+        }
+
+        return 0;
+    }
+
+    bool ThreadPoolImpl::hasTask()
+    {
+        if (atomicGet(_injected) > 0)
+            return true;
+
+        for (std::vector<WorkDeque*>::iterator it = _deques.begin(); it != _deques.end(); ++it)
+            if (!(*it)->empty())
+                return true;
+
+        return false;
+    }
+
+    void ThreadPoolImpl::run(ThreadPool::Future::FutureImpl* task)
+    {
+        if (atomicGet(_cancel))
+        {
+            task->setCanceled();
+        }
+        else
+        {
+            log_debug("new task " << static_cast<void*>(task->_callable) << " received");
 
             try
             {
-                (*future._impl->_callable)();
-                future._impl->setFinished();
+                (*task->_callable)();
+                task->setFinished();
             }
             catch (...)
             {
-                future._impl->setFailed();
+                task->setFailed();
+            }
+
+            log_debug("task " << static_cast<void*>(task->_callable) << " finished");
+        }
+
+        if (task->release() == 0)
+            delete task;
+    }
+
+    void ThreadPoolImpl::threadFunc()
+    {
+        unsigned self = atomicIncrement(_nextWorker) - 1;
+        currentPool = this;
+        currentWorker = self;
+
+        while (true)
+        {
+            ThreadPool::Future::FutureImpl* task = findTask(self);
+            if (task)
+            {
+                run(task);
+                continue;
             }
 
-            log_debug("task " << static_cast<void*>(future._impl->_callable) << " finished");
+            if (atomicGet(_stop))
+                break;
+
+            MutexLock lock(_parkMutex);
+            atomicIncrement(_idle);
+            if (!hasTask() && !atomicGet(_stop))
+                _parkCondition.wait(lock);
+            atomicDecrement(_idle);
+            if (_signaled > 0)
+                atomicDecrement(_signaled);
         }
 
+        currentPool = 0;
+
         log_debug("end thread");
     }
 
@@ -29,9 +29,13 @@
 #ifndef CXXTOOLS_THREADPOOLIMPL_H
 #define CXXTOOLS_THREADPOOLIMPL_H
 
-#include <cxxtools/queue.h>
 #include <cxxtools/threadpool.h>
 #include <cxxtools/refcounted.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/atomicity.h>
+#include <deque>
 #include <vector>
 
 namespace cxxtools
@@ -91,7 +95,13 @@ namespace cxxtools
         public:
             explicit ThreadPoolImpl(unsigned size)
                 : _state(Stopped),
-                  _size(size)
+                  _size(size),
+                  _injected(0),
+                  _idle(0),
+                  _signaled(0),
+                  _nextWorker(0),
+                  _stop(0),
+                  _cancel(0)
                   { }
 
             ~ThreadPoolImpl();
@@ -109,8 +119,47 @@ namespace cxxtools
             { return _state == Stopped; }
 
         private:
+            /**
+                Chase-Lev work stealing deque with fixed capacity.
+
+                The owning worker pushes and pops at the bottom, other workers steal
+                from the top. Only the owner may call push and pop.
+             */
+            class WorkDeque
+            {
+                public:
+                    static const atomic_t Capacity = 4096;
+
+                    WorkDeque()
+                        : _top(0),
+                          _bottom(0)
+                          { }
+
+                    /// Returns false, when the deque is full.
+                    bool push(ThreadPool::Future::FutureImpl* task);
+
+                    ThreadPool::Future::FutureImpl* pop();
+
+                    ThreadPool::Future::FutureImpl* steal();
+
+                    bool empty()
+                    { return atomicGet(_bottom) <= atomicGet(_top); }
+
+                private:
+                    volatile atomic_t _top;
+                    volatile atomic_t _bottom;
+                    void* volatile _tasks[Capacity];
+            };
+
             void threadFunc();
 
+            void inject(ThreadPool::Future::FutureImpl* task);
+            ThreadPool::Future::FutureImpl* takeInjected(WorkDeque& deque);
+            ThreadPool::Future::FutureImpl* findTask(unsigned self);
+            bool hasTask();
+            void wakeup();
+            void run(ThreadPool::Future::FutureImpl* task);
+
             enum {
                 Stopped,
                 Starting,
@@ -118,10 +167,25 @@ namespace cxxtools
                 Stopping
             } _state;
 
-            Queue<ThreadPool::Future> _queue;
             typedef std::vector<AttachedThread*> ThreadsType;
             ThreadsType _threads;
+            std::vector<WorkDeque*> _deques;
             unsigned _size;
+
+            // tasks scheduled from outside of the pool
+            Mutex _injectMutex;
+            std::deque<ThreadPool::Future::FutureImpl*> _injectQueue;
+            volatile atomic_t _injected;
+
+            // idle workers wait here for new tasks
+            Mutex _parkMutex;
+            Condition _parkCondition;
+            volatile atomic_t _idle;
+            volatile atomic_t _signaled;
+
+            volatile atomic_t _nextWorker;
+            volatile atomic_t _stop;
+            volatile atomic_t _cancel;
     };
 
 }
@@ -305,12 +305,75 @@ namespace
     { L"gt", 0x003E }
   };
 
-  void printEntity(std::basic_ostream<Char>& os, const wchar_t* p)
+  // Perfect hash over the names in ent[]. The hash with seed 0 selects one
+  // of 64 buckets and the hash with the seed of that bucket selects a slot,
+  // which holds the index + 1 of the entity in ent[] or 0 when it is free.
+  // The seeds were searched offline with utils/entityhash.pl, so that no
+  // two names share a slot. Run it again and replace the tables, when ent[]
+  // is changed.
+  static const unsigned char entitySeed[64] = {
+      1,   2,   4,   2,   5,   9,   1,   3,   1,   6,   2,   1,   4,   4,   5,   1,
+      1,   4,   2,   4,   2,   1,   3,   3,   1,   2,   1,   4,   2,   1,   2,   1,
+      6,   1,   3,   4,   6,   3,   2,   1,   1,   2,   7,   1,   1,   2,   1,   1,
+      6,   7,   3,   3,   2,  11,   6,   2,   6,   0,   1,  23,   7,   3,   3,   2
+  };
+
+  static const unsigned char entitySlot[512] = {
+    106,  75, 143,   0,   0,   0, 150,   0,   0,  15,   0,   0, 166, 179, 191,  24,
+    114,  30,   0,   0,  81,   0,   0,  67, 186,  84,  13,   0,  90, 162,   0, 119,
+    147,   0,   0,   1, 187, 146, 215,   0, 178,  82,   0,   0,   0,  39, 172,   0,
+    221, 174,  10,  89,   0,   0,   0,   0, 130, 214,   0, 157,   7, 206, 200,   0,
+      0,   0,   0, 203,  74,   0,   0, 210, 197,   0, 213,   0,   0, 134, 108, 243,
+    251, 126,   0,  14,  41,   0,   0,  11,   4,   0,   0, 144, 233,   0, 208,  53,
+      0,  83, 100,   0,   0,   0,   0, 237,  50,   0, 112,  20, 104,  33, 163, 156,
+      0,   0,   0, 158,   0,   0, 102, 226,  78, 175, 181, 113, 155,   0,   0, 229,
+      0,  69,   0,   0, 121,   0,   0,   0, 168,   0,   0, 231, 176,   0,  40,   0,
+      0,   0,   0,   0,   0,  21, 120, 140, 164,   0,   0, 189,  43,   0, 171, 148,
+    201,  62,  77,  61, 139, 124,  22,  86, 128,   0,   0,   0, 244,   0, 107,   0,
+      0, 105,  96,   0,  31,   0,   0,  35,  64,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,  76,   0,   0, 207,   0, 180,   0, 240, 182,   0,  26,
+      0, 196, 125,  91,   0, 159,   0,   0,   0,   0, 209,   0,   0,  38,   0,  16,
+     27, 236,   0, 131, 132,  72,   0,   0,   0, 222,  46,   3,   0, 152,  58,  37,
+      0, 185,   0,   0, 167,   0, 127,   0,  97,   0,   0,   0,   0,  52,   0, 110,
+    118,   0,   0,  54,  23,  19,   0, 199,   5,   0,   0,   0,   0,   0, 227,  60,
+      0, 242, 177, 184,   0,   0, 248, 170,  29,  25, 122,  79, 115, 141,  34,   0,
+     98, 220,   0,   0,   0,  56,   0,   0,  92,  68,   0, 234,  28,   0,   0, 133,
+     66,   0,   0,   0,   0, 235,   8, 219,  17, 218, 137, 225,   0,   0, 188,   0,
+     87,   0,   0,   0,   2,  99, 109, 205, 238,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   9,   0,   0,   0,   0,   0,   0,   0,   0, 116,
+      0,   0,  18,   0,   0,   0, 202,  65,   0,   0, 223,  48,   0, 101,   0,  12,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  80,   0,  88,  63,   0,   0,
+      0,   0, 247,   0,   6,   0, 138,   0, 117,  57,  95,   0,   0,   0,   0, 224,
+      0,   0,  93, 111,   0,   0,   0,   0, 136, 194,   0,  70,   0, 173,  42, 165,
+      0,   0, 239, 183,  59, 193,   0, 123,   0, 135, 246,   0,  55,   0,   0, 149,
+     73,   0,   0,   0, 212,   0, 151,   0,   0,   0,   0,  94,   0,   0, 192,  32,
+      0,   0,   0,  44, 216,   0,   0,   0, 160,  36,   0, 145, 153,   0, 161,   0,
+      0,   0,   0,   0,   0,  71,   0,   0, 250,   0, 204,   0,  45,  85, 241,   0,
+      0, 142, 169,   0,   0, 245, 217, 228,  51, 211, 103, 195,   0,   0, 190, 129,
+      0, 154,   0,   0,   0, 249,   0,   0,   0, 198,  49, 230,   0,   0,  47, 232
+  };
+
+  uint32_t entityHash(const String& name, uint32_t seed)
+  {
+      // FNV-1a
+      uint32_t h = 2166136261u ^ seed;
+      for (String::const_iterator it = name.begin(); it != name.end(); ++it)
+      {
+          h ^= static_cast<uint32_t>(it->value());
+          h *= 16777619u;
+      }
+
+      return h;
+  }
+
+  const Ent* findEntity(const String& name)
   {
-      os << Char('&');
-      while (*p)
-          os << Char(*p++);
-      os << Char(';');
+      unsigned bucket = entityHash(name, 0) % sizeof(entitySeed);
+      unsigned slot = entitySlot[entityHash(name, entitySeed[bucket]) % sizeof(entitySlot)];
+      if (slot != 0 && name.compare(ent[slot - 1].entity) == 0)
+          return &ent[slot - 1];
+
+      return 0;
   }
 
   const Ent* findEntity(Char ch)
@@ -320,6 +383,52 @@ namespace
               return &rent[n];
       return 0;
   }
+
+  // Output of the characters 0 to 255 in xml text. A length of 0 marks
+  // characters, which are written as they are.
+  struct EscapeTable
+  {
+      Char text[256][8];
+      char bytes[256][8];
+      unsigned char length[256];
+
+      EscapeTable();
+  };
+
+  EscapeTable::EscapeTable()
+  {
+      for (unsigned ch = 0; ch < 256; ++ch)
+      {
+          std::string s;
+          const Ent* e = findEntity(Char(ch));
+          if (e)
+          {
+              s = '&';
+              for (const wchar_t* p = e->entity; *p; ++p)
+                  s += static_cast<char>(*p);
+              s += ';';
+          }
+          else if (ch < ' ' || ch > 0x7F)
+          {
+              s = "&#" + convert<std::string>(ch) + ';';
+          }
+
+          for (unsigned n = 0; n < s.size(); ++n)
+          {
+              text[ch][n] = Char(s[n]);
+              bytes[ch][n] = s[n];
+          }
+          length[ch] = s.size();
+      }
+  }
+
+  // built on first use, so that no dynamic initialization at load time
+  // is needed
+  const EscapeTable& escapeTable()
+  {
+      static const EscapeTable table;
+      return table;
+  }
 }
 
 
@@ -358,25 +467,9 @@ String EntityResolver::resolveEntity(const String& entity) const
         return String( 1, Char(code) );
     }
 
-    unsigned u = 0;
-    unsigned o = sizeof(ent)/sizeof(Ent) - 1;
-    while (o - u > 1)
-    {
-        unsigned m = (o + u) / 2;
-        int c = entity.compare(ent[m].entity);
-        if (c == 0)
-            return String(1, Char(ent[m].charValue));
-        else if (c < 0)
-            o = m;
-        else
-            u = m;
-    }
-
-    if (entity.compare(ent[u].entity) == 0)
-        return String(1, Char(ent[u].charValue));
-
-    if (entity.compare(ent[o].entity) == 0)
-        return String(1, Char(ent[o].charValue));
+    const Ent* e = findEntity(entity);
+    if (e)
+        return String(1, Char(e->charValue));
 
     EntityMap::const_iterator it = _entityMap.find(entity);
     if( it == _entityMap.end() )
@@ -416,14 +509,76 @@ String EntityResolver::getEntity(Char ch) const
 
 void EntityResolver::getEntity(std::basic_ostream<Char>& os, Char ch) const
 {
-    const Ent* e = findEntity(ch);
+    uint32_t v = ch.value();
 
-    if (e)
-        printEntity(os, e->entity);
-    else if (ch.value() >= ' ' && ch.value() <= 0x7F)
-        os << ch;
+    if (v < 256)
+    {
+        const EscapeTable& table = escapeTable();
+        if (table.length[v])
+            os.write(table.text[v], table.length[v]);
+        else
+            os << ch;
+    }
     else
-        os << Char('&') << Char('#') << static_cast<uint32_t>(ch.value()) << Char(';');
+        os << Char('&') << Char('#') << v << Char(';');
+}
+
+
+void EntityResolver::getEntities(std::basic_ostream<Char>& os, const String& text) const
+{
+    const Char* p = text.data();
+    const Char* e = p + text.size();
+    const Char* begin = p;
+    const EscapeTable& table = escapeTable();
+
+    for ( ; p != e; ++p)
+    {
+        uint32_t v = p->value();
+        if (v < 256 && table.length[v] == 0)
+            continue;
+
+        // write characters, which need no escaping, in one go
+        if (begin != p)
+            os.write(begin, p - begin);
+
+        getEntity(os, *p);
+        begin = p + 1;
+    }
+
+    if (begin != e)
+        os.write(begin, e - begin);
+}
+
+
+void EntityResolver::getEntities(std::string& out, const String& text) const
+{
+    const EscapeTable& table = escapeTable();
+
+    for (String::const_iterator it = text.begin(); it != text.end(); ++it)
+    {
+        uint32_t v = it->value();
+        if (v < 256)
+        {
+            if (table.length[v] == 0)
+                out += static_cast<char>(v);
+            else
+                out.append(table.bytes[v], table.length[v]);
+        }
+        else
+        {
+            char buffer[16];
+            char* p = buffer + sizeof(buffer);
+            *--p = ';';
+            do
+            {
+                *--p = static_cast<char>('0' + v % 10);
+                v /= 10;
+            } while (v);
+            *--p = '#';
+            *--p = '&';
+            out.append(p, buffer + sizeof(buffer) - p);
+        }
+    }
 }
 
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "nametable.h"
+
+namespace cxxtools
+{
+namespace xml
+{
+
+NameTable::NameTable()
+    : _slots(64)
+{
+}
+
+unsigned NameTable::hash(const String& name)
+{
+    // FNV-1a
+    unsigned h = 2166136261u;
+    for (String::const_iterator it = name.begin(); it != name.end(); ++it)
+    {
+        h ^= static_cast<unsigned>(it->value());
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+unsigned NameTable::find(const String& name) const
+{
+    std::size_t mask = _slots.size() - 1;
+    for (std::size_t n = hash(name) & mask; _slots[n] != 0; n = (n + 1) & mask)
+    {
+        if (_names[_slots[n] - 1] == name)
+            return _slots[n];
+    }
+
+    return 0;
+}
+
+unsigned NameTable::intern(const String& name)
+{
+    std::size_t mask = _slots.size() - 1;
+    std::size_t n = hash(name) & mask;
+    for ( ; _slots[n] != 0; n = (n + 1) & mask)
+    {
+        if (_names[_slots[n] - 1] == name)
+            return _slots[n];
+    }
+
+    if (_names.size() >= maxNames)
+        return 0;
+
+    _names.push_back(name);
+    _slots[n] = _names.size();
+
+    if (_names.size() * 2 > _slots.size())
+        rehash(_slots.size() * 2);
+
+    return _names.size();
+}
+
+void NameTable::rehash(std::size_t slots)
+{
+    std::vector<unsigned> newSlots(slots);
+    std::size_t mask = slots - 1;
+
+    for (unsigned id = 1; id <= _names.size(); ++id)
+    {
+        std::size_t n = hash(_names[id - 1]) & mask;
+        while (newSlots[n] != 0)
+            n = (n + 1) & mask;
+        newSlots[n] = id;
+    }
+
+    _slots.swap(newSlots);
+}
+
+}
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef CXXTOOLS_XML_NAMETABLE_H
+#define CXXTOOLS_XML_NAMETABLE_H
+
+#include <cxxtools/string.h>
+#include <vector>
+
+namespace cxxtools
+{
+namespace xml
+{
+
+/**
+ Interns element and attribute names of a XmlReader to small integer ids.
+
+ Ids start at 1 and stay valid for the lifetime of the table, so that
+ names may be compared by id. The id 0 is used for names, which are not
+ interned. This happens when the table is full, so that documents with
+ arbitrary many different names do not let the table grow without limit.
+ */
+class NameTable
+{
+    public:
+        static const unsigned maxNames = 4096;
+
+        NameTable();
+
+        /// Returns the id of the name and adds it, when it is unknown.
+        unsigned intern(const String& name);
+
+        /// Returns the id of the name or 0, when it is unknown.
+        unsigned find(const String& name) const;
+
+        /// Returns the name with the given id.
+        const String& name(unsigned id) const
+        { return _names[id - 1]; }
+
+        unsigned size() const
+        { return _names.size(); }
+
+    private:
+        static unsigned hash(const String& name);
+        void rehash(std::size_t slots);
+
+        std::vector<String> _names;
+        std::vector<unsigned> _slots;  // open addressing; 0 marks a free slot
+};
+
+}
+}
+
+#endif // CXXTOOLS_XML_NAMETABLE_H
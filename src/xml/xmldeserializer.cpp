@@ -60,11 +60,35 @@ namespace {
 
         return out;
     }
+
+    const String typeAttribute(L"type");
+    const String categoryAttribute(L"category");
+
+    // Looks up an attribute by the id of its name. Names, which are not
+    // interned, are compared as strings.
+    const String& attributeValue(const StartElement& se, unsigned id, const String& name)
+    {
+        static const String null;
+
+        const Attributes& attributes = se.attributes();
+        for (Attributes::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+        {
+            if (id != 0 && it->nameId() != 0 ? it->nameId() == id : it->name() == name)
+                return it->value();
+        }
+
+        return null;
+    }
 }
 
 XmlDeserializer::XmlDeserializer(XmlReader& reader, bool readAttributes, const String& attributePrefix)
   : _readAttributes(readAttributes),
-    _attributePrefix(attributePrefix)
+    _nodeNameId(0),
+    _typeId(0),
+    _categoryId(0),
+    _attributePrefix(attributePrefix),
+    _reader(0),
+    _matchDepth(0)
 {
     parse(reader);
 }
@@ -72,7 +96,12 @@ XmlDeserializer::XmlDeserializer(XmlReader& reader, bool readAttributes, const S
 
 XmlDeserializer::XmlDeserializer(std::istream& is, bool readAttributes, const String& attributePrefix)
   : _readAttributes(readAttributes),
-    _attributePrefix(attributePrefix)
+    _nodeNameId(0),
+    _typeId(0),
+    _categoryId(0),
+    _attributePrefix(attributePrefix),
+    _reader(0),
+    _matchDepth(0)
 {
     parse(is);
 }
@@ -95,10 +124,99 @@ void XmlDeserializer::parse(std::basic_istream<Char>& is)
 void XmlDeserializer::parse(XmlReader& reader)
 {
     begin();
+    setReader(reader);
 
     if(reader.get().type() != Node::StartElement)
         reader.nextElement();
 
+    parseElement(reader);
+}
+
+
+bool XmlDeserializer::parseNext(XmlReader& reader, const String& path)
+{
+    if (&reader != _reader)
+    {
+        // name ids of the path are looked up in the new reader
+        setReader(reader);
+        _path.clear();
+        _pathNames.clear();
+        _matchDepth = 0;
+    }
+
+    if (path != _path)
+    {
+        std::vector<String> names;
+
+        String::size_type b = 0;
+        while (b < path.size())
+        {
+            String::size_type e = path.find(L'/', b);
+            if (e == String::npos)
+                e = path.size();
+
+            if (e > b)
+                names.push_back(path.substr(b, e - b));
+
+            b = e + 1;
+        }
+
+        if (names.empty())
+            throw std::invalid_argument("empty element path");
+
+        if (names != _pathNames)
+        {
+            _pathNames.swap(names);
+            _pathIds.clear();
+            for (std::vector<String>::const_iterator it = _pathNames.begin(); it != _pathNames.end(); ++it)
+                _pathIds.push_back(reader.nameId(*it));
+            _matchDepth = 0;
+        }
+
+        _path = path;
+    }
+
+    // The current node is either the first node of the document or the end
+    // of the element delivered last.
+    for (const Node* node = &reader.get(); node->type() != Node::EndDocument; node = &reader.next())
+    {
+        size_t depth = reader.depth();
+        if (_matchDepth > depth)
+            _matchDepth = depth;
+
+        if (node->type() != Node::StartElement || depth != _matchDepth + 1)
+            continue;
+
+        const StartElement& se = static_cast<const StartElement&>(*node);
+        unsigned id = _pathIds[_matchDepth];
+        if (id != 0 && se.nameId() != 0 ? se.nameId() != id : se.name() != _pathNames[_matchDepth])
+            continue;
+
+        if (++_matchDepth == _pathNames.size())
+        {
+            log_debug("element " << _path << " found in line " << reader.line());
+            begin();
+            parseElement(reader);
+            return true;
+        }
+    }
+
+    begin();
+    return false;
+}
+
+
+void XmlDeserializer::setReader(XmlReader& reader)
+{
+    _reader = &reader;
+    _typeId = reader.nameId(typeAttribute);
+    _categoryId = reader.nameId(categoryAttribute);
+    _narrowNames.clear();
+}
+
+
+void XmlDeserializer::parseElement(XmlReader& reader)
+{
     _processNode = &XmlDeserializer::beginDocument;
 
     _startDepth = reader.depth();
@@ -126,12 +244,10 @@ void XmlDeserializer::beginDocument(XmlReader& reader)
         {
             const StartElement& se =  static_cast<const StartElement&>(node);
 
-            _nodeName = se.name();
-            _nodeType = se.attribute(L"type");
-            _nodeCategory = se.attribute(L"category");
+            setNode(se);
             log_finer("node name=" << _nodeName);
 
-            current()->setName(_nodeName.narrow());
+            current()->setName(nodeName());
             current()->setTypeName(_nodeType.narrow());
             current()->setCategory(nodeCategory());
 
@@ -173,10 +289,8 @@ void XmlDeserializer::onRootElement(XmlReader& reader)
         case Node::StartElement:
         {
             const StartElement& se =  static_cast<const StartElement&>(node);
-            _nodeName = se.name();
+            setNode(se);
             log_finer("node name=" << _nodeName);
-            _nodeType = se.attribute(L"type");
-            _nodeCategory = se.attribute(L"category");
             if (_readAttributes)
                 _attributes = se.attributes();
 
@@ -186,7 +300,7 @@ void XmlDeserializer::onRootElement(XmlReader& reader)
 
         case Node::EndElement:
         {
-            if( _nodeName != static_cast<const EndElement&>(node).name() )
+            if (!isNode(static_cast<const EndElement&>(node)))
                 throw std::logic_error("Invalid element");
             break;
         }
@@ -209,9 +323,7 @@ void XmlDeserializer::onStartElement(XmlReader& reader)
             const Characters& chars = static_cast<const cxxtools::xml::Characters&>(node);
             if(cxxtools::String::npos != chars.content().find_first_not_of(L" \t\n\r") )
             {
-                std::string nodeName = _nodeName.narrow();
-                std::string nodeType = _nodeType.empty() ? nodeName : _nodeType.narrow();
-                beginMember(nodeName, nodeType, nodeCategory());
+                beginNodeMember();
                 if (_readAttributes)
                 {
                     processAttributes(_attributes);
@@ -225,10 +337,8 @@ void XmlDeserializer::onStartElement(XmlReader& reader)
             }
             else
             {
-                std::string nodeName = _nodeName.narrow();
                 log_finer("node name=" << _nodeName);
-                std::string nodeType = _nodeType.empty() ? nodeName : _nodeType.narrow();
-                beginMember(nodeName, nodeType, nodeCategory());
+                beginNodeMember();
                 if (_readAttributes)
                 {
                     processAttributes(_attributes);
@@ -242,16 +352,12 @@ void XmlDeserializer::onStartElement(XmlReader& reader)
         }
         case Node::StartElement:
         {
-            std::string nodeName = _nodeName.narrow();
-            std::string nodeType = _nodeType.empty() ? nodeName : _nodeType.narrow();
-            log_finer("beginMember " << nodeName);
-            beginMember(nodeName, nodeType, nodeCategory());
+            log_finer("beginMember " << _nodeName);
+            beginNodeMember();
 
             const StartElement& se =  static_cast<const StartElement&>(node);
-            _nodeName = se.name();
+            setNode(se);
             log_finer("node name=" << se.name());
-            _nodeType = se.attribute(L"type");
-            _nodeCategory = se.attribute(L"category");
             if (_readAttributes)
             {
                 processAttributes(_attributes);
@@ -261,12 +367,10 @@ void XmlDeserializer::onStartElement(XmlReader& reader)
         }
         case Node::EndElement:
         {
-            if( _nodeName != static_cast<const EndElement&>(node).name() )
+            if (!isNode(static_cast<const EndElement&>(node)))
                 throw std::logic_error("Invalid element");
 
-            std::string nodeName = _nodeName.narrow();
-            std::string nodeType = _nodeType.empty() ? nodeName : _nodeType.narrow();
-            beginMember(nodeName, nodeType, nodeCategory());
+            beginNodeMember();
             if (_readAttributes)
             {
                 processAttributes(_attributes);
@@ -293,10 +397,8 @@ void XmlDeserializer::onWhitespace(XmlReader& reader)
         case Node::StartElement:
         {
             const StartElement& se =  static_cast<const StartElement&>(node);
-            _nodeName = se.name();
+            setNode(se);
             log_finer("node name=" << _nodeName);
-            _nodeType = se.attribute(L"type");
-            _nodeCategory = se.attribute(L"category");
             if (_readAttributes)
                 _attributes = se.attributes();
 
@@ -305,7 +407,7 @@ void XmlDeserializer::onWhitespace(XmlReader& reader)
         }
         case Node::EndElement:
         {
-            _nodeName = static_cast<const EndElement&>(node).name();
+            setNode(static_cast<const EndElement&>(node));
 
             if(reader.depth() >= _startDepth)
                 leaveMember();
@@ -355,9 +457,7 @@ void XmlDeserializer::onEndElement(XmlReader& reader)
         {
             const StartElement& se =  static_cast<const StartElement&>(node);
 
-            _nodeName = se.name();
-            _nodeType = se.attribute(L"type");
-            _nodeCategory = se.attribute(L"category");
+            setNode(se);
             if (_readAttributes)
             {
                 processAttributes(_attributes);
@@ -371,7 +471,7 @@ void XmlDeserializer::onEndElement(XmlReader& reader)
         }
         case Node::EndElement:
         {
-            _nodeName = static_cast<const EndElement&>(node).name();
+            setNode(static_cast<const EndElement&>(node));
 
             if(reader.depth() >= _startDepth)
                 leaveMember();
@@ -390,6 +490,54 @@ void XmlDeserializer::onEndElement(XmlReader& reader)
 
 }
 
+void XmlDeserializer::setNode(const StartElement& se)
+{
+    _nodeName = se.name();
+    _nodeNameId = se.nameId();
+    _nodeType = attributeValue(se, _typeId, typeAttribute);
+    _nodeCategory = attributeValue(se, _categoryId, categoryAttribute);
+}
+
+void XmlDeserializer::setNode(const EndElement& ee)
+{
+    _nodeName = ee.name();
+    _nodeNameId = ee.nameId();
+}
+
+bool XmlDeserializer::isNode(const EndElement& ee) const
+{
+    return _nodeNameId != 0 && ee.nameId() != 0 ? _nodeNameId == ee.nameId()
+                                                : _nodeName == ee.name();
+}
+
+const std::string& XmlDeserializer::nodeName()
+{
+    if (_nodeNameId == 0)
+    {
+        _narrowName = _nodeName.narrow();
+        return _narrowName;
+    }
+
+    // names are converted once per id
+    if (_nodeNameId >= _narrowNames.size())
+        _narrowNames.resize(_nodeNameId + 1);
+
+    std::string& name = _narrowNames[_nodeNameId];
+    if (name.empty())
+        name = _nodeName.narrow();
+
+    return name;
+}
+
+void XmlDeserializer::beginNodeMember()
+{
+    const std::string& name = nodeName();
+    if (_nodeType.empty())
+        beginMember(name, name, nodeCategory());
+    else
+        beginMember(name, _nodeType.narrow(), nodeCategory());
+}
+
 SerializationInfo::Category XmlDeserializer::nodeCategory() const
 {
     return _nodeCategory == L"array" ? SerializationInfo::Array :
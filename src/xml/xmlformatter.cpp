@@ -49,6 +49,7 @@ XmlFormatter::XmlFormatter(std::ostream& os)
 
 XmlFormatter::XmlFormatter(XmlWriter* writer)
 : _writer(writer)
+, _useAttributes(true)
 {
 }
 
@@ -99,7 +100,7 @@ void XmlFormatter::flush()
 void XmlFormatter::addValueString(const std::string& name, const std::string& type,
                              const cxxtools::String& value)
 {
-    cxxtools::String tag(name.empty() ? type : name);
+    const std::string& tag = name.empty() ? type : name;
 
     Attribute attrs[1];
     size_t countAttrs = 0;
@@ -121,7 +122,7 @@ void XmlFormatter::addValueString(const std::string& name, const std::string& ty
 void XmlFormatter::beginComplexElement(const std::string& name, const std::string& type,
                               const String& category)
 {
-    cxxtools::String tag(name.empty() ? type : name);
+    const std::string& tag = name.empty() ? type : name;
 
     if (tag.empty())
         throw std::logic_error("type name or element name must be set in xml formatter");
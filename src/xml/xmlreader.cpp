@@ -35,11 +35,16 @@
 #include "cxxtools/xml/xmlerror.h"
 #include "cxxtools/textstream.h"
 #include "cxxtools/utf8codec.h"
+#include "cxxtools/conversionerror.h"
 #include "cxxtools/log.h"
+#include "nametable.h"
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
 #include <typeinfo>
+#include <vector>
+#include <cstring>
+#include <cctype>
 
 log_define("cxxtools.xml.reader")
 
@@ -47,6 +52,108 @@ namespace cxxtools {
 
 namespace xml {
 
+namespace
+{
+    inline uint64_t hasByte(uint64_t v, uint64_t pattern)
+    {
+        const uint64_t ones = 0x0101010101010101ull;
+        const uint64_t highs = 0x8080808080808080ull;
+        v ^= pattern;
+        return (v - ones) & ~v & highs;
+    }
+
+    // Returns the first occurrence of one of the bytes a, b or c.
+    // 8 bytes are checked at once using a word wide zero byte test.
+    const char* findAny(const char* p, const char* e, char a, char b, char c)
+    {
+        const uint64_t ones = 0x0101010101010101ull;
+        const uint64_t pa = ones * static_cast<unsigned char>(a);
+        const uint64_t pb = ones * static_cast<unsigned char>(b);
+        const uint64_t pc = ones * static_cast<unsigned char>(c);
+
+        for ( ; e - p >= 8; p += 8)
+        {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            if (hasByte(v, pa) | hasByte(v, pb) | hasByte(v, pc))
+                break;
+        }
+
+        for ( ; p < e; ++p)
+            if (*p == a || *p == b || *p == c)
+                return p;
+
+        return e;
+    }
+
+    // Bytes, which the state machine handles as part of a name.
+    inline bool isNameByte(char ch)
+    {
+        switch (ch)
+        {
+            case '\n': case ' ': case '\t': case '\r':
+            case '<': case '>': case '/': case '=':
+            case '"': case '\'': case '!': case '?':
+                return false;
+
+            default:
+                return true;
+        }
+    }
+
+    // Decodes one utf-8 encoded character. Returns false, when the
+    // character is incomplete.
+    bool decodeUtf8(const char*& p, const char* e, Char& ch)
+    {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c < 0x80)
+        {
+            ch = Char(c);
+            ++p;
+            return true;
+        }
+
+        unsigned n;
+        uint32_t v;
+        if (c >= 0xc2 && c <= 0xdf)
+        {
+            n = 1;
+            v = c & 0x1f;
+        }
+        else if (c >= 0xe0 && c <= 0xef)
+        {
+            n = 2;
+            v = c & 0x0f;
+        }
+        else if (c >= 0xf0 && c <= 0xf4)
+        {
+            n = 3;
+            v = c & 0x07;
+        }
+        else
+            throw ConversionError("character conversion failed");
+
+        if (static_cast<unsigned>(e - p) <= n)
+            return false;
+
+        for (unsigned i = 1; i <= n; ++i)
+        {
+            unsigned char t = static_cast<unsigned char>(p[i]);
+            if ((t & 0xc0) != 0x80)
+                throw ConversionError("character conversion failed");
+            v = (v << 6) | (t & 0x3f);
+        }
+
+        if ((n == 2 && v < 0x800) || (n == 3 && (v < 0x10000 || v > 0x10ffff))
+            || (v >= 0xd800 && v <= 0xdfff))
+            throw ConversionError("character conversion failed");
+
+        ch = Char(static_cast<Char::value_type>(v));
+        p += n + 1;
+        return true;
+    }
+}
+
 class XmlReaderImpl
 {
     XmlReaderImpl(const XmlReaderImpl&) { }
@@ -170,6 +277,13 @@ class XmlReaderImpl
             return this;
         }
 
+        // Consumes a run of bytes at once, when the input is utf-8. Returns
+        // false, when the next character has to be passed to onChar.
+        virtual bool scan(XmlReaderImpl& /*reader*/)
+        {
+            return false;
+        }
+
         static void syntaxError(const char* msg, unsigned line);
 
     };
@@ -411,6 +525,11 @@ class XmlReaderImpl
             return this;
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanCharacters();
+        }
+
         static State* instance()
         {
             static OnCharacters _state;
@@ -430,8 +549,7 @@ class XmlReaderImpl
         virtual State* onCloseBracket(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
             reader._chars.clear();
-            reader._current = &(reader._endElem);
-            reader._depth--;
+            reader.emitEndElement();
 
             if(reader.depth() == 0)
                 return OnEpilog::instance();
@@ -439,6 +557,11 @@ class XmlReaderImpl
             return AfterTag::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanEndTag(XmlReaderImpl::EndTagAfterName);
+        }
+
         static State* instance()
         {
             static AfterEndElementName _state;
@@ -469,8 +592,7 @@ class XmlReaderImpl
         virtual State* onCloseBracket(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
             reader._chars.clear();
-            reader._current = &(reader._endElem);
-            reader._depth--;
+            reader.emitEndElement();
 
             if(reader.depth() == 0)
                 return OnEpilog::instance();
@@ -478,6 +600,11 @@ class XmlReaderImpl
             return AfterTag::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanEndTag(XmlReaderImpl::EndTagName);
+        }
+
         static State* instance()
         {
             static OnEndElementName _state;
@@ -495,6 +622,11 @@ class XmlReaderImpl
             return OnEndElementName::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanEndTag(XmlReaderImpl::EndTagStart);
+        }
+
         static State* instance()
         {
             static OnEndElement _state;
@@ -513,7 +645,8 @@ class XmlReaderImpl
 
         virtual State* onCloseBracket(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
-            reader._endElem.name() = reader._startElem.name();
+            reader._endElem._name = reader._startElem._name;
+            reader._endElem._nameId = reader._startElem._nameId;
             reader._current = &(reader._endElem);
             reader._depth--;
 
@@ -536,7 +669,7 @@ class XmlReaderImpl
     {
         virtual State* onQuote(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
-            reader._startElem.addAttribute(reader._attr);
+            reader.addAttribute();
             return BeforeAttribute::instance();
         }
 
@@ -600,6 +733,11 @@ class XmlReaderImpl
             return this;
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanStartTag(XmlReaderImpl::TagAttributeValue);
+        }
+
         static State* instance()
         {
             static OnAttributeValue _state;
@@ -621,6 +759,11 @@ class XmlReaderImpl
             return OnAttributeValue::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanStartTag(XmlReaderImpl::TagBeforeAttributeValue);
+        }
+
         static State* instance()
         {
             static BeforeAttributeValue _state;
@@ -642,6 +785,11 @@ class XmlReaderImpl
             return BeforeAttributeValue::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanStartTag(XmlReaderImpl::TagAfterAttributeName);
+        }
+
         static State* instance()
         {
             static AfterAttributeName _state;
@@ -675,6 +823,11 @@ class XmlReaderImpl
             return this;
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanStartTag(XmlReaderImpl::TagAttributeName);
+        }
+
         static State* instance()
         {
             static OnAttributeName _state;
@@ -693,8 +846,7 @@ class XmlReaderImpl
 
         virtual State* onSlash(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
-            reader._current = &(reader._startElem);
-            reader._depth++;
+            reader.emitStartElement();
             return OnEmptyElement::instance();
         }
 
@@ -708,11 +860,15 @@ class XmlReaderImpl
         virtual State* onCloseBracket(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
             reader._chars.clear();
-            reader._current = &(reader._startElem);
-            reader._depth++;
+            reader.emitStartElement();
             return AfterTag::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanStartTag(XmlReaderImpl::TagBeforeAttribute);
+        }
+
         static State* instance()
         {
             static BeforeAttribute _state;
@@ -737,8 +893,7 @@ class XmlReaderImpl
         virtual State* onSlash(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
             reader._chars.clear();
-            reader._current = &(reader._startElem);
-            reader._depth++;
+            reader.emitStartElement();
             return OnEmptyElement::instance();
         }
 
@@ -751,11 +906,15 @@ class XmlReaderImpl
         virtual State* onCloseBracket(cxxtools::Char /*c*/, XmlReaderImpl& reader)
         {
             reader._chars.clear();
-            reader._current = &(reader._startElem);
-            reader._depth++;
+            reader.emitStartElement();
             return AfterTag::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanStartTag(XmlReaderImpl::TagName);
+        }
+
         static State* instance()
         {
             static OnStartElement _state;
@@ -952,6 +1111,11 @@ class XmlReaderImpl
             return this;
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.depth() > 0 && reader.scanCharacters();
+        }
+
         static State* instance()
         {
             static AfterTag _state;
@@ -1124,11 +1288,16 @@ class XmlReaderImpl
                 reader._current = &(reader._chars);
             }
 
-            reader._startElem.clear();
+            reader.beginStartElement();
             reader._startElem.name() += c;
             return OnStartElement::instance();
         }
 
+        virtual bool scan(XmlReaderImpl& reader)
+        {
+            return reader.scanTag();
+        }
+
         static State* instance()
         {
             static OnTag _state;
@@ -1501,7 +1670,7 @@ class XmlReaderImpl
 
         virtual State* onAlpha(cxxtools::Char c, XmlReaderImpl& reader)
         {
-            reader._startElem.clear();
+            reader.beginStartElement();
             reader._startElem.name() += c;
             return OnStartElement::instance();
         }
@@ -1535,95 +1704,577 @@ class XmlReaderImpl
         }
     };
 
+    // Processes the next character from the input. Returns false, when no
+    // input is available. Unless wait is set, only input is processed, which
+    // is available without blocking.
+    bool step(bool wait)
+    {
+        if (_byteSource)
+            return stepBytes(wait);
+
+        if (!_textBuffer)
+            return false;
+
+        if (!wait && _textBuffer->in_avail() <= 0)
+            return false;
+
+        std::basic_streambuf<Char>::int_type c = _textBuffer->sbumpc();
+        if (c == std::char_traits<Char>::eof())
+            return false;
+
+        Char ch = std::char_traits<Char>::to_char_type(c);
+        log_finer("ch='" << ch << '\'');
+        _state = _state->onChar(ch, *this);
+
+        if (ch == L'\n')
+        {
+            ++_line;
+        }
+
+        return true;
+    }
+
+    // Utf-8 input is read directly from the byte buffer. The states, which
+    // collect names, text and attribute values consume whole runs of bytes
+    // using scan; everything else is decoded and passed character by
+    // character to the state machine.
+    bool stepBytes(bool wait)
+    {
+        if (_atStart && !skipByteOrderMark(wait))
+            return false;
+
+        if (_pos == _end && !fill(wait))
+            return false;
+
+        if (_state->scan(*this))
+        {
+            while (!_current && _pos != _end && _state->scan(*this))
+                ;
+            return true;
+        }
+
+        Char ch;
+        while (!decodeUtf8(_pos, _end, ch))
+        {
+            // incomplete character at the end of the buffer
+            if (!fill(wait))
+            {
+                if (wait)
+                    throw ConversionError("character conversion failed");
+                return false;
+            }
+        }
+
+        log_finer("ch='" << ch << '\'');
+        _state = _state->onChar(ch, *this);
+
+        if (ch == L'\n')
+        {
+            ++_line;
+        }
+
+        return true;
+    }
+
+    // Reads more bytes into the byte buffer and keeps unprocessed bytes.
+    bool fill(bool wait)
+    {
+        std::size_t rest = _end - _pos;
+        char* begin = &_bytes[0];
+        if (_pos != begin)
+        {
+            std::memmove(begin, _pos, rest);
+            _pos = begin;
+            _end = begin + rest;
+        }
+
+        std::streamsize n = _byteSource->in_avail();
+        if (n <= 0)
+        {
+            if (!wait || _byteSource->sgetc() == std::char_traits<char>::eof())
+                return false;
+
+            n = _byteSource->in_avail();
+            if (n <= 0)
+                n = 1;
+        }
+
+        std::streamsize room = static_cast<std::streamsize>(_bytes.size() - rest);
+        n = _byteSource->sgetn(begin + rest, n < room ? n : room);
+        _end += n;
+
+        return n > 0;
+    }
+
+    // Skips the utf-8 byte order mark at the start of the document. Returns
+    // false, when more input is needed to decide.
+    bool skipByteOrderMark(bool wait)
+    {
+        static const char bom[] = "\xef\xbb\xbf";
+
+        while (true)
+        {
+            std::size_t n = _end - _pos;
+            if (n > 3)
+                n = 3;
+
+            if (std::memcmp(_pos, bom, n) != 0)
+                break;
+
+            if (n == 3)
+            {
+                _pos += 3;
+                break;
+            }
+
+            if (!fill(wait))
+            {
+                if (!wait)
+                    return false;
+                break;
+            }
+        }
+
+        _atStart = false;
+        return true;
+    }
+
+    // Positions inside of tags, where scanStartTag and scanEndTag continue.
+    enum TagPosition
+    {
+        TagName,
+        TagBeforeAttribute,
+        TagAttributeName,
+        TagAfterAttributeName,
+        TagBeforeAttributeValue,
+        TagAttributeValue,
+        EndTagStart,
+        EndTagName,
+        EndTagAfterName
+    };
+
+    static bool isSpace(char ch)
+    {
+        return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r';
+    }
+
+    void skipSpace()
+    {
+        if (*_pos++ == '\n')
+            ++_line;
+    }
+
+    State* tagState(TagPosition pos)
+    {
+        switch (pos)
+        {
+            case TagName:                 return OnStartElement::instance();
+            case TagBeforeAttribute:      return BeforeAttribute::instance();
+            case TagAttributeName:        return OnAttributeName::instance();
+            case TagAfterAttributeName:   return AfterAttributeName::instance();
+            case TagBeforeAttributeValue: return BeforeAttributeValue::instance();
+            case TagAttributeValue:       return OnAttributeValue::instance();
+            case EndTagStart:             return OnEndElement::instance();
+            case EndTagName:              return OnEndElementName::instance();
+            case EndTagAfterName:         return AfterEndElementName::instance();
+        }
+
+        return _state;
+    }
+
+    // Consumes character data up to the next tag including the '<'.
+    bool scanCharacters()
+    {
+        const char* begin = _pos;
+        String& content = _chars.content();
+
+        while (_pos != _end)
+        {
+            if (!appendBytes(content, findAny(_pos, _end, '<', '&', '&'))
+                || _pos == _end)
+                break;
+
+            if (*_pos == '<')
+            {
+                ++_pos;
+                _state = OnTag::instance();
+                return true;
+            }
+
+            if (!scanEntity(content, true))
+                break;
+        }
+
+        if (_pos == begin)
+            return false;
+
+        _state = OnCharacters::instance();
+        return true;
+    }
+
+    // Handles the character after '<', when a start or end tag follows.
+    bool scanTag()
+    {
+        char ch = *_pos;
+        if (ch == '/')
+        {
+            ++_pos;
+            if (_chars.content().length())
+                _current = &_chars;
+
+            _endElem.clear();
+            _state = OnEndElement::instance();
+            return true;
+        }
+
+        if (!isNameByte(ch))
+            return false;
+
+        if (_chars.content().length())
+            _current = &_chars;
+
+        beginStartElement();
+        _state = OnStartElement::instance();
+        return true;
+    }
+
+    // Parses a start tag from the given position on. Anything unusual is
+    // left to the state machine.
+    bool scanStartTag(TagPosition pos)
+    {
+        const char* begin = _pos;
+        State* next = 0;
+        bool stop = false;
+
+        while (!stop && !next && _pos != _end)
+        {
+            char ch = *_pos;
+            switch (pos)
+            {
+                case TagName:
+                    if (isSpace(ch))
+                    {
+                        skipSpace();
+                        pos = TagBeforeAttribute;
+                    }
+                    else if (ch == '>' || ch == '/')
+                    {
+                        ++_pos;
+                        _chars.clear();
+                        emitStartElement();
+                        next = ch == '>' ? AfterTag::instance() : OnEmptyElement::instance();
+                    }
+                    else
+                        stop = !isNameByte(ch) || !scanName(_startElem._name);
+                    break;
+
+                case TagBeforeAttribute:
+                    if (isSpace(ch))
+                        skipSpace();
+                    else if (ch == '>')
+                    {
+                        ++_pos;
+                        _chars.clear();
+                        emitStartElement();
+                        next = AfterTag::instance();
+                    }
+                    else if (ch == '/')
+                    {
+                        ++_pos;
+                        emitStartElement();
+                        next = OnEmptyElement::instance();
+                    }
+                    else if (isNameByte(ch) && ch != ':')
+                    {
+                        _attr.clear();
+                        pos = TagAttributeName;
+                    }
+                    else
+                        stop = true;
+                    break;
+
+                case TagAttributeName:
+                    if (isSpace(ch))
+                    {
+                        skipSpace();
+                        pos = TagAfterAttributeName;
+                    }
+                    else if (ch == '=')
+                    {
+                        ++_pos;
+                        pos = TagBeforeAttributeValue;
+                    }
+                    else
+                        stop = !isNameByte(ch) || !scanName(_attr.name());
+                    break;
+
+                case TagAfterAttributeName:
+                case TagBeforeAttributeValue:
+                    if (isSpace(ch))
+                        skipSpace();
+                    else if (ch == '=' && pos == TagAfterAttributeName)
+                    {
+                        ++_pos;
+                        pos = TagBeforeAttributeValue;
+                    }
+                    else if ((ch == '"' || ch == '\'') && pos == TagBeforeAttributeValue)
+                    {
+                        ++_pos;
+                        pos = TagAttributeValue;
+                    }
+                    else
+                        stop = true;
+                    break;
+
+                case TagAttributeValue:
+                    if (ch == '"' || ch == '\'')
+                    {
+                        ++_pos;
+                        addAttribute();
+                        pos = TagBeforeAttribute;
+                    }
+                    else if (ch == '&')
+                        stop = !scanEntity(_attr.value(), false);
+                    else
+                        stop = !appendBytes(_attr.value(), findAny(_pos, _end, '"', '\'', '&'));
+                    break;
+
+                default:
+                    stop = true;
+            }
+        }
+
+        _state = next ? next : tagState(pos);
+        return _pos != begin;
+    }
+
+    // Parses an end tag from the given position on.
+    bool scanEndTag(TagPosition pos)
+    {
+        const char* begin = _pos;
+        bool stop = false;
+
+        while (!stop && _pos != _end)
+        {
+            char ch = *_pos;
+            if (ch == '>' && pos != EndTagStart)
+            {
+                ++_pos;
+                _chars.clear();
+                emitEndElement();
+                _state = _depth == 0 ? OnEpilog::instance() : AfterTag::instance();
+                return true;
+            }
+
+            switch (pos)
+            {
+                case EndTagStart:
+                    if (isNameByte(ch) && ch != ':')
+                        pos = EndTagName;
+                    else
+                        stop = true;
+                    break;
+
+                case EndTagName:
+                    if (isSpace(ch))
+                    {
+                        skipSpace();
+                        pos = EndTagAfterName;
+                    }
+                    else
+                        stop = !isNameByte(ch) || !scanName(_endElem.name());
+                    break;
+
+                case EndTagAfterName:
+                    if (isSpace(ch))
+                        skipSpace();
+                    else
+                        stop = true;
+                    break;
+
+                default:
+                    stop = true;
+            }
+        }
+
+        _state = tagState(pos);
+        return _pos != begin;
+    }
+
+    // Resolves an entity reference, which is completely in the buffer.
+    bool scanEntity(String& str, bool inText)
+    {
+        const char* p = _pos + 1;
+        const char* e = _end - p > 32 ? p + 32 : _end;
+        const char* q = p;
+        while (q != e && (std::isalnum(static_cast<unsigned char>(*q)) || *q == '#'))
+            ++q;
+
+        if (q == e || q == p || *q != ';')
+            return false;
+
+        _token.clear();
+        for ( ; p != q; ++p)
+            _token += Char(*p);
+
+        if (inText)
+        {
+            try
+            {
+                resolveEntity(_token);
+            }
+            catch (const std::exception&)
+            {
+                throw XmlError("invalid entity " + _token.narrow(), line());
+            }
+        }
+        else
+            resolveEntity(_token);
+
+        str += _token;
+        _token.clear();
+        _pos = q + 1;
+        return true;
+    }
+
+    // Appends the bytes of a name to str.
+    bool scanName(String& str)
+    {
+        const char* begin = _pos;
+        const char* e = _pos;
+        while (e != _end && isNameByte(*e))
+            ++e;
+
+        appendBytes(str, e);
+        return _pos != begin;
+    }
+
+    // Decodes the bytes up to e into str. An incomplete character at the
+    // end is left in the buffer and false is returned.
+    bool appendBytes(String& str, const char* e)
+    {
+        const char* p = _pos;
+        String::size_type size = str.size();
+        str.resize(size + (e - p));
+        Char* begin = &str[size];
+        Char* out = begin;
+
+        while (p != e)
+        {
+            if (static_cast<unsigned char>(*p) < 0x80)
+            {
+                if (*p == '\n')
+                    ++_line;
+                *out++ = Char(*p++);
+            }
+            else if (decodeUtf8(p, e, *out))
+                ++out;
+            else
+                break;
+        }
+
+        if (out != begin + (e - _pos))
+            str.resize(size + (out - begin));
+
+        _pos = p;
+        return p == e;
+    }
+
     void readProlog()
     {
         while (_state != OnStartElement::instance()
             && _state != OnProlog::instance())
         {
-            std::basic_streambuf<Char>::int_type c = _textBuffer->sbumpc();
-            if (c == std::char_traits<Char>::eof())
+            if (!step(true))
             {
                 log_finer("eof");
                 _state = _state->onEof(*this);
                 break;
             }
-
-            Char ch = std::char_traits<Char>::to_char_type(c);
-            log_finer("ch='" << ch << '\'');
-            _state = _state->onChar(ch, *this);
-
-            if (ch == L'\n')
-            {
-                ++_line;
-            }
         }
     }
 
+    void init(int flags)
+    {
+        _state = XmlReaderImpl::OnDocumentBegin::instance();
+        _flags = flags;
+        _version.clear();
+        _encoding.clear();
+        _standalone = true;
+        _depth = 0;
+        _line = 1;
+        _current = 0;
+        _atStart = true;
+    }
 
   public:
+    XmlReaderImpl()
+    : _textBuffer(0)
+    , _byteSource(0)
+    , _pos(0)
+    , _end(0)
+    , _atStart(true)
+    , _flags(0)
+    , _standalone(true)
+    , _depth(0)
+    , _line(1)
+    , _state(0)
+    , _current(0)
+    , _attributeCount(0)
+    {
+        _state = XmlReaderImpl::OnDocumentBegin::instance();
+    }
+
     XmlReaderImpl(std::basic_istream<Char>& is, int flags)
     : _textBuffer( is.rdbuf() )
-    , _buffer(0)
+    , _byteSource(0)
+    , _pos(0)
+    , _end(0)
+    , _atStart(true)
     , _flags(flags)
     , _standalone(true)
     , _depth(0)
     , _line(1)
     , _state(0)
     , _current(0)
+    , _attributeCount(0)
     {
         _state = XmlReaderImpl::OnDocumentBegin::instance();
     }
 
     XmlReaderImpl(std::istream& is, int flags)
     : _textBuffer(0)
-    , _buffer(0)
+    , _byteSource(is.rdbuf())
+    , _bytes(8192)
+    , _pos(&_bytes[0])
+    , _end(&_bytes[0])
+    , _atStart(true)
     , _flags(flags)
     , _standalone(true)
     , _depth(0)
     , _line(1)
     , _state(0)
     , _current(0)
+    , _attributeCount(0)
     {
         _state = XmlReaderImpl::OnDocumentBegin::instance();
-        _buffer = new TextBuffer( &is, new cxxtools::Utf8Codec() );
-        _textBuffer = _buffer;
-    }
-
-    ~XmlReaderImpl()
-    {
-        delete _buffer;
     }
 
     void reset(std::basic_istream<Char>& is, int flags)
     {
-        delete _buffer;
-        _buffer = 0;
         _textBuffer = is.rdbuf();
-
-        _state = XmlReaderImpl::OnDocumentBegin::instance();
-        _flags = flags;
-        _version.clear();
-        _encoding.clear();
-        _standalone = true;
-        _depth = 0;
-        _line = 1;
-        _current = 0;
+        _byteSource = 0;
+        init(flags);
     }
 
     void reset(std::istream& is, int flags)
     {
-        delete _buffer;
-        _buffer = new TextBuffer( &is, new cxxtools::Utf8Codec() );
-        _textBuffer = _buffer;
-
-        _state = XmlReaderImpl::OnDocumentBegin::instance();
-        _flags = flags;
-        _version.clear();
-        _encoding.clear();
-        _standalone = true;
-        _depth = 0;
-        _line = 1;
-        _current = 0;
+        _textBuffer = 0;
+        _byteSource = is.rdbuf();
+        if (_bytes.empty())
+            _bytes.resize(8192);
+        _pos = _end = &_bytes[0];
+        init(flags);
     }
 
     const cxxtools::String& version() const
@@ -1682,22 +2333,12 @@ class XmlReaderImpl
         _current = 0;
         do
         {
-            std::basic_streambuf<Char>::int_type c = _textBuffer->sbumpc();
-            if (c == std::char_traits<Char>::eof())
+            if (!step(true))
             {
                 log_finer("eof");
                 _state = _state->onEof(*this);
                 break;
             }
-
-            Char ch = std::char_traits<Char>::to_char_type(c);
-            log_finer("ch='" << ch << '\'');
-            _state = _state->onChar(ch, *this);
-
-            if (ch == L'\n')
-            {
-                ++_line;
-            }
         }
         while (!_current);
 
@@ -1707,17 +2348,8 @@ class XmlReaderImpl
     bool advance()
     {
         _current = 0;
-        while( ! _current && _textBuffer->in_avail() > 0 )
-        {
-            Char ch = std::char_traits<Char>::to_char_type(_textBuffer->sbumpc());
-            log_finer("ch='" << ch << '\'');
-            _state = _state->onChar(ch, *this);
-
-            if (ch == '\n')
-            {
-                ++_line;
-            }
-        }
+        while (!_current && step(false))
+            ;
 
         return _current != 0;
     }
@@ -1740,9 +2372,75 @@ class XmlReaderImpl
         content += c;
     }
 
+    // Starts a new start element. The attributes of the previous element
+    // are kept, so that their strings can be reused.
+    void beginStartElement()
+    {
+        _startElem._name.clear();
+        _attributeCount = 0;
+    }
+
+    static void swapStrings(Attribute& a, Attribute& b)
+    {
+        a._name.swap(b._name);
+        a._value.swap(b._value);
+    }
+
+    void addAttribute()
+    {
+        Attributes& attributes = _startElem._attributes;
+        if (_attributeCount == attributes.size())
+        {
+            attributes.push_back(Attribute());
+            if (!_spareAttributes.empty())
+            {
+                swapStrings(attributes.back(), _spareAttributes.back());
+                _spareAttributes.pop_back();
+            }
+        }
+
+        Attribute& attribute = attributes[_attributeCount++];
+        swapStrings(attribute, _attr);
+        attribute._nameId = _names.intern(attribute._name);
+    }
+
+    void emitStartElement()
+    {
+        // The attribute list has exactly the attributes of this element.
+        // The strings of the surplus attributes of the previous element
+        // are kept for reuse by later elements.
+        Attributes& attributes = _startElem._attributes;
+        while (attributes.size() > _attributeCount)
+        {
+            _spareAttributes.push_back(Attribute());
+            swapStrings(_spareAttributes.back(), attributes.back());
+            attributes.pop_back();
+        }
+
+        _startElem._nameId = _names.intern(_startElem._name);
+        _current = &_startElem;
+        ++_depth;
+    }
+
+    void emitEndElement()
+    {
+        _endElem._nameId = _names.intern(_endElem._name);
+        _current = &_endElem;
+        --_depth;
+    }
+
+    unsigned nameId(const String& name)
+    {
+        return _names.intern(name);
+    }
+
   private:
     std::basic_streambuf<Char>* _textBuffer;
-    std::basic_streambuf<Char>* _buffer;
+    std::streambuf* _byteSource;
+    std::vector<char> _bytes;
+    const char* _pos;
+    const char* _end;
+    bool _atStart;
     int _flags;
     EntityResolver _resolver;
 
@@ -1761,6 +2459,9 @@ class XmlReaderImpl
     EndElement _endElem;
     Characters _chars;
     Attribute _attr;
+    Attributes::size_type _attributeCount;
+    Attributes _spareAttributes;
+    NameTable _names;
     EndDocument _endDoc;
 };
 
@@ -1774,6 +2475,13 @@ void XmlReaderImpl::State::syntaxError(const char* msg, unsigned line)
 }
 
 
+XmlReader::XmlReader()
+: _impl(0)
+{
+    _impl = new XmlReaderImpl();
+}
+
+
 XmlReader::XmlReader(std::istream& is, int flags)
 : _impl(0)
 {
@@ -1848,6 +2556,12 @@ std::size_t XmlReader::line() const
 }
 
 
+unsigned XmlReader::nameId(const String& name)
+{
+    return _impl->nameId(name);
+}
+
+
 const Node& XmlReader::get()
 {
     return _impl->get();
@@ -37,41 +37,94 @@ namespace xml {
 
 namespace
 {
-    static const String xmlPrefix(L"<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+    static const char xmlPrefix[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+
+    // limits the number of cached tags per name type
+    static const unsigned maxTags = 256;
+
+    // output is written to the stream, when the buffer reaches this size
+    static const std::string::size_type bufferSize = 8192;
+
+    const EntityResolver& resolver()
+    {
+        static const EntityResolver resolver;
+        return resolver;
+    }
 }
 
 XmlWriter::XmlWriter()
-: _tos(new Utf8Codec)
+: _out(0)
+, _depth(0)
 , _flags(UseXmlDeclaration | UseIndent | UseEndl)
 {
 }
 
 
 XmlWriter::XmlWriter(std::ostream& os, int flags)
-: _tos(os, new Utf8Codec)
+: _out(&os)
+, _depth(0)
 , _flags(flags)
 {
     if (useXmlDeclaration())
     {
-        _tos << xmlPrefix;
+        _buffer += xmlPrefix;
         if (useEndl())
             endl();
     }
 }
 
 
+XmlWriter::~XmlWriter()
+{
+    try
+    {
+        write();
+    }
+    catch (...)
+    {
+    }
+}
+
+
 void XmlWriter::begin(std::ostream& os)
 {
-    _tos.attach(os);
+    write();
+    _out = &os;
     if (useXmlDeclaration())
     {
-        _tos << xmlPrefix;
+        _buffer += xmlPrefix;
         if (useEndl())
             endl();
     }
 }
 
 
+const XmlWriter::Tag& XmlWriter::tag(const String& name)
+{
+    std::map<String, Tag>::iterator it = _tags.find(name);
+    if (it != _tags.end())
+        return it->second;
+
+    Tag& tag = _tags.size() < maxTags ? _tags[name] : _tag;
+    tag.name = Utf8Codec::encode(name);
+    tag.close = "</" + tag.name + '>';
+    return tag;
+}
+
+
+const XmlWriter::Tag& XmlWriter::tag(const std::string& name)
+{
+    std::map<std::string, Tag>::iterator it = _stdTags.find(name);
+    if (it != _stdTags.end())
+        return it->second;
+
+    Tag& tag = _stdTags.size() < maxTags ? _stdTags[name] : _tag;
+    tag.name = Utf8Codec::encode(String::widen(name));
+    tag.close = "</" + tag.name + '>';
+    return tag;
+}
+
+
 void XmlWriter::writeStartElement(const String& localName)
 {
     writeStartElement(localName, 0, 0);
@@ -83,49 +136,65 @@ void XmlWriter::writeStartElement(const String& localName, const Attribute* attr
     if (localName.empty())
         throw std::runtime_error("local name must not be empty in xml writer");
 
-    if (useIndent())
-        indent();
+    startElement(tag(localName), attr, attrCount);
+}
 
-    _tos << Char('<') << localName;
 
-    for (size_t n = 0; n < attrCount; ++n)
-    {
-        if (useEndl())
-            endl();
+void XmlWriter::writeStartElement(const std::string& localName)
+{
+    writeStartElement(localName, 0, 0);
+}
 
-        if (useIndent())
-            indent(_elements.size() + 1);
-        else
-            _tos << Char(' ');
 
-        _tos << attr[n].name() << Char('=') << Char('"');
-        writeCharacters(attr[n].value());
-        _tos << Char('"');
-    }
+void XmlWriter::writeStartElement(const std::string& localName, const Attribute* attr, size_t attrCount)
+{
+    if (localName.empty())
+        throw std::runtime_error("local name must not be empty in xml writer");
 
-    _tos << Char('>');
+    startElement(tag(localName), attr, attrCount);
+}
+
+
+void XmlWriter::startElement(const Tag& tag, const Attribute* attr, size_t attrCount)
+{
+    if (useIndent())
+        indent();
+
+    _buffer += '<';
+    _buffer += tag.name;
+    writeAttributes(attr, attrCount);
+    _buffer += '>';
 
     if (useEndl())
         endl();
 
-    _elements.push(localName);
+    if (_depth == _elements.size())
+        _elements.push_back(tag.close);
+    else
+        _elements[_depth] = tag.close;
+    ++_depth;
+
+    if (_buffer.size() >= bufferSize)
+        write();
 }
 
 
 void XmlWriter::writeEndElement()
 {
-    if( _elements.empty() )
+    if (_depth == 0)
         return;
 
     if (useIndent())
-        indent(_elements.size() - 1);
+        indent(_depth - 1);
 
-    _tos << Char(L'<') << Char(L'/') << _elements.top() << Char(L'>');
+    --_depth;
+    _buffer += _elements[_depth];
 
     if (useEndl())
         endl();
 
-    _elements.pop();
+    if (_buffer.size() >= bufferSize)
+        write();
 }
 
 
@@ -136,62 +205,104 @@ void XmlWriter::writeElement(const String& localName, const String& content)
 
 
 void XmlWriter::writeElement(const String& localName, const Attribute* attr, size_t attrCount, const String& content)
+{
+    element(tag(localName), attr, attrCount, content);
+}
+
+
+void XmlWriter::writeElement(const std::string& localName, const String& content)
+{
+    writeElement(localName, 0, 0, content);
+}
+
+
+void XmlWriter::writeElement(const std::string& localName, const Attribute* attr, size_t attrCount, const String& content)
+{
+    element(tag(localName), attr, attrCount, content);
+}
+
+
+void XmlWriter::element(const Tag& tag, const Attribute* attr, size_t attrCount, const String& content)
 {
     if (useIndent())
         indent();
 
-    _tos << Char(L'<') << localName;
+    _buffer += '<';
+    _buffer += tag.name;
+    writeAttributes(attr, attrCount);
+    _buffer += '>';
+
+    resolver().getEntities(_buffer, content);
+    _buffer += tag.close;
+
+    if (useEndl())
+        endl();
+
+    if (_buffer.size() >= bufferSize)
+        write();
+}
+
 
+void XmlWriter::writeAttributes(const Attribute* attr, size_t attrCount)
+{
     for (size_t n = 0; n < attrCount; ++n)
     {
         if (useEndl())
             endl();
 
         if (useIndent())
-            indent(_elements.size() + 1);
+            indent(_depth + 1);
+        else
+            _buffer += ' ';
+
+        // the spare tag may be in use for the element name
+        const String& name = attr[n].name();
+        std::map<String, Tag>::const_iterator it = _tags.find(name);
+        if (it != _tags.end())
+            _buffer += it->second.name;
+        else if (_tags.size() < maxTags)
+            _buffer += tag(name).name;
         else
-            _tos << Char(' ');
+            _buffer += Utf8Codec::encode(name);
 
-        _tos << attr[n].name() << Char('=') << Char('"');
-        writeCharacters(attr[n].value());
-        _tos << Char('"');
+        _buffer += "=\"";
+        resolver().getEntities(_buffer, attr[n].value());
+        _buffer += '"';
     }
+}
 
-    _tos << Char('>');
 
-    writeCharacters(content);
-    _tos << Char('<') << Char('/') << localName << Char('>');
+void XmlWriter::writeCharacters(const String& text)
+{
+    resolver().getEntities(_buffer, text);
 
-    if (useEndl())
-        endl();
+    if (_buffer.size() >= bufferSize)
+        write();
 }
 
 
-void XmlWriter::writeCharacters(const String& text)
+void XmlWriter::write()
 {
-    static EntityResolver resolver;
-
-    String::const_iterator it;
-    for (it = text.begin(); it != text.end(); ++it)
-        resolver.getEntity(_tos, *it);
+    if (_out && !_buffer.empty())
+        _out->write(_buffer.data(), _buffer.size());
+    _buffer.clear();
 }
 
 
 void XmlWriter::flush()
 {
-    _tos.flush();
+    write();
 }
 
 
 void XmlWriter::endl()
 {
-    _tos << Char('\n');
+    _buffer += '\n';
 }
 
 void XmlWriter::indent(size_t size)
 {
-    for (size_t n = 0; n < size; ++n)
-        _tos << Char(' ') << Char(' ');
+    _buffer.append(2 * size, ' ');
 }
 
 void XmlWriter::Element::writeContent(const String& text)
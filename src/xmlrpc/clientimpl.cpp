@@ -35,7 +35,6 @@
 #include "cxxtools/xml/characters.h"
 #include "cxxtools/xml/endelement.h"
 #include "cxxtools/selectable.h"
-#include "cxxtools/utf8codec.h"
 #include "cxxtools/xmlrpc/errorcodes.h"
 #include "cxxtools/serializationerror.h"
 #include "cxxtools/log.h"
@@ -77,8 +76,7 @@ namespace
 
 ClientImpl::ClientImpl()
 : _state(OnBegin)
-, _ts( new Utf8Codec )
-, _reader(_ts)
+, _is(0)
 , _formatter(_writer)
 , _method(0)
 , _timeout(Selectable::WaitInfinite)
@@ -123,8 +121,7 @@ void ClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecomposer**
             throw;
     }
 
-    _reader.reset(_ts);
-    _scanner.begin(_deserializer, r);
+    _scanner.begin(_deserializer, r, _reader);
 }
 
 
@@ -142,10 +139,9 @@ void ClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv
     prepareRequest(method.name(), argv, argc);
 
     std::istream& is = execute();
-    _ts.attach(is);
-    _reader.reset(_ts);
+    _reader.reset(is);
     _deserializer.begin();
-    _scanner.begin(_deserializer, r);
+    _scanner.begin(_deserializer, r, _reader);
 
     while( _reader.get().type() !=  cxxtools::xml::Node::EndDocument )
     {
@@ -182,30 +178,23 @@ void ClientImpl::cancel()
 
 void ClientImpl::onReadReplyBegin(std::istream& is)
 {
-    _ts.attach(is);
+    _is = &is;
+    _reader.reset(is);
 }
 
 std::size_t ClientImpl::onReadReply()
 {
-    std::size_t n = 0;
+    // the reader consumes all bytes, which are available without blocking
+    std::streamsize avail = _is->rdbuf()->in_avail();
 
     try
     {
         _errorPending = false;
 
-        while(true)
+        while( _reader.advance() ) // xml::ParseError
         {
-            std::streamsize m = _ts.buffer().import();
-            if( ! m )
-                break;
-
-            n += m;
-
-            while( _reader.advance() ) // xml::ParseError
-            {
-                const cxxtools::xml::Node& node = _reader.get();
-                advance(node); // SerializationError, ConversionError
-            }
+            const cxxtools::xml::Node& node = _reader.get();
+            advance(node); // SerializationError, ConversionError
         }
     }
     catch(const xml::XmlError& error)
@@ -229,7 +218,11 @@ std::size_t ClientImpl::onReadReply()
         _method->onFinished();
     }
 
-    return n;
+    std::streamsize rest = _is->rdbuf()->in_avail();
+    if (rest < 0)
+        rest = 0;
+
+    return avail > rest ? avail - rest : 0;
 }
 
 
@@ -318,7 +311,7 @@ void ClientImpl::advance(const cxxtools::xml::Node& node)
                 else if( se.name() == L"fault")
                 {
                     _fh.begin(_fault);
-                    _scanner.begin(_deserializer, _fh);
+                    _scanner.begin(_deserializer, _fh, _reader);
                     _state = OnFaultBegin;
                     break;
                 }
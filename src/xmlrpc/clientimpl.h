@@ -37,7 +37,6 @@
 #include <cxxtools/decomposer.h>
 #include <cxxtools/deserializer.h>
 #include <cxxtools/connectable.h>
-#include <cxxtools/textstream.h>
 #include <string>
 
 namespace cxxtools
@@ -108,7 +107,7 @@ class ClientImpl : public cxxtools::Connectable
         void advance(const xml::Node& node);
 
         State _state;
-        TextIStream _ts;
+        std::istream* _is;
         xml::XmlReader _reader;
         xml::XmlWriter _writer;
         Formatter _formatter;
@@ -35,12 +35,22 @@ namespace cxxtools
 namespace xmlrpc
 {
 
+namespace
+{
+    const std::string valueTag = "value";
+    const std::string arrayTag = "array";
+    const std::string dataTag = "data";
+    const std::string structTag = "struct";
+    const std::string memberTag = "member";
+    const std::string nameTag = "name";
+}
+
 void Formatter::addValueString(const std::string& /*name*/, const std::string& type,
                          const cxxtools::String& value)
 {
-    _writer->writeStartElement( L"value" );
+    _writer->writeStartElement( valueTag );
 
-    if (type == "string" || type.empty())
+    if (type.empty() || type == "string")
     {
         _writer->writeCharacters(value);
     }
@@ -48,9 +58,9 @@ void Formatter::addValueString(const std::string& /*name*/, const std::string& t
     {
         std::map<std::string, std::string>::iterator it = _typemap.find(type);
         if( it != _typemap.end() )
-            _writer->writeElement( cxxtools::String::widen(it->second), value );
+            _writer->writeElement( it->second, value );
         else
-            _writer->writeElement( cxxtools::String::widen(type), value );
+            _writer->writeElement( type, value );
     }
 
     _writer->writeEndElement();
@@ -59,9 +69,9 @@ void Formatter::addValueString(const std::string& /*name*/, const std::string& t
 
 void Formatter::beginArray(const std::string&, const std::string&)
 {
-    _writer->writeStartElement( L"value" );
-    _writer->writeStartElement( L"array" );
-    _writer->writeStartElement( L"data" );
+    _writer->writeStartElement( valueTag );
+    _writer->writeStartElement( arrayTag );
+    _writer->writeStartElement( dataTag );
 }
 
 
@@ -75,15 +85,15 @@ void Formatter::finishArray()
 
 void Formatter::beginObject(const std::string& /*name*/, const std::string& /*type*/)
 {
-    _writer->writeStartElement( L"value" );
-    _writer->writeStartElement( L"struct" );
+    _writer->writeStartElement( valueTag );
+    _writer->writeStartElement( structTag );
 }
 
 
 void Formatter::beginMember(const std::string& name)
 {
-    _writer->writeStartElement( L"member" );
-    _writer->writeElement( L"name", cxxtools::String::widen(name) );
+    _writer->writeStartElement( memberTag );
+    _writer->writeElement( nameTag, cxxtools::String::widen(name) );
 }
 
 
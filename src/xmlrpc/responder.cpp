@@ -34,7 +34,6 @@
 #include "cxxtools/xml/characters.h"
 #include "cxxtools/xml/endelement.h"
 #include "cxxtools/http/reply.h"
-#include "cxxtools/utf8codec.h"
 #include "cxxtools/convert.h"
 #include "cxxtools/log.h"
 
@@ -49,8 +48,6 @@ namespace xmlrpc
 XmlRpcResponder::XmlRpcResponder(Service& service)
 : http::Responder(service)
 , _state(OnBegin)
-, _ts(new Utf8Codec)
-, _reader(_ts)
 , _formatter(_writer)
 , _service(&service)
 , _proc(0)
@@ -74,30 +71,22 @@ void XmlRpcResponder::beginRequest(net::TcpSocket& /*socket*/, std::istream& is,
 {
     _fault.clear();
     _state = OnBegin;
-    _ts.attach( is );
+    _reader.reset( is );
     _args = 0;
 }
 
 
-std::size_t XmlRpcResponder::readBody(std::istream& /*is*/)
+std::size_t XmlRpcResponder::readBody(std::istream& is)
 {
-    std::size_t n = 0;
+    // the reader consumes all bytes, which are available without blocking
+    std::streamsize avail = is.rdbuf()->in_avail();
 
     try
     {
-        while(true)
+        while( _reader.advance() )
         {
-            std::streamsize m = _ts.buffer().import();
-            if( ! m)
-                break;
-
-            n += m;
-
-            while( _reader.advance() )
-            {
-                const xml::Node& node = _reader.get();
-                this->advance(node);
-            }
+            const xml::Node& node = _reader.get();
+            this->advance(node);
         }
     }
     catch(const xml::XmlError& error)
@@ -119,7 +108,11 @@ std::size_t XmlRpcResponder::readBody(std::istream& /*is*/)
         throw _fault;
     }
 
-    return n;
+    std::streamsize rest = is.rdbuf()->in_avail();
+    if (rest < 0)
+        rest = 0;
+
+    return avail > rest ? avail - rest : 0;
 }
 
 
@@ -314,7 +307,7 @@ void XmlRpcResponder::advance(const cxxtools::xml::Node& node)
                         throw std::runtime_error("too many arguments");
                 }
 
-                _scanner.begin(_deserializer, **_args);
+                _scanner.begin(_deserializer, **_args, _reader);
                 _state = OnParam;
                 break;
             }
@@ -30,6 +30,7 @@
 #include <cxxtools/xml/startelement.h>
 #include <cxxtools/xml/endelement.h>
 #include <cxxtools/xml/characters.h>
+#include <cxxtools/xml/xmlreader.h>
 #include <cxxtools/serializationinfo.h>
 #include <cxxtools/serializationerror.h>
 #include <cxxtools/deserializer.h>
@@ -47,6 +48,17 @@ namespace
     {
         SerializationError::doThrow(msg);
     }
+
+    // indexed by Scanner::Element
+    const wchar_t* const elementNames[] = {
+        L"value", L"struct", L"array", L"member", L"name", L"data", L"param", L"fault"
+    };
+
+    template <typename ElementT>
+    bool isNamed(const ElementT& e, unsigned id, const wchar_t* name)
+    {
+        return id != 0 && e.nameId() != 0 ? e.nameId() == id : e.name() == name;
+    }
 }
 
 void Scanner::begin(Deserializer& handler, IComposer& composer)
@@ -55,6 +67,27 @@ void Scanner::begin(Deserializer& handler, IComposer& composer)
     _deserializer = &handler;
     _composer = &composer;
     _deserializer->begin();
+
+    for (unsigned n = 0; n < ElementCount; ++n)
+        _ids[n] = 0;
+}
+
+void Scanner::begin(Deserializer& handler, IComposer& composer, xml::XmlReader& reader)
+{
+    begin(handler, composer);
+
+    for (unsigned n = 0; n < ElementCount; ++n)
+        _ids[n] = reader.nameId(elementNames[n]);
+}
+
+bool Scanner::isElement(const xml::StartElement& se, Element element) const
+{
+    return isNamed(se, _ids[element], elementNames[element]);
+}
+
+bool Scanner::isElement(const xml::EndElement& ee, Element element) const
+{
+    return isNamed(ee, _ids[element], elementNames[element]);
 }
 
 bool Scanner::advance(const cxxtools::xml::Node& node)
@@ -67,7 +100,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::StartElement& se = static_cast<const xml::StartElement&>(node);
 
-                if(se.name() != L"value")
+                if(!isElement(se, ValueElement))
                     throwSerializationError();
 
                 _state = OnValueBegin;
@@ -86,11 +119,11 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::StartElement& se = static_cast<const xml::StartElement&>(node);
 
-                if(se.name() == L"struct")
+                if(isElement(se, StructElement))
                 {
                     _state = OnStructBegin;
                 }
-                else if(se.name() == L"array")
+                else if(isElement(se, ArrayElement))
                 {
                     _state = OnArrayBegin;
                 }
@@ -112,7 +145,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             else if(node.type() == xml::Node::EndElement)
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
-                if(ee.name() != L"value")
+                if(!isElement(ee, ValueElement))
                     throwSerializationError();
 
                 // is always type string
@@ -135,18 +168,18 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
 
-                if(ee.name() == L"member")
+                if(isElement(ee, MemberElement))
                 {
                     _deserializer->leaveMember();
                     _state = OnStructBegin;
                 }
-                else if(ee.name() == L"data")
+                else if(isElement(ee, DataElement))
                 {
                     _deserializer->leaveMember();
                     _state = OnDataEnd;
                 }
-                else if(ee.name() == L"param"
-                     || ee.name() == L"fault")
+                else if(isElement(ee, ParamElement)
+                     || isElement(ee, FaultElement))
                 {
                     _composer->fixup(_deserializer->si());
                     return true;
@@ -159,7 +192,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             else if(node.type() == xml::Node::StartElement)
             {
                 const xml::StartElement& se = static_cast<const xml::StartElement&>(node);
-                if(se.name() == L"value")
+                if(isElement(se, ValueElement))
                 {
                     _deserializer->leaveMember();
                     _deserializer->beginMember(std::string(), _type.narrow(), SerializationInfo::Value);
@@ -180,7 +213,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::StartElement& se = static_cast<const xml::StartElement&>(node);
 
-                if(se.name() != L"member")
+                if(!isElement(se, MemberElement))
                     throwSerializationError();
 
                 _state = OnMemberBegin;
@@ -198,7 +231,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
 
-                if(ee.name() != L"value")
+                if(!isElement(ee, ValueElement))
                     throwSerializationError();
 
                 _state = OnValueEnd;
@@ -217,7 +250,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::StartElement& se = static_cast<const xml::StartElement&>(node);
 
-                if(se.name() != L"name")
+                if(!isElement(se, NameElement))
                     throwSerializationError();
 
                 _state = OnNameBegin;
@@ -255,7 +288,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
 
-                if(ee.name() != L"name")
+                if(!isElement(ee, NameElement))
                     throwSerializationError();
 
                 _state = OnNameEnd;
@@ -274,7 +307,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::StartElement& se = static_cast<const xml::StartElement&>(node);
 
-                if(se.name() != L"value")
+                if(!isElement(se, ValueElement))
                     throwSerializationError();
 
                 _state = OnValueBegin;
@@ -330,7 +363,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
 
-                if(ee.name() != L"value")
+                if(!isElement(ee, ValueElement))
                     throwSerializationError();
 
                 _state = OnValueEnd;
@@ -349,7 +382,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::StartElement& se = static_cast<const xml::StartElement&>(node);
 
-                if(se.name() != L"data")
+                if(!isElement(se, DataElement))
                     throwSerializationError();
 
                 _state = OnDataBegin;
@@ -372,7 +405,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             else if(node.type() == xml::Node::EndElement) // empty array
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
-                if(ee.name() != L"data")
+                if(!isElement(ee, DataElement))
                     throwSerializationError();
 
                 _state = OnDataEnd;
@@ -387,7 +420,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
 
-                if(ee.name() != L"array")
+                if(!isElement(ee, ArrayElement))
                     throwSerializationError();
 
                 _state = OnArrayEnd;
@@ -406,7 +439,7 @@ bool Scanner::advance(const cxxtools::xml::Node& node)
             {
                 const xml::EndElement& ee = static_cast<const xml::EndElement&>(node);
 
-                if(ee.name() != L"value")
+                if(!isElement(ee, ValueElement))
                     throwSerializationError();
 
                 _state = OnValueEnd;
@@ -89,6 +89,7 @@ class BinRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &BinRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &BinRpcTest::Connect);
             registerMethod("Multiple", *this, &BinRpcTest::Multiple);
+            registerMethod("MultipleIoUring", *this, &BinRpcTest::MultipleIoUring);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -804,6 +805,25 @@ class BinRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        void MultipleIoUring()
+        {
+            // skipped, where io_uring is not available
+            if (!_loop.useIoUring())
+                return;
+
+            try
+            {
+                Multiple();
+            }
+            catch (...)
+            {
+                _loop.useIoUring(false);
+                throw;
+            }
+
+            _loop.useIoUring(false);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<BinRpcTest> register_BinRpcTest;
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/cache.h>
+#include <cxxtools/lrucache.h>
+#include <cxxtools/concurrentcache.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+
+// Compares the throughput of the thread safe ConcurrentCache with
+// LruCache and Cache guarded by a mutex. The keys follow a zipfian
+// distribution.
+
+namespace
+{
+    std::vector<unsigned> keys;
+
+    // generates keys 0..n-1 with probability proportional to 1/(k+1)^s
+    void createKeys(unsigned n, double s, unsigned count)
+    {
+        std::vector<double> cdf(n);
+        double sum = 0;
+        for (unsigned k = 0; k < n; ++k)
+        {
+            sum += 1.0 / pow(k + 1, s);
+            cdf[k] = sum;
+        }
+
+        keys.resize(count);
+        unsigned long r = 4711;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            r = r * 6364136223846793005ul + 1442695040888963407ul;
+            double u = static_cast<double>(r >> 11) / 9007199254740992.0 * sum;
+            keys[i] = std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        }
+    }
+
+    template <typename CacheType>
+    class LockedCache
+    {
+            cxxtools::Mutex _mutex;
+            CacheType _cache;
+
+        public:
+            explicit LockedCache(unsigned size)
+                : _cache(size)
+            { }
+
+            std::pair<bool, unsigned> getx(unsigned key)
+            {
+                cxxtools::MutexLock lock(_mutex);
+                return _cache.getx(key);
+            }
+
+            void put(unsigned key, unsigned value)
+            {
+                cxxtools::MutexLock lock(_mutex);
+                _cache.put(key, value);
+            }
+
+            double hitRatio()
+            {
+                cxxtools::MutexLock lock(_mutex);
+                return _cache.hitRatio();
+            }
+    };
+
+    template <typename CacheType>
+    class CacheBench
+    {
+            CacheType& _cache;
+            unsigned _ops;
+            cxxtools::atomic_t _nextThread;
+
+            void access()
+            {
+                unsigned offset = static_cast<unsigned>(cxxtools::atomicIncrement(_nextThread)) * 7919;
+                for (unsigned n = 0; n < _ops; ++n)
+                {
+                    unsigned key = keys[(offset + n) % keys.size()];
+                    if (!_cache.getx(key).first)
+                        _cache.put(key, key);
+                }
+            }
+
+        public:
+            CacheBench(CacheType& cache, unsigned ops)
+                : _cache(cache),
+                  _ops(ops),
+                  _nextThread(0)
+            { }
+
+            void run(const char* name, unsigned threads)
+            {
+                std::vector<cxxtools::AttachedThread*> t;
+                for (unsigned n = 0; n < threads; ++n)
+                    t.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &CacheBench::access)));
+
+                cxxtools::Clock clock;
+                clock.start();
+
+                for (unsigned n = 0; n < threads; ++n)
+                    t[n]->start();
+
+                for (unsigned n = 0; n < threads; ++n)
+                {
+                    t[n]->join();
+                    delete t[n];
+                }
+
+                cxxtools::Timespan ts = clock.stop();
+                unsigned total = _ops * threads;
+
+                std::cout << name << '\t' << threads << " threads\t"
+                          << total << " lookups in " << ts.totalSeconds() << " s => "
+                          << (total / ts.totalSeconds()) << "#/s hit ratio "
+                          << _cache.hitRatio() << std::endl;
+            }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 32);
+        cxxtools::Arg<unsigned> ops(argc, argv, 'n', 1000000);
+        cxxtools::Arg<unsigned> numKeys(argc, argv, 'k', 100000);
+        cxxtools::Arg<unsigned> size(argc, argv, 's', 10000);
+        cxxtools::Arg<double> skew(argc, argv, 'z', 0.99);
+        cxxtools::Arg<bool> noCache(argc, argv, 'C');
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -T number  maximum number of threads (default: 32)\n"
+                         "   -n number  number of lookups (default: 1000000)\n"
+                         "   -k number  number of distinct keys (default: 100000)\n"
+                         "   -s number  cache size (default: 10000)\n"
+                         "   -z number  zipf skew (default: 0.99)\n"
+                         "   -C         skip the slow cxxtools::Cache\n";
+            return -1;
+        }
+
+        createKeys(numKeys, skew, 1 << 20);
+
+        for (unsigned t = 1; t <= maxThreads; t *= 2)
+        {
+            unsigned perThread = ops / t;
+
+            {
+                LockedCache<cxxtools::LruCache<unsigned, unsigned> > cache(size);
+                CacheBench<LockedCache<cxxtools::LruCache<unsigned, unsigned> > > bench(cache, perThread);
+                bench.run("LruCache", t);
+            }
+
+            if (!noCache)
+            {
+                LockedCache<cxxtools::Cache<unsigned, unsigned> > cache(size);
+                CacheBench<LockedCache<cxxtools::Cache<unsigned, unsigned> > > bench(cache, perThread);
+                bench.run("Cache", t);
+            }
+
+            {
+                cxxtools::ConcurrentCache<unsigned, unsigned> cache(size);
+                CacheBench<cxxtools::ConcurrentCache<unsigned, unsigned> > bench(cache, perThread);
+                bench.run("ConcurrentCache", t);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
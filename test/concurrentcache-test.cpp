@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/concurrentcache.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <vector>
+
+class ConcurrentCacheTest : public cxxtools::unit::TestSuite
+{
+        cxxtools::ConcurrentCache<unsigned, unsigned>* _cache;
+
+    public:
+        ConcurrentCacheTest()
+        : cxxtools::unit::TestSuite("concurrentcache"),
+          _cache(0)
+        {
+            registerMethod("putGet", *this, &ConcurrentCacheTest::putGet);
+            registerMethod("evict", *this, &ConcurrentCacheTest::evict);
+            registerMethod("erase", *this, &ConcurrentCacheTest::erase);
+            registerMethod("ttl", *this, &ConcurrentCacheTest::ttl);
+            registerMethod("stringKey", *this, &ConcurrentCacheTest::stringKey);
+            registerMethod("threads", *this, &ConcurrentCacheTest::threads);
+        }
+
+        void putGet()
+        {
+            cxxtools::ConcurrentCache<int, int> cache(100);
+
+            cache.put(1, 10);
+            cache.put(2, 20);
+            cache.put(2, 21);
+
+            std::pair<bool, int> result = cache.getx(1);
+            CXXTOOLS_UNIT_ASSERT(result.first);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result.second, 10);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(2), 21);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(3, 42), 42);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 2u);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 1u);
+        }
+
+        void evict()
+        {
+            // a single shard makes the clock order predictable
+            cxxtools::ConcurrentCache<int, int> cache(4, 1);
+
+            for (int n = 1; n <= 4; ++n)
+                cache.put(n, n * 10);
+
+            // the first round clears all reference flags and drops element 1
+            cache.put(5, 50);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 4u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getEvictions(), 1u);
+            CXXTOOLS_UNIT_ASSERT(!cache.getx(1).first);
+
+            // a hit protects element 2 from the next eviction
+            CXXTOOLS_UNIT_ASSERT(cache.getx(2).first);
+            cache.put(6, 60);
+            CXXTOOLS_UNIT_ASSERT(cache.getx(2).first);
+            CXXTOOLS_UNIT_ASSERT(!cache.getx(3).first);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getEvictions(), 2u);
+        }
+
+        void erase()
+        {
+            cxxtools::ConcurrentCache<int, int> cache(10);
+            cache.put(1, 10);
+            cache.put(2, 20);
+
+            CXXTOOLS_UNIT_ASSERT(cache.erase(1));
+            CXXTOOLS_UNIT_ASSERT(!cache.erase(1));
+            CXXTOOLS_UNIT_ASSERT(!cache.getx(1).first);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 1u);
+
+            cache.clear();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 0u);
+            CXXTOOLS_UNIT_ASSERT(!cache.getx(2).first);
+        }
+
+        void ttl()
+        {
+            cxxtools::ConcurrentCache<int, int> cache(10, 1, cxxtools::Milliseconds(20));
+            cache.put(1, 10);
+            CXXTOOLS_UNIT_ASSERT(cache.getx(1).first);
+
+            cxxtools::Thread::sleep(cxxtools::Milliseconds(40));
+            CXXTOOLS_UNIT_ASSERT(!cache.getx(1).first);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 0u);
+        }
+
+        void stringKey()
+        {
+            cxxtools::ConcurrentCache<std::string, std::string> cache(10);
+            cache.put("foo", "bar");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get("foo"), "bar");
+            CXXTOOLS_UNIT_ASSERT(!cache.getx("bar").first);
+        }
+
+        void access()
+        {
+            for (unsigned n = 0; n < 20000; ++n)
+            {
+                unsigned key = (n * 7919) % 500;
+                std::pair<bool, unsigned> v = _cache->getx(key);
+                if (v.first)
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(v.second, key * 2);
+                else
+                    _cache->put(key, key * 2);
+            }
+        }
+
+        void threads()
+        {
+            cxxtools::ConcurrentCache<unsigned, unsigned> cache(256, 4);
+            _cache = &cache;
+
+            std::vector<cxxtools::AttachedThread*> threads;
+            for (unsigned n = 0; n < 4; ++n)
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &ConcurrentCacheTest::access)));
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+                threads[n]->start();
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+            {
+                threads[n]->join();
+                delete threads[n];
+            }
+
+            _cache = 0;
+
+            CXXTOOLS_UNIT_ASSERT(cache.size() <= 256);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits() + cache.getMisses(), 80000u);
+        }
+};
+
+cxxtools::unit::RegisterTest<ConcurrentCacheTest> register_ConcurrentCacheTest;
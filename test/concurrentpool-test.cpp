@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/concurrentpool.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <vector>
+
+class ConcurrentPoolTest : public cxxtools::unit::TestSuite
+{
+    struct Object
+    {
+      static cxxtools::atomic_t instCount;
+      static cxxtools::atomic_t ctorCount;
+
+      Object()
+      { cxxtools::atomicIncrement(instCount); cxxtools::atomicIncrement(ctorCount); }
+      ~Object()
+      { cxxtools::atomicDecrement(instCount); }
+    };
+
+    typedef cxxtools::ConcurrentPool<Object> PoolType;
+
+    PoolType* _pool;
+
+    void worker()
+    {
+      for (unsigned n = 0; n < 10000; ++n)
+      {
+        PoolType::Ptr p1 = _pool->get();
+        PoolType::Ptr p2 = _pool->get();
+        PoolType::Ptr p3 = p1;
+      }
+    }
+
+  public:
+    ConcurrentPoolTest()
+    : cxxtools::unit::TestSuite("concurrentpool")
+    {
+      registerMethod("reuse", *this, &ConcurrentPoolTest::reuse);
+      registerMethod("release", *this, &ConcurrentPoolTest::release);
+      registerMethod("prewarm", *this, &ConcurrentPoolTest::prewarm);
+      registerMethod("watermarks", *this, &ConcurrentPoolTest::watermarks);
+      registerMethod("threads", *this, &ConcurrentPoolTest::threads);
+    }
+
+    void setUp()
+    {
+      Object::instCount = 0;
+      Object::ctorCount = 0;
+    }
+
+    void reuse()
+    {
+      {
+        PoolType pool;
+
+        {
+          PoolType::Ptr p = pool.get();
+          CXXTOOLS_UNIT_ASSERT_EQUALS(Object::ctorCount, 1);
+        }
+
+        {
+          PoolType::Ptr p = pool.get();
+          PoolType::Ptr p2 = p;
+          CXXTOOLS_UNIT_ASSERT(p2.getPointer() == p.getPointer());
+        }
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(Object::ctorCount, 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 1);
+      }
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 0);
+    }
+
+    void release()
+    {
+      PoolType pool;
+
+      {
+        PoolType::Ptr p = pool.get();
+        p.release();
+      }
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 0);
+
+      {
+        PoolType::Ptr p = pool.get();
+      }
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::ctorCount, 2);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 1);
+    }
+
+    void prewarm()
+    {
+      PoolType pool(8);
+      pool.prewarm(5);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 5u);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 5);
+
+      {
+        PoolType::Ptr p = pool.get();
+        CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 4u);
+      }
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::ctorCount, 5);
+
+      // prewarm is limited by the high watermark
+      pool.prewarm(20);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 8u);
+    }
+
+    void watermarks()
+    {
+      PoolType pool(4, 2);
+
+      {
+        std::vector<PoolType::Ptr> objects;
+        for (unsigned n = 0; n < 100; ++n)
+          objects.push_back(pool.get());
+      }
+
+      // 4 objects in the shared stack and up to 16 in the magazine
+      CXXTOOLS_UNIT_ASSERT(Object::instCount <= 20);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 4u);
+
+      pool.trim();
+      CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 2u);
+
+      pool.drop();
+      CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 0u);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 0);
+    }
+
+    void threads()
+    {
+      {
+        PoolType pool(64);
+        _pool = &pool;
+
+        std::vector<cxxtools::AttachedThread*> threads;
+        for (unsigned n = 0; n < 4; ++n)
+          threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &ConcurrentPoolTest::worker)));
+
+        for (unsigned n = 0; n < threads.size(); ++n)
+          threads[n]->start();
+
+        for (unsigned n = 0; n < threads.size(); ++n)
+        {
+          threads[n]->join();
+          delete threads[n];
+        }
+
+        CXXTOOLS_UNIT_ASSERT(Object::ctorCount < 100);
+      }
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 0);
+    }
+
+};
+
+cxxtools::atomic_t ConcurrentPoolTest::Object::instCount = 0;
+cxxtools::atomic_t ConcurrentPoolTest::Object::ctorCount = 0;
+
+cxxtools::unit::RegisterTest<ConcurrentPoolTest> register_ConcurrentPoolTest;
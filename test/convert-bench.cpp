@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/convert.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // the results are summed up here, so that the compiler can't drop the work
+    unsigned long sink = 0;
+
+    uint64_t nextRandom(uint64_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    void report(const char* what, unsigned long count, const cxxtools::Timespan& t)
+    {
+        double secs = t.totalMSecs() / 1000.0;
+        std::cout << what << '\t' << count << " in " << secs << " s => "
+                  << (count / secs / 1e6) << " M/s" << std::endl;
+    }
+
+    void benchIntFormat(const std::vector<int>& values)
+    {
+        char buffer[32];
+
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            for (unsigned n = 0; n < values.size(); ++n)
+            {
+                char* end = buffer + sizeof(buffer);
+                sink += end - cxxtools::formatDecimal(end, values[n]);
+            }
+            report("formatDecimal(int)", values.size(), clock.stop());
+        }
+
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            std::string s;
+            for (unsigned n = 0; n < values.size(); ++n)
+            {
+                cxxtools::convert(s, values[n]);
+                sink += s.size();
+            }
+            report("convert(int)\t", values.size(), clock.stop());
+        }
+
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            for (unsigned n = 0; n < values.size(); ++n)
+                sink += std::snprintf(buffer, sizeof(buffer), "%d", values[n]);
+            report("snprintf(%d)\t", values.size(), clock.stop());
+        }
+    }
+
+    void benchDoubleFormat(const std::vector<double>& values)
+    {
+        char buffer[512];
+
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            for (unsigned n = 0; n < values.size(); ++n)
+                sink += cxxtools::putFloat(buffer, values[n]) - buffer;
+            report("putFloat shortest", values.size(), clock.stop());
+        }
+
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            const int precision = std::numeric_limits<double>::digits10 - 1;
+            for (unsigned n = 0; n < values.size(); ++n)
+                sink += cxxtools::putFloat(buffer, values[n], cxxtools::FloatFormat<char>(), precision) - buffer;
+            report("putFloat precision", values.size(), clock.stop());
+        }
+
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            for (unsigned n = 0; n < values.size(); ++n)
+                sink += std::snprintf(buffer, sizeof(buffer), "%.17g", values[n]);
+            report("snprintf(%.17g)", values.size(), clock.stop());
+        }
+    }
+
+    template <typename T>
+    void benchParse(const char* what, const char* cwhat, const std::vector<std::string>& strings,
+                    T (*cparse)(const char*))
+    {
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            T value;
+            for (unsigned n = 0; n < strings.size(); ++n)
+            {
+                cxxtools::convert(value, strings[n]);
+                sink += static_cast<unsigned long>(value != 0);
+            }
+            report(what, strings.size(), clock.stop());
+        }
+
+        {
+            cxxtools::Clock clock;
+            clock.start();
+            for (unsigned n = 0; n < strings.size(); ++n)
+                sink += static_cast<unsigned long>(cparse(strings[n].c_str()) != 0);
+            report(cwhat, strings.size(), clock.stop());
+        }
+    }
+
+    double parseDouble(const char* s)
+    { return std::strtod(s, 0); }
+
+    int parseInt(const char* s)
+    { return static_cast<int>(std::strtol(s, 0, 10)); }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> count(argc, argv, 'n', 1000000);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -n number  number of values (default: 1000000)\n";
+            return -1;
+        }
+
+        uint64_t state = 0x2545f4914f6cdd1dull;
+
+        std::vector<int> ints;
+        std::vector<double> doubles;
+        std::vector<std::string> intStrings;
+        std::vector<std::string> doubleStrings;
+
+        for (unsigned n = 0; n < count; ++n)
+        {
+            int i = static_cast<int>(nextRandom(state) >> (33 + n % 30));
+            if (n % 2)
+                i = -i;
+            ints.push_back(i);
+            intStrings.push_back(cxxtools::convert<std::string>(i));
+
+            // values with few digits like in typical data and random ones
+            double d = (n % 2) ? static_cast<double>(nextRandom(state) % 1000000) / 100
+                               : static_cast<double>(nextRandom(state) >> 11) / 9007199254740992.0 * 1e6;
+            doubles.push_back(d);
+
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", d);
+            doubleStrings.push_back(buffer);
+        }
+
+        benchIntFormat(ints);
+        benchDoubleFormat(doubles);
+        benchParse<int>("convert(string, int)", "strtol\t\t", intStrings, parseInt);
+        benchParse<double>("convert(string, double)", "strtod\t\t", doubleStrings, parseDouble);
+
+        std::cerr << sink % 2 << '\r';
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -33,6 +33,7 @@
 #include "cxxtools/log.h"
 #include <limits>
 #include <string.h>
+#include <stdlib.h>
 
 log_define("cxxtools.test.convert")
 
@@ -43,6 +44,15 @@ namespace
         double q = v1 / v2;
         return q > 1 - e && q < 1 + e;
     }
+
+    // simple xorshift generator, so that the tests are reproducible
+    uint64_t nextRandom(uint64_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
 }
 
 class ConvertTest : public cxxtools::unit::TestSuite
@@ -57,6 +67,10 @@ class ConvertTest : public cxxtools::unit::TestSuite
             registerMethod("infTest", *this, &ConvertTest::infTest);
             registerMethod("emptyTest", *this, &ConvertTest::emptyTest);
             registerMethod("floatTest", *this, &ConvertTest::floatTest);
+            registerMethod("shortestTest", *this, &ConvertTest::shortestTest);
+            registerMethod("roundTripTest", *this, &ConvertTest::roundTripTest);
+            registerMethod("exactParseTest", *this, &ConvertTest::exactParseTest);
+            registerMethod("intTest", *this, &ConvertTest::intTest);
         }
 
         void successTest()
@@ -281,6 +295,109 @@ class ConvertTest : public cxxtools::unit::TestSuite
           t(12);
         }
 
+        void shortestTest()
+        {
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1 + 0.2), "0.30000000000000004");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(-345.75), "-345.75");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1e6), "1000000");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.00123), "0.00123");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(3.141592653589793), "3.141592653589793");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.0), "0");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(3.14159f), "3.14159");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1f), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<cxxtools::String>(2.5), cxxtools::String(L"2.5"));
+        }
+
+        void roundTripTest()
+        {
+          uint64_t state = 0x2545f4914f6cdd1dull;
+          for (unsigned n = 0; n < 100000; ++n)
+          {
+            uint64_t bits = nextRandom(state);
+
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            if (d == d && d - d == 0)
+            {
+              std::string s = cxxtools::convert<std::string>(d);
+              double r = cxxtools::convert<double>(s);
+              if (memcmp(&d, &r, sizeof(d)) != 0)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(s, cxxtools::convert<std::string>(r));
+            }
+
+            uint32_t fbits = static_cast<uint32_t>(bits >> 16);
+            float f;
+            memcpy(&f, &fbits, sizeof(f));
+            if (f == f && f - f == 0)
+            {
+              std::string s = cxxtools::convert<std::string>(f);
+              float r = cxxtools::convert<float>(s);
+              if (memcmp(&f, &r, sizeof(f)) != 0)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(s, cxxtools::convert<std::string>(r));
+            }
+          }
+        }
+
+        void exactParseTest()
+        {
+          // halfway cases and values near the limits
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("9007199254740993"), 9007199254740992.0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("9007199254740993.000000000000000000001"), 9007199254740994.0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("1.7976931348623157e308"), std::numeric_limits<double>::max());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("2.2250738585072014e-308"), std::numeric_limits<double>::min());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("4.9406564584124654e-324"), std::numeric_limits<double>::denorm_min());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("1e-400"), 0.0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("1e400"), std::numeric_limits<double>::infinity());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("-15"), -15.0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<float>("16777217"), 16777216.0f);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<double>("."), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<double>("1e"), cxxtools::ConversionError);
+
+          // random decimal strings compared with the c library
+          uint64_t state = 0x9e3779b97f4a7c15ull;
+          for (unsigned n = 0; n < 20000; ++n)
+          {
+            std::string s;
+            unsigned digits = 1 + nextRandom(state) % 25;
+            for (unsigned d = 0; d < digits; ++d)
+            {
+              s += static_cast<char>('0' + nextRandom(state) % 10);
+              if (d == 0 && nextRandom(state) % 2)
+                s += '.';
+            }
+
+            s += 'e';
+            s += cxxtools::convert<std::string>(static_cast<int>(nextRandom(state) % 700) - 350);
+
+            double d = cxxtools::convert<double>(s);
+            double expected = strtod(s.c_str(), 0);
+            if (memcmp(&d, &expected, sizeof(d)) != 0)
+              CXXTOOLS_UNIT_ASSERT_EQUALS(s + '=' + cxxtools::convert<std::string>(d),
+                                          s + '=' + cxxtools::convert<std::string>(expected));
+
+            float f = cxxtools::convert<float>(s);
+            float fexpected = strtof(s.c_str(), 0);
+            if (memcmp(&f, &fexpected, sizeof(f)) != 0)
+              CXXTOOLS_UNIT_ASSERT_EQUALS(s + '=' + cxxtools::convert<std::string>(f),
+                                          s + '=' + cxxtools::convert<std::string>(fexpected));
+          }
+        }
+
+        void intTest()
+        {
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0), "0");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(7), "7");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(-42), "-42");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(100), "100");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(std::numeric_limits<int>::min()), "-2147483648");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(std::numeric_limits<int>::max()), "2147483647");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(std::numeric_limits<int64_t>::min()), "-9223372036854775808");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(std::numeric_limits<uint64_t>::max()), "18446744073709551615");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(static_cast<signed char>(-128)), "-128");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<cxxtools::String>(-1234567), cxxtools::String(L"-1234567"));
+        }
+
 };
 
 cxxtools::unit::RegisterTest<ConvertTest> register_ConvertTest;
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/csvreader.h>
+#include <cxxtools/csvdeserializer.h>
+#include <cxxtools/csvparallelreader.h>
+#include <cxxtools/csvserializer.h>
+#include <cxxtools/function.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
+
+namespace
+{
+    struct Record
+    {
+        int id;
+        std::string name;
+        double value;
+    };
+
+    void operator>>= (const cxxtools::SerializationInfo& si, Record& r)
+    {
+        si.getMember("id") >>= r.id;
+        si.getMember("name") >>= r.name;
+        si.getMember("value") >>= r.value;
+    }
+
+    void operator<<= (cxxtools::SerializationInfo& si, const Record& r)
+    {
+        si.addMember("id") <<= r.id;
+        si.addMember("name") <<= r.name;
+        si.addMember("value") <<= r.value;
+    }
+
+    std::string generate(unsigned rows)
+    {
+        std::ostringstream data;
+        data << "id,name,value\n";
+        for (unsigned n = 0; n < rows; ++n)
+        {
+            data << n << ',';
+            if (n % 10 == 0)
+                data << "\"quoted, \"\"name\"\" " << n << '"';
+            else
+                data << "name " << n;
+            data << ',' << (n * 0.25) << '\n';
+        }
+
+        return data.str();
+    }
+
+    void report(const char* what, const std::string& data, unsigned long rows, const cxxtools::Timespan& t)
+    {
+        double secs = t.totalMSecs() / 1000.0;
+        std::cout << what << '\t' << rows << " rows in " << secs << " s => "
+                  << (data.size() / secs / 1e6) << " MB/s" << std::endl;
+    }
+
+    void benchDeserializer(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        std::vector<Record> records;
+        cxxtools::CsvDeserializer deserializer;
+        deserializer.read(in);
+        deserializer.deserialize(records);
+
+        report("CsvDeserializer", data, records.size(), clock.stop());
+    }
+
+    void benchFields(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        cxxtools::CsvReader reader(in);
+        unsigned long rows = 0;
+        std::string value;
+        while (reader.next())
+        {
+            for (unsigned n = 0; n < reader.size(); ++n)
+                reader[n].get(value);
+            ++rows;
+        }
+
+        report("CsvReader fields", data, rows, clock.stop());
+    }
+
+    void benchObjects(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        cxxtools::CsvReader reader(in);
+        unsigned long rows = 0;
+        Record r;
+        while (reader.next())
+        {
+            reader >>= r;
+            ++rows;
+        }
+
+        report("CsvReader objects", data, rows, clock.stop());
+    }
+
+    void benchFile(const std::string& data)
+    {
+        char fname[] = "/tmp/csv-bench.XXXXXX";
+        int fd = ::mkstemp(fname);
+        if (fd < 0)
+            return;
+        ::close(fd);
+
+        {
+            std::ofstream out(fname);
+            out << data;
+        }
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        cxxtools::CsvReader reader;
+        reader.open(fname);
+        unsigned long rows = 0;
+        std::string value;
+        while (reader.next())
+        {
+            for (unsigned n = 0; n < reader.size(); ++n)
+                reader[n].get(value);
+            ++rows;
+        }
+
+        report("CsvReader file", data, rows, clock.stop());
+
+        std::remove(fname);
+    }
+
+    void benchSerializer(unsigned rows)
+    {
+        std::vector<Record> records(rows);
+        for (unsigned n = 0; n < rows; ++n)
+        {
+            records[n].id = n;
+            std::ostringstream name;
+            if (n % 10 == 0)
+                name << "quoted, \"name\" " << n;
+            else
+                name << "name " << n;
+            records[n].name = name.str();
+            records[n].value = n * 0.25;
+        }
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::ostringstream out;
+        cxxtools::CsvSerializer serializer(out);
+        serializer.serialize(records);
+
+        cxxtools::Timespan t = clock.stop();
+        double secs = t.totalMSecs() / 1000.0;
+        std::cout << "CsvSerializer\t" << rows << " rows in " << secs << " s => "
+                  << (rows / secs) << " rows/s, " << (out.str().size() / secs / 1e6) << " MB/s" << std::endl;
+
+        // the formatter alone without building the serialization info
+        cxxtools::SerializationInfo si;
+        si <<= records;
+
+        clock.start();
+
+        std::ostringstream fout;
+        cxxtools::CsvFormatter formatter(fout);
+        cxxtools::IDecomposer::formatEach(si, formatter);
+        formatter.finish();
+
+        t = clock.stop();
+        secs = t.totalMSecs() / 1000.0;
+        std::cout << "CsvFormatter\t" << rows << " rows in " << secs << " s => "
+                  << (rows / secs) << " rows/s, " << (fout.str().size() / secs / 1e6) << " MB/s" << std::endl;
+    }
+
+    cxxtools::atomic_t parsedRows = 0;
+
+    void onRow(const cxxtools::CsvReader& reader)
+    {
+        Record r;
+        reader >>= r;
+        cxxtools::atomicIncrement(parsedRows);
+    }
+
+    void benchParallel(const std::string& data, unsigned threads, bool ordered)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        cxxtools::CsvParallelReader reader(data.data(), data.size());
+        reader.threads(threads);
+        reader.ordered(ordered);
+        cxxtools::atomicSet(parsedRows, 0);
+        reader.read(cxxtools::callable(onRow));
+
+        std::cout << threads << " threads\t";
+        report(ordered ? "ordered" : "unordered", data, cxxtools::atomicGet(parsedRows), clock.stop());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> rows(argc, argv, 'n', 1000000);
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 16);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -n number  number of rows (default: 1000000)\n"
+                         "   -T number  maximum number of threads for parallel parsing (default: 16)\n";
+            return -1;
+        }
+
+        benchSerializer(rows);
+
+        std::string data = generate(rows);
+
+        benchDeserializer(data);
+        benchFields(data);
+        benchObjects(data);
+        benchFile(data);
+
+        // the rows are deserialized into objects in the callback
+        for (unsigned t = 1; t <= maxThreads; t *= 2)
+        {
+            benchParallel(data, t, true);
+            benchParallel(data, t, false);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/csvparallelreader.h"
+#include "cxxtools/serializationerror.h"
+#include "cxxtools/method.h"
+#include "cxxtools/mutex.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    class StopError : public std::runtime_error
+    {
+        public:
+            StopError()
+                : std::runtime_error("stop")
+            { }
+    };
+}
+
+class CsvParallelReaderTest : public cxxtools::unit::TestSuite
+{
+        typedef std::vector<std::string> Row;
+
+        cxxtools::Mutex _mutex;
+        std::vector<Row> _rows;
+        std::vector<unsigned> _lineNos;
+        unsigned _throwAt;
+
+        void onRow(const cxxtools::CsvReader& reader)
+        {
+            Row row;
+            for (unsigned n = 0; n < reader.size(); ++n)
+                row.push_back(reader[n].str());
+
+            cxxtools::MutexLock lock(_mutex);
+            _rows.push_back(row);
+            _lineNos.push_back(reader.lineNo());
+
+            if (_rows.size() == _throwAt)
+                throw StopError();
+        }
+
+        static std::string data()
+        {
+            // quoted line breaks and long rows make the split points wrong
+            std::ostringstream s;
+            s << "id,text,value\r\n";
+            for (unsigned n = 0; n < 500; ++n)
+            {
+                s << n << ',';
+                if (n % 7 == 0)
+                    s << "\"multi\nline \"\"" << n << "\"\"\r\nvalue\"";
+                else if (n % 11 == 0)
+                    s << std::string(300, 'a' + n % 26);
+                else
+                    s << "text " << n;
+                s << ',' << n * 3 << (n % 2 ? "\n" : "\r\n");
+            }
+            return s.str();
+        }
+
+        std::vector<Row> sequential(const std::string& csv, std::vector<unsigned>* lineNos = 0)
+        {
+            std::vector<Row> rows;
+            cxxtools::CsvReader reader(csv.data(), csv.size());
+            while (reader.next())
+            {
+                Row row;
+                for (unsigned n = 0; n < reader.size(); ++n)
+                    row.push_back(reader[n].str());
+                rows.push_back(row);
+                if (lineNos)
+                    lineNos->push_back(reader.lineNo());
+            }
+            return rows;
+        }
+
+    public:
+        CsvParallelReaderTest()
+            : cxxtools::unit::TestSuite("csvparallelreader")
+        {
+            registerMethod("testOrdered", *this, &CsvParallelReaderTest::testOrdered);
+            registerMethod("testUnordered", *this, &CsvParallelReaderTest::testUnordered);
+            registerMethod("testNoTitle", *this, &CsvParallelReaderTest::testNoTitle);
+            registerMethod("testColumnMismatch", *this, &CsvParallelReaderTest::testColumnMismatch);
+            registerMethod("testCallbackError", *this, &CsvParallelReaderTest::testCallbackError);
+        }
+
+        void setUp()
+        {
+            _rows.clear();
+            _lineNos.clear();
+            _throwAt = 0;
+        }
+
+        void testOrdered()
+        {
+            std::string csv = data();
+            std::vector<unsigned> expectedLineNos;
+            std::vector<Row> expected = sequential(csv, &expectedLineNos);
+
+            static const std::size_t chunkSizes[] = { 1, 7, 64, 333, 4096, 1000000 };
+            unsigned misspeculations = 0;
+            for (unsigned c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++c)
+            {
+                setUp();
+
+                cxxtools::CsvParallelReader reader(csv.data(), csv.size());
+                reader.threads(4);
+                reader.chunkSize(chunkSizes[c]);
+
+                unsigned long count = reader.read(cxxtools::callable(*this, &CsvParallelReaderTest::onRow));
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(count, expected.size());
+                CXXTOOLS_UNIT_ASSERT(_rows == expected);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reader.titles().size(), 3u);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reader.titles()[1], "text");
+
+                CXXTOOLS_UNIT_ASSERT(_lineNos == expectedLineNos);
+
+                misspeculations += reader.misspeculations();
+            }
+
+            CXXTOOLS_UNIT_ASSERT(misspeculations > 0);
+        }
+
+        void testUnordered()
+        {
+            std::string csv = data();
+            std::vector<unsigned> expectedLineNos;
+            std::vector<Row> expected = sequential(csv, &expectedLineNos);
+            std::sort(expected.begin(), expected.end());
+
+            cxxtools::CsvParallelReader reader(csv.data(), csv.size());
+            reader.threads(4);
+            reader.chunkSize(100);
+            reader.ordered(false);
+
+            unsigned long count = reader.read(cxxtools::callable(*this, &CsvParallelReaderTest::onRow));
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(count, expected.size());
+            std::sort(_rows.begin(), _rows.end());
+            CXXTOOLS_UNIT_ASSERT(_rows == expected);
+
+            std::sort(_lineNos.begin(), _lineNos.end());
+            CXXTOOLS_UNIT_ASSERT(_lineNos == expectedLineNos);
+        }
+
+        void testNoTitle()
+        {
+            std::string csv = "a;b\n'c\nd';e\nf;g";
+
+            cxxtools::CsvParallelReader reader(csv.data(), csv.size());
+            reader.threads(2);
+            reader.chunkSize(2);
+            reader.readTitle(false);
+            reader.delimiter(';');
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.read(cxxtools::callable(*this, &CsvParallelReaderTest::onRow)), 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_rows.size(), 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_rows[0][0], "a");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_rows[1][0], "c\nd");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_rows[2][1], "g");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_lineNos[1], 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_lineNos[2], 4u);
+        }
+
+        void testColumnMismatch()
+        {
+            std::string csv = data() + "1,2\n" + data();
+
+            for (unsigned ordered = 0; ordered < 2; ++ordered)
+            {
+                setUp();
+
+                cxxtools::CsvParallelReader reader(csv.data(), csv.size());
+                reader.threads(3);
+                reader.chunkSize(50);
+                reader.ordered(ordered);
+
+                CXXTOOLS_UNIT_ASSERT_THROW(reader.read(cxxtools::callable(*this, &CsvParallelReaderTest::onRow)), cxxtools::SerializationError);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(_rows.size(), 500u);
+            }
+        }
+
+        void testCallbackError()
+        {
+            std::string csv = data();
+
+            for (unsigned ordered = 0; ordered < 2; ++ordered)
+            {
+                setUp();
+                _throwAt = 100;
+
+                cxxtools::CsvParallelReader reader(csv.data(), csv.size());
+                reader.threads(3);
+                reader.chunkSize(200);
+                reader.ordered(ordered);
+
+                CXXTOOLS_UNIT_ASSERT_THROW(reader.read(cxxtools::callable(*this, &CsvParallelReaderTest::onRow)), StopError);
+            }
+        }
+};
+
+cxxtools::unit::RegisterTest<CsvParallelReaderTest> register_CsvParallelReaderTest;
@@ -0,0 +1,339 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/csvreader.h"
+#include "cxxtools/serializationerror.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
+
+namespace
+{
+    struct TestObject
+    {
+        int intValue;
+        std::string stringValue;
+        double doubleValue;
+    };
+
+    void operator>>= (const cxxtools::SerializationInfo& si, TestObject& obj)
+    {
+        si.getMember("intValue") >>= obj.intValue;
+        si.getMember("stringValue") >>= obj.stringValue;
+        si.getMember("doubleValue") >>= obj.doubleValue;
+    }
+}
+
+class CsvReaderTest : public cxxtools::unit::TestSuite
+{
+    public:
+        CsvReaderTest()
+            : cxxtools::unit::TestSuite("csvreader")
+        {
+            registerMethod("testRows", *this, &CsvReaderTest::testRows);
+            registerMethod("testNoTitle", *this, &CsvReaderTest::testNoTitle);
+            registerMethod("testQuotes", *this, &CsvReaderTest::testQuotes);
+            registerMethod("testCr", *this, &CsvReaderTest::testCr);
+            registerMethod("testTrailingDelimiter", *this, &CsvReaderTest::testTrailingDelimiter);
+            registerMethod("testEmptyLines", *this, &CsvReaderTest::testEmptyLines);
+            registerMethod("testColumnMismatch", *this, &CsvReaderTest::testColumnMismatch);
+            registerMethod("testObject", *this, &CsvReaderTest::testObject);
+            registerMethod("testUnicode", *this, &CsvReaderTest::testUnicode);
+            registerMethod("testLargeStream", *this, &CsvReaderTest::testLargeStream);
+            registerMethod("testFile", *this, &CsvReaderTest::testFile);
+        }
+
+        void testRows()
+        {
+            std::istringstream in(
+                "A|B|C\n"
+                "Hello|World|\n"
+                "34|67|\"23\"\n"
+                "col1|'col2'|col3\n");
+
+            cxxtools::CsvReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.delimiter(), '|');
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.titles().size(), 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.titles()[2], "C");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.size(), 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "Hello");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field("B").str(), "World");
+            CXXTOOLS_UNIT_ASSERT(reader[2].empty());
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "67");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[2].str(), "23");
+            CXXTOOLS_UNIT_ASSERT(reader[2].quoted());
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "col2");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[2].str(), "col3");
+
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.field("D"), cxxtools::SerializationError);
+        }
+
+        void testNoTitle()
+        {
+            const char data[] =
+                "Hello,World\n"
+                "\"foo\nbar\",blub";
+
+            cxxtools::CsvReader reader(data, sizeof(data) - 1);
+            reader.readTitle(false);
+            reader.delimiter(',');
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "Hello");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.lineNo(), 1u);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "foo\nbar");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "blub");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.lineNo(), 3u);
+
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+        }
+
+        void testQuotes()
+        {
+            std::istringstream in(
+                "A|B\n"
+                "\"Hello\"|\"\"\"World\"\"\"\n"
+                "\"He\"\"llo\"|'''World'\n"
+                "He'llo|Wor\"'ld\n");
+
+            cxxtools::CsvReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "Hello");
+            CXXTOOLS_UNIT_ASSERT(!reader[0].escaped());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(reader[1].data(), reader[1].size()), "\"\"World\"\"");
+            CXXTOOLS_UNIT_ASSERT(reader[1].escaped());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "\"World\"");
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "He\"llo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "'World");
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "He'llo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "Wor\"'ld");
+            CXXTOOLS_UNIT_ASSERT(!reader[1].quoted());
+
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+        }
+
+        void testCr()
+        {
+            std::istringstream in(
+                "A|B|C\r\n"
+                "Hello|World|\r"
+                "34|67|\"23\"\n"
+                "col1|'col2'|col3\r\n");
+
+            cxxtools::CsvReader reader(in);
+
+            unsigned rows = 0;
+            while (reader.next())
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reader.size(), 3u);
+                ++rows;
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(rows, 3u);
+        }
+
+        void testEmptyLines()
+        {
+            std::istringstream in(
+                "A\n"
+                "1\n"
+                "2\n"
+                "\n");
+
+            cxxtools::CsvReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "1");
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "2");
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.size(), 1u);
+            CXXTOOLS_UNIT_ASSERT(reader[0].empty());
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+        }
+
+        void testTrailingDelimiter()
+        {
+            const char data[] =
+                "A,B\n"
+                "1,";
+
+            cxxtools::CsvReader reader(data, sizeof(data) - 1);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].str(), "1");
+            CXXTOOLS_UNIT_ASSERT(reader[1].empty());
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+
+            std::istringstream in(data);
+            cxxtools::CsvReader sreader(in);
+
+            CXXTOOLS_UNIT_ASSERT(sreader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sreader.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT(sreader[1].empty());
+            CXXTOOLS_UNIT_ASSERT(!sreader.next());
+        }
+
+        void testColumnMismatch()
+        {
+            std::istringstream in(
+                "A|B|C\n"
+                "Hello|World|blah\n"
+                "34|67|\"23\"|someValue\n");
+
+            cxxtools::CsvReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.next(), cxxtools::SerializationError);
+        }
+
+        void testObject()
+        {
+            std::istringstream in(
+                "\"intValue\",'stringValue',\"doubleValue\"\n"
+                "17,'Hi',2.5\n"
+                "-6,Foo,-1000");
+
+            cxxtools::CsvReader reader(in);
+            TestObject obj;
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            reader >>= obj;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.intValue, 17);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.stringValue, "Hi");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.doubleValue, 2.5);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            reader >>= obj;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.intValue, -6);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.stringValue, "Foo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.doubleValue, -1000);
+
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+        }
+
+        void testUnicode()
+        {
+            std::istringstream in(
+                "a;b\n"
+                "M\xc3\xa4kitalo;42\n");
+
+            cxxtools::CsvReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[0].ustr(), cxxtools::String(L"M\xe4kitalo"));
+
+            std::vector<cxxtools::String> row;
+            reader >>= row;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(row.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(row[0], cxxtools::String(L"M\xe4kitalo"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(row[1], cxxtools::String(L"42"));
+        }
+
+        void testLargeStream()
+        {
+            // rows and a quoted field cross the boundaries of the read buffer
+            std::string longValue(200000, 'x');
+            longValue[1000] = '"';
+
+            std::ostringstream data;
+            data << "n,v\n";
+            for (unsigned n = 0; n < 20000; ++n)
+                data << n << ",value " << n << '\n';
+            data << "20000,\"" << longValue.substr(0, 1000) << "\"\"" << longValue.substr(1001) << "\"\n";
+
+            std::istringstream in(data.str());
+            cxxtools::CsvReader reader(in);
+
+            unsigned rows = 0;
+            while (reader.next())
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reader.size(), 2u);
+                if (rows < 20000)
+                {
+                    std::ostringstream expected;
+                    expected << "value " << rows;
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), expected.str());
+                }
+                else
+                {
+                    CXXTOOLS_UNIT_ASSERT(reader[1].str() == longValue);
+                }
+
+                ++rows;
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(rows, 20001u);
+        }
+
+        void testFile()
+        {
+            char fname[] = "/tmp/csvreader-test.XXXXXX";
+            int fd = ::mkstemp(fname);
+            CXXTOOLS_UNIT_ASSERT(fd >= 0);
+            ::close(fd);
+
+            {
+                std::ofstream out(fname);
+                out << "A;B\n"
+                       "1;2\n"
+                       "3;'4'\n";
+            }
+
+            cxxtools::CsvReader reader;
+            reader.open(fname);
+            std::remove(fname);
+
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "2");
+            CXXTOOLS_UNIT_ASSERT(reader.next());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader[1].str(), "4");
+            CXXTOOLS_UNIT_ASSERT(!reader.next());
+        }
+};
+
+cxxtools::unit::RegisterTest<CsvReaderTest> register_CsvReaderTest;
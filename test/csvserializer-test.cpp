@@ -30,6 +30,7 @@
 #include "cxxtools/unit/registertest.h"
 #include "cxxtools/csvserializer.h"
 #include "cxxtools/csv.h"
+#include "cxxtools/iso8859_1codec.h"
 #include "cxxtools/log.h"
 
 //log_define("cxxtools.test.csvserializer")
@@ -70,6 +71,9 @@ class CsvSerializerTest : public cxxtools::unit::TestSuite
             registerMethod("testMultichar", *this, &CsvSerializerTest::testMultichar);
             registerMethod("testOStream", *this, &CsvSerializerTest::testOStream);
             registerMethod("testLinefeeddata", *this, &CsvSerializerTest::testLinefeeddata);
+            registerMethod("testQuoting", *this, &CsvSerializerTest::testQuoting);
+            registerMethod("testUnicode", *this, &CsvSerializerTest::testUnicode);
+            registerMethod("testRawBytes", *this, &CsvSerializerTest::testRawBytes);
         }
 
         void testVectorVector()
@@ -259,6 +263,66 @@ class CsvSerializerTest : public cxxtools::unit::TestSuite
                 "\"foo\nbar\",blub\n");
         }
 
+        void testQuoting()
+        {
+            std::vector<std::vector<std::string> > data(2);
+            data[0].push_back("no special characters in this long value");
+            data[0].push_back("a long value with a \"quote\" inside");
+            data[0].push_back("long value with a foo and bar");
+            data[1].push_back("long value with a foobar delimiter");
+            data[1].push_back("long value ending with a line feed\r\n");
+            data[1].push_back("long value with a\nline feed");
+
+            std::ostringstream out;
+            cxxtools::CsvSerializer serializer(out);
+            serializer.delimiter(L"foobar");
+            serializer.lineEnding(L"\r\n");
+            serializer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "no special characters in this long value"
+                "foobar\"a long value with a \"\"quote\"\" inside\""
+                "foobarlong value with a foo and bar\r\n"
+                "\"long value with a foobar delimiter\""
+                "foobar\"long value ending with a line feed\r\n\""
+                "foobarlong value with a\nline feed\r\n");
+        }
+
+        void testUnicode()
+        {
+            std::vector<std::vector<cxxtools::String> > data(1);
+            data[0].push_back(cxxtools::String(L"M\xe4kitalo"));
+            data[0].push_back(cxxtools::String(L"\x20ac"));
+
+            std::ostringstream out;
+            cxxtools::CsvSerializer serializer(out);
+            serializer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(), "M\xc3\xa4kitalo,\xe2\x82\xac\n");
+
+            data[0].pop_back();
+            std::ostringstream latin1;
+            cxxtools::CsvSerializer latin1Serializer(latin1, new cxxtools::Iso8859_1Codec());
+            latin1Serializer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(latin1.str(), "M\xe4kitalo\n");
+        }
+
+        void testRawBytes()
+        {
+            // std::string values, which are no valid utf-8, are passed
+            // byte by byte to the codec
+            std::vector<std::vector<std::string> > data(1);
+            data[0].push_back("M\xe4kitalo");
+            data[0].push_back("M\xc3\xa4kitalo");
+
+            std::ostringstream latin1;
+            cxxtools::CsvSerializer latin1Serializer(latin1, new cxxtools::Iso8859_1Codec());
+            latin1Serializer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(latin1.str(), "M\xe4kitalo,M\xe4kitalo\n");
+        }
+
 };
 
 cxxtools::unit::RegisterTest<CsvSerializerTest> register_CsvSerializerTest;
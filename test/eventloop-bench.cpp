@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/eventloop.h>
+#include <cxxtools/event.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    class Ping : public cxxtools::BasicEvent<Ping>
+    { };
+
+    class Pong : public cxxtools::BasicEvent<Pong>
+    { };
+
+    class Message : public cxxtools::BasicEvent<Message>
+    { };
+
+    unsigned roundTrips = 0;
+    unsigned count = 0;
+    cxxtools::EventLoop* loopA = 0;
+    cxxtools::EventLoop* loopB = 0;
+
+    // loop B answers every ping
+    void onPing(const Ping&)
+    {
+        loopA->commitEvent(Pong());
+    }
+
+    // loop A sends the next ping until all round trips are done
+    void onPong(const Pong&)
+    {
+        if (++count >= roundTrips)
+        {
+            loopA->exit();
+            loopB->exit();
+        }
+        else
+            loopB->commitEvent(Ping());
+    }
+
+    void pingPong(unsigned n)
+    {
+        cxxtools::EventLoop a;
+        cxxtools::EventLoop b;
+        loopA = &a;
+        loopB = &b;
+        roundTrips = n;
+        count = 0;
+
+        a.event.subscribe(cxxtools::slot(onPong));
+        b.event.subscribe(cxxtools::slot(onPing));
+
+        cxxtools::AttachedThread threadB(cxxtools::callable(static_cast<cxxtools::EventLoopBase&>(b), &cxxtools::EventLoopBase::run));
+        threadB.start();
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        b.commitEvent(Ping());
+        a.run();
+        threadB.join();
+
+        cxxtools::Timespan t = clock.stop();
+
+        std::cout << "ping-pong\t" << n << " round trips in " << t.totalSeconds() << " s => "
+                  << (t.totalUSecs() / static_cast<double>(n)) << " us/round trip" << std::endl;
+    }
+
+    unsigned messagesPerProducer = 0;
+    unsigned expectedMessages = 0;
+    cxxtools::EventLoop* sink = 0;
+
+    void onMessage(const Message&)
+    {
+        if (++count >= expectedMessages)
+            sink->exit();
+    }
+
+    void produce()
+    {
+        for (unsigned n = 0; n < messagesPerProducer; ++n)
+            sink->commitEvent(Message());
+    }
+
+    void fanIn(unsigned producers, unsigned n)
+    {
+        cxxtools::EventLoop loop;
+        sink = &loop;
+        count = 0;
+        messagesPerProducer = n;
+        expectedMessages = producers * n;
+
+        loop.event.subscribe(cxxtools::slot(onMessage));
+
+        std::vector<cxxtools::AttachedThread*> threads;
+        for (unsigned p = 0; p < producers; ++p)
+            threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(produce)));
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        for (unsigned p = 0; p < producers; ++p)
+            threads[p]->start();
+
+        loop.run();
+
+        cxxtools::Timespan t = clock.stop();
+
+        for (unsigned p = 0; p < producers; ++p)
+        {
+            threads[p]->join();
+            delete threads[p];
+        }
+
+        std::cout << "fan-in\t" << producers << " producers\t" << expectedMessages << " events in "
+                  << t.totalSeconds() << " s => " << (expectedMessages / t.totalSeconds()) << "#/s" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> n(argc, argv, 'n', 100000);
+        cxxtools::Arg<unsigned> roundTrips(argc, argv, 'r', 20000);
+        cxxtools::Arg<unsigned> maxProducers(argc, argv, 'P', 8);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -r number  ping-pong round trips (default: 20000)\n"
+                         "   -n number  events per producer in fan-in (default: 100000)\n"
+                         "   -P number  maximum number of producers (default: 8)\n";
+            return -1;
+        }
+
+        pingPong(roundTrips);
+
+        for (unsigned p = 1; p <= maxProducers; p *= 2)
+            fanIn(p, n);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -31,6 +31,10 @@
 #include "cxxtools/unit/registertest.h"
 #include "cxxtools/event.h"
 #include "cxxtools/eventloop.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/pipe.h"
+#include "cxxtools/net/tcpserver.h"
+#include "cxxtools/net/tcpsocket.h"
 
 namespace
 {
@@ -39,16 +43,98 @@ namespace
 
     class TestEvent2 : public cxxtools::BasicEvent<TestEvent2>
     { };
+
+    // too large to be stored in the queue node
+    class LargeEvent : public cxxtools::BasicEvent<LargeEvent>
+    {
+    public:
+        explicit LargeEvent(unsigned v = 0)
+            : value(v)
+        { }
+
+        unsigned value;
+        char data[256];
+    };
+
+    // small, but with a stricter alignment than pointers
+    class AlignedEvent : public cxxtools::BasicEvent<AlignedEvent>
+    {
+    public:
+        explicit AlignedEvent(long double v = 0)
+            : value(v)
+        { }
+
+        long double value;
+    };
 }
 
 class EventLoopTest : public cxxtools::unit::TestSuite
 {
     cxxtools::EventLoop _loop;
     std::string _events;
+    std::string::size_type _exitAt;
+    unsigned _count;
+    unsigned _sum;
+    cxxtools::Pipe* _pipe;
+    std::string _received;
+    char _buffer[16];
+
+    void onLargeEvent(const LargeEvent& ev)
+    {
+        ++_count;
+        _sum += ev.value;
+    }
+
+    void onAlignedEvent(const AlignedEvent& ev)
+    {
+        if (reinterpret_cast<std::size_t>(&ev) % __alignof__(AlignedEvent) == 0)
+            ++_count;
+        _sum += static_cast<unsigned>(ev.value);
+    }
+
+    void produce()
+    {
+        for (unsigned n = 0; n < 1000; ++n)
+            _loop.commitEvent(LargeEvent(1));
+        for (unsigned n = 0; n < 1000; ++n)
+            _loop.commitEvent(TestEvent1());
+    }
+
+    void commitSlowly()
+    {
+        for (unsigned n = 0; n < 3; ++n)
+        {
+            cxxtools::Thread::sleep(cxxtools::Milliseconds(10));
+            _loop.commitEvent(TestEvent1());
+        }
+    }
+
+    void writePipe()
+    {
+        _pipe->write("hello ", 6);
+        cxxtools::Thread::sleep(cxxtools::Milliseconds(10));
+        _pipe->write("world", 5);
+    }
+
+    void onPipeInput(cxxtools::IODevice& device)
+    {
+        _received.append(_buffer, device.endRead());
+        if (_received.size() >= 11)
+            _loop.exit();
+        else
+            device.beginRead(_buffer, sizeof(_buffer));
+    }
+
+    void onSocketInput(cxxtools::IODevice& device)
+    {
+        _received.append(_buffer, device.endRead());
+    }
 
     void onTestEvent1(const TestEvent1&)
     {
         _events += "1";
+        if (_events.size() == _exitAt)
+            _loop.exit();
     }
 
     void onTestEvent2(const TestEvent2&)
@@ -62,14 +148,25 @@ public:
     {
         registerMethod("commitEvent", *this, &EventLoopTest::commitEvent);
         registerMethod("priorityEvent", *this, &EventLoopTest::priorityEvent);
+        registerMethod("manyEvents", *this, &EventLoopTest::manyEvents);
+        registerMethod("alignedEvent", *this, &EventLoopTest::alignedEvent);
+        registerMethod("threads", *this, &EventLoopTest::threads);
+        registerMethod("waitEvents", *this, &EventLoopTest::waitEvents);
+        registerMethod("ioUring", *this, &EventLoopTest::ioUring);
+        registerMethod("ioUringRecv", *this, &EventLoopTest::ioUringRecv);
 
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent1));
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent2));
+        _loop.event.subscribe(slot(*this, &EventLoopTest::onLargeEvent));
+        _loop.event.subscribe(slot(*this, &EventLoopTest::onAlignedEvent));
     }
 
     void setUp()
     {
         _events.clear();
+        _exitAt = 0;
+        _count = 0;
+        _sum = 0;
     }
 
     void commitEvent()
@@ -88,6 +185,158 @@ public:
         CXXTOOLS_UNIT_ASSERT_EQUALS(_events, "21");
     }
 
+    void manyEvents()
+    {
+        // more events than fit into the node pool of the loop
+        for (unsigned n = 0; n < 1000; ++n)
+        {
+            _loop.queueEvent(TestEvent1());
+            _loop.queueEvent(LargeEvent(n));
+        }
+
+        _loop.processEvents();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_events.size(), 1000u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 1000u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_sum, 999u * 1000u / 2);
+    }
+
+    void alignedEvent()
+    {
+        union
+        {
+            long double ld;
+            char data[64];
+        } storage;
+
+        AlignedEvent ev(2);
+        CXXTOOLS_UNIT_ASSERT(ev.cloneTo(storage.data + 1, sizeof(storage) - 1) == 0);
+
+        cxxtools::Event* copy = ev.cloneTo(storage.data, sizeof(storage));
+        CXXTOOLS_UNIT_ASSERT(copy != 0);
+        copy->~Event();
+
+        for (unsigned n = 0; n < 10; ++n)
+            _loop.queueEvent(AlignedEvent(n));
+
+        _loop.processEvents();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 10u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_sum, 45u);
+    }
+
+    void threads()
+    {
+        _exitAt = 4000;
+
+        cxxtools::AttachedThread t1(cxxtools::callable(*this, &EventLoopTest::produce));
+        cxxtools::AttachedThread t2(cxxtools::callable(*this, &EventLoopTest::produce));
+        cxxtools::AttachedThread t3(cxxtools::callable(*this, &EventLoopTest::produce));
+        cxxtools::AttachedThread t4(cxxtools::callable(*this, &EventLoopTest::produce));
+        t1.start();
+        t2.start();
+        t3.start();
+        t4.start();
+
+        _loop.run();
+
+        t1.join();
+        t2.join();
+        t3.join();
+        t4.join();
+
+        _loop.processEvents();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_events.size(), 4000u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 4000u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_sum, 4000u);
+    }
+
+    void waitEvents()
+    {
+        // the loop is driven by wait() instead of run(), so every committed
+        // event must wake it up
+        cxxtools::AttachedThread producer(cxxtools::callable(*this, &EventLoopTest::commitSlowly));
+        producer.start();
+
+        while (_events.size() < 3)
+            CXXTOOLS_UNIT_ASSERT(_loop.wait(cxxtools::Milliseconds(2000)));
+
+        producer.join();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_events, "111");
+    }
+
+    void ioUring()
+    {
+        // skipped, where io_uring is not available
+        if (!_loop.useIoUring())
+            return;
+
+        cxxtools::Pipe pipe(cxxtools::Pipe::Async);
+        _pipe = &pipe;
+        _received.clear();
+
+        connect(pipe.out().inputReady, *this, &EventLoopTest::onPipeInput);
+        _loop.add(pipe.out());
+        pipe.out().beginRead(_buffer, sizeof(_buffer));
+
+        cxxtools::AttachedThread writer(cxxtools::callable(*this, &EventLoopTest::writePipe));
+        writer.start();
+
+        _loop.run();
+        writer.join();
+
+        _loop.useIoUring(false);
+
+        CXXTOOLS_UNIT_ASSERT(!_loop.usesIoUring());
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_received, "hello world");
+    }
+
+    void ioUringRecv()
+    {
+        // skipped, where io_uring is not available
+        if (!_loop.useIoUring())
+            return;
+
+        cxxtools::net::TcpServer server("127.0.0.1", 7005);
+        cxxtools::net::TcpSocket client("127.0.0.1", 7005);
+        cxxtools::net::TcpSocket peer(server);
+        _received.clear();
+
+        connect(peer.inputReady, *this, &EventLoopTest::onSocketInput);
+        _loop.add(peer);
+
+        // the kernel receives into the buffer
+        peer.beginRead(_buffer, sizeof(_buffer));
+        client.write("hello", 5);
+        while (_received.size() < 5)
+            CXXTOOLS_UNIT_ASSERT(_loop.wait(cxxtools::Milliseconds(2000)));
+
+        // data received by a canceled request is passed on to the next read
+        peer.beginRead(_buffer, sizeof(_buffer));
+        client.write(" world", 6);
+        peer.cancel();
+        peer.beginRead(_buffer, sizeof(_buffer));
+        while (_received.size() < 11)
+            CXXTOOLS_UNIT_ASSERT(_loop.wait(cxxtools::Milliseconds(2000)));
+
+        // synchronous read of an asynchronous device
+        char ch = 0;
+        client.write("!", 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(peer.read(&ch, 1), 1u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(ch, '!');
+
+        client.close();
+        peer.beginRead(_buffer, sizeof(_buffer));
+        CXXTOOLS_UNIT_ASSERT(_loop.wait(cxxtools::Milliseconds(2000)));
+        CXXTOOLS_UNIT_ASSERT(peer.eof());
+
+        _loop.useIoUring(false);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_received, "hello world");
+    }
+
 };
 
 cxxtools::unit::RegisterTest<EventLoopTest> register_EventLoopTest;
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <iostream>
+#include <vector>
+#include <cxxtools/arg.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/eventloop.h>
+#include <cxxtools/log.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/http/client.h>
+#include <cxxtools/http/reply.h>
+#include <cxxtools/http/request.h>
+#include <cxxtools/http/responder.h>
+#include <cxxtools/http/server.h>
+#include <cxxtools/http/service.h>
+
+static std::string replyBody = "Hello World\n";
+
+class HelloResponder : public cxxtools::http::Responder
+{
+  public:
+    explicit HelloResponder(cxxtools::http::Service& service)
+      : cxxtools::http::Responder(service)
+      { }
+
+    virtual void reply(std::ostream& out, cxxtools::http::Request&, cxxtools::http::Reply& reply)
+    {
+      reply.addHeader("Content-Type", "text/plain");
+      out << replyBody;
+    }
+};
+
+typedef cxxtools::http::CachedService<HelloResponder> HelloService;
+
+class BenchClient
+{
+    void exec();
+
+    cxxtools::http::Client client;
+    cxxtools::AttachedThread thread;
+
+    static unsigned _numRequests;
+    static cxxtools::atomic_t _requestsStarted;
+    static cxxtools::atomic_t _requestsFailed;
+
+  public:
+    BenchClient(const std::string& ip, unsigned short port)
+      : client(ip, port),
+        thread(cxxtools::callable(*this, &BenchClient::exec))
+    { }
+
+    static void numRequests(unsigned n)
+    { _numRequests = n; }
+
+    static unsigned requestsStarted()
+    { return static_cast<unsigned>(cxxtools::atomicGet(_requestsStarted)); }
+
+    static unsigned requestsFailed()
+    { return static_cast<unsigned>(cxxtools::atomicGet(_requestsFailed)); }
+
+    void start()
+    { thread.start(); }
+
+    void join()
+    { thread.join(); }
+};
+
+unsigned BenchClient::_numRequests = 0;
+cxxtools::atomic_t BenchClient::_requestsStarted(0);
+cxxtools::atomic_t BenchClient::_requestsFailed(0);
+
+void BenchClient::exec()
+{
+  while (static_cast<unsigned>(cxxtools::atomicIncrement(_requestsStarted)) <= _numRequests)
+  {
+    try
+    {
+      if (client.get("/hello").httpReturnCode() != 200)
+        cxxtools::atomicIncrement(_requestsFailed);
+    }
+    catch (const std::exception& e)
+    {
+      std::cerr << "request failed with error message \"" << e.what() << '"' << std::endl;
+      cxxtools::atomicIncrement(_requestsFailed);
+    }
+  }
+
+  cxxtools::atomicDecrement(_requestsStarted);
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    log_init();
+
+    cxxtools::Arg<std::string> ip(argc, argv, 'i', "127.0.0.1");
+    cxxtools::Arg<unsigned short> port(argc, argv, 'p', 7010);
+    cxxtools::Arg<unsigned> threads(argc, argv, 't', 4);
+    cxxtools::Arg<unsigned> numRequests(argc, argv, 'n', 20000);
+    cxxtools::Arg<unsigned> bodySize(argc, argv, 's', 0);
+    cxxtools::Arg<bool> serverOnly(argc, argv, 'S');
+    cxxtools::Arg<bool> clientOnly(argc, argv, 'C');
+    cxxtools::Arg<bool> ioUring(argc, argv, 'U');
+
+    if (cxxtools::Arg<bool>(argc, argv, 'h'))
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "   -i ip      ip address of server (default: 127.0.0.1)\n"
+                   "   -p number  port number of server (default: 7010)\n"
+                   "   -t number  number of client threads (default: 4)\n"
+                   "   -n number  number of requests (default: 20000)\n"
+                   "   -s bytes   reply with a body of the given size instead of hello world\n"
+                   "   -S         run hello world server only\n"
+                   "   -C         run clients only\n"
+                   "   -U         server waits for I/O using io_uring\n"
+                << std::endl;
+      return 0;
+    }
+
+    if (bodySize > 0)
+    {
+      replyBody.clear();
+      for (unsigned n = 0; n < bodySize; ++n)
+        replyBody += static_cast<char>('a' + n % 26);
+    }
+
+    cxxtools::EventLoop loop;
+    if (ioUring && !loop.useIoUring())
+      std::cerr << "io_uring not available; using poll" << std::endl;
+
+    cxxtools::AttachedThread loopThread(cxxtools::callable(loop, &cxxtools::EventLoop::run));
+    HelloService service;
+    cxxtools::http::Server* server = 0;
+
+    if (!clientOnly)
+    {
+      server = new cxxtools::http::Server(loop, ip, port);
+      server->addService("/hello", service);
+
+      if (serverOnly)
+      {
+        loop.run();
+        delete server;
+        return 0;
+      }
+
+      loopThread.start();
+    }
+
+    BenchClient::numRequests(numRequests);
+
+    std::vector<BenchClient*> clients;
+    while (clients.size() < threads)
+      clients.push_back(new BenchClient(ip, port));
+
+    // give the server some time to start
+    cxxtools::Thread::sleep(cxxtools::Milliseconds(100));
+
+    cxxtools::Clock cl;
+    cl.start();
+
+    for (std::vector<BenchClient*>::iterator it = clients.begin(); it != clients.end(); ++it)
+      (*it)->start();
+
+    for (std::vector<BenchClient*>::iterator it = clients.begin(); it != clients.end(); ++it)
+      (*it)->join();
+
+    cxxtools::Timespan t = cl.stop();
+
+    std::cout << BenchClient::requestsStarted() << " requests in " << t.totalSeconds() << " s => "
+              << (BenchClient::requestsStarted() / t.totalSeconds()) << "#/s "
+              << (BenchClient::requestsStarted() * static_cast<double>(replyBody.size()) / t.totalSeconds() / 1024 / 1024) << " MB/s\n"
+              << BenchClient::requestsFailed() << " failed" << std::endl;
+
+    for (std::vector<BenchClient*>::iterator it = clients.begin(); it != clients.end(); ++it)
+      delete *it;
+
+    if (server)
+    {
+      loop.exit();
+      loopThread.join();
+      delete server;
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/request.h"
+#include "cxxtools/http/responder.h"
+#include "cxxtools/http/service.h"
+#include "cxxtools/regex.h"
+#include "http/mapper.h"
+
+namespace
+{
+    class NamedResponder : public cxxtools::http::Responder
+    {
+        public:
+            NamedResponder(cxxtools::http::Service& service, const std::string& name)
+                : cxxtools::http::Responder(service),
+                  _name(name)
+            { }
+
+            const std::string& name() const
+            { return _name; }
+
+            void reply(std::ostream&, cxxtools::http::Request&, cxxtools::http::Reply&)
+            { }
+
+        private:
+            std::string _name;
+    };
+
+    class NamedService : public cxxtools::http::Service
+    {
+        public:
+            explicit NamedService(const std::string& name)
+                : _name(name)
+            { }
+
+        protected:
+            cxxtools::http::Responder* createResponder(const cxxtools::http::Request&)
+            { return new NamedResponder(*this, _name); }
+
+            void releaseResponder(cxxtools::http::Responder* responder)
+            { delete responder; }
+
+        private:
+            std::string _name;
+    };
+
+    // records the attempt and declines the request
+    class DecliningService : public cxxtools::http::Service
+    {
+        public:
+            DecliningService(const std::string& name, std::string& log)
+                : _name(name),
+                  _log(&log)
+            { }
+
+        protected:
+            cxxtools::http::Responder* createResponder(const cxxtools::http::Request&)
+            {
+                *_log += _name;
+                *_log += ',';
+                return 0;
+            }
+
+            void releaseResponder(cxxtools::http::Responder* responder)
+            { delete responder; }
+
+        private:
+            std::string _name;
+            std::string* _log;
+    };
+}
+
+class HttpMapperTest : public cxxtools::unit::TestSuite
+{
+    public:
+        HttpMapperTest()
+        : cxxtools::unit::TestSuite("httpmapper")
+        {
+            registerMethod("literal", *this, &HttpMapperTest::literal);
+            registerMethod("prefix", *this, &HttpMapperTest::prefix);
+            registerMethod("pattern", *this, &HttpMapperTest::pattern);
+            registerMethod("order", *this, &HttpMapperTest::order);
+            registerMethod("remove", *this, &HttpMapperTest::remove);
+            registerMethod("fallthrough", *this, &HttpMapperTest::fallthrough);
+        }
+
+        static std::string route(cxxtools::http::Mapper& mapper, const std::string& url)
+        {
+            cxxtools::http::Request request(url);
+            cxxtools::http::Responder* responder = mapper.getResponder(request);
+            NamedResponder* named = dynamic_cast<NamedResponder*>(responder);
+            std::string name = named ? named->name() : std::string();
+            responder->release();
+            return name;
+        }
+
+        void literal()
+        {
+            cxxtools::http::Mapper mapper;
+            NamedService foo("foo");
+            NamedService foobar("foobar");
+            NamedService fob("fob");
+
+            mapper.addService("/foo", foo);
+            mapper.addService("/foobar", foobar);
+            mapper.addService("/fob", fob);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/foo"), "foo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/foobar"), "foobar");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/fob"), "fob");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/fo"), "");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/foob"), "");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/foobarx"), "");
+        }
+
+        void prefix()
+        {
+            cxxtools::http::Mapper mapper;
+            NamedService api("api");
+            NamedService root("root");
+
+            mapper.addPrefixService("/api/", api);
+            mapper.addPrefixService("/", root);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/api/users"), "api");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/api/"), "api");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/api"), "root");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/index.html"), "root");
+        }
+
+        void pattern()
+        {
+            cxxtools::http::Mapper mapper;
+            NamedService profile("profile");
+            NamedService user("user");
+
+            mapper.addPatternService("/user/{id}/profile", profile);
+            mapper.addPatternService("/user/{id}", user);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/user/42/profile"), "profile");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/user/42"), "user");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/user/"), "");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/user/42/x"), "");
+        }
+
+        void order()
+        {
+            cxxtools::http::Mapper mapper;
+            NamedService regex("regex");
+            NamedService literal("literal");
+            NamedService prefix("prefix");
+
+            mapper.addService(cxxtools::Regex("^/a"), regex);
+            mapper.addService("/abc", literal);
+            mapper.addPrefixService("/", prefix);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/abc"), "regex");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/xyz"), "prefix");
+
+            mapper.removeService(regex);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/abc"), "literal");
+        }
+
+        void remove()
+        {
+            cxxtools::http::Mapper mapper;
+            NamedService foo("foo");
+
+            mapper.addService("/foo", foo);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/foo"), "foo");
+
+            mapper.removeService(foo);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/foo"), "");
+        }
+
+        void fallthrough()
+        {
+            std::string log;
+            cxxtools::http::Mapper mapper;
+            DecliningService root("root", log);
+            DecliningService pattern("pattern", log);
+            DecliningService regex("regex", log);
+            DecliningService other("other", log);
+            NamedService me("me");
+            NamedService user("user");
+
+            mapper.addPrefixService("/", root);
+            mapper.addPatternService("/user/{id}", pattern);
+            mapper.addService(cxxtools::Regex("^/user"), regex);
+            mapper.addService(cxxtools::Regex("^/other"), other);
+            mapper.addService("/user/me", me);
+            mapper.addPrefixService("/user/", user);
+
+            // all candidates are tried in the order they were added
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/user/me"), "me");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(log, "root,pattern,regex,");
+
+            log.clear();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/user/42"), "user");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(log, "root,pattern,regex,");
+
+            log.clear();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(route(mapper, "/users"), "");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(log, "root,regex,");
+        }
+
+};
+
+cxxtools::unit::RegisterTest<HttpMapperTest> register_HttpMapperTest;
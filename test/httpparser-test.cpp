@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/messageheader.h"
+#include "cxxtools/streambuffer.h"
+#include "http/parser.h"
+#include <sstream>
+
+namespace
+{
+    // Stream buffer, which presents a fixed string as its get area.
+    class HeaderBuffer : public cxxtools::BasicStreamBuffer<char>
+    {
+        public:
+            HeaderBuffer(const char* data, std::size_t size)
+            {
+                char* p = const_cast<char*>(data);
+                setg(p, p, p + size);
+            }
+    };
+
+    std::string dump(const cxxtools::http::MessageHeader& header)
+    {
+        std::ostringstream s;
+        for (cxxtools::http::MessageHeader::const_iterator it = header.begin(); it != header.end(); ++it)
+            s << '[' << it->first << "]=[" << it->second << "] ";
+        return s.str();
+    }
+}
+
+class HttpParserTest : public cxxtools::unit::TestSuite
+{
+    public:
+        HttpParserTest()
+        : cxxtools::unit::TestSuite("httpparser")
+        {
+            registerMethod("parseLines", *this, &HttpParserTest::parseLines);
+            registerMethod("parseChars", *this, &HttpParserTest::parseChars);
+            registerMethod("embeddedNul", *this, &HttpParserTest::embeddedNul);
+        }
+
+        void parseLines()
+        {
+            static const char data[] =
+                "GET / HTTP/1.1\r\n"
+                "Host: h\r\n"
+                "Content-Length:  12\r\n"
+                "\r\n";
+
+            HeaderBuffer hb(data, sizeof(data) - 1);
+            cxxtools::http::MessageHeader header;
+            cxxtools::http::HeaderParser::MessageHeaderEvent event(header);
+            cxxtools::http::HeaderParser parser(event, false);
+            parser.advance(hb);
+
+            CXXTOOLS_UNIT_ASSERT(parser.end());
+            CXXTOOLS_UNIT_ASSERT(!parser.fail());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(dump(header), "[Host]=[h] [Content-Length]=[12] ");
+        }
+
+        void parseChars()
+        {
+            static const char data[] =
+                "GET / HTTP/1.1\r\n"
+                "Host: h\r\n"
+                "Content-Length:  12\r\n"
+                "\r\n";
+
+            HeaderBuffer hb(data, sizeof(data) - 1);
+            cxxtools::http::MessageHeader header;
+            cxxtools::http::HeaderParser::MessageHeaderEvent event(header);
+            cxxtools::http::HeaderParser parser(event, false);
+            parser.advance(static_cast<std::streambuf&>(hb));
+
+            CXXTOOLS_UNIT_ASSERT(parser.end());
+            CXXTOOLS_UNIT_ASSERT(!parser.fail());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(dump(header), "[Host]=[h] [Content-Length]=[12] ");
+        }
+
+        void embeddedNul()
+        {
+            // A NUL must not shift the following headers, since they are
+            // stored as "key\0value\0". Both parser paths must agree.
+            static const char data[] =
+                "GET / HTTP/1.1\r\n"
+                "X: a\0Content-Length\r\n"
+                "Host: h\r\n"
+                "\r\n";
+
+            HeaderBuffer hl(data, sizeof(data) - 1);
+            cxxtools::http::MessageHeader lines;
+            cxxtools::http::HeaderParser::MessageHeaderEvent linesEvent(lines);
+            cxxtools::http::HeaderParser linesParser(linesEvent, false);
+            linesParser.advance(hl);
+
+            HeaderBuffer hc(data, sizeof(data) - 1);
+            cxxtools::http::MessageHeader chars;
+            cxxtools::http::HeaderParser::MessageHeaderEvent charsEvent(chars);
+            cxxtools::http::HeaderParser charsParser(charsEvent, false);
+            charsParser.advance(static_cast<std::streambuf&>(hc));
+
+            CXXTOOLS_UNIT_ASSERT(linesParser.end());
+            CXXTOOLS_UNIT_ASSERT(charsParser.end());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(dump(lines), dump(chars));
+            CXXTOOLS_UNIT_ASSERT(!lines.hasHeader("Content-Length"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(lines.getHeader("X")), "a");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(lines.getHeader("Host")), "h");
+        }
+
+};
+
+cxxtools::unit::RegisterTest<HttpParserTest> register_HttpParserTest;
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/lockfreequeue.h"
+#include "overflowqueue.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <vector>
+
+class LockFreeQueueTest : public cxxtools::unit::TestSuite
+{
+        cxxtools::LockFreeQueue<unsigned>* _queue;
+        cxxtools::atomic_t _sum;
+        cxxtools::OverflowQueue<unsigned>* _overflowQueue;
+
+    public:
+        LockFreeQueueTest()
+        : cxxtools::unit::TestSuite("lockfreequeue"),
+          _queue(0),
+          _sum(0),
+          _overflowQueue(0)
+        {
+            registerMethod("testPutGet", *this, &LockFreeQueueTest::testPutGet);
+            registerMethod("testFull", *this, &LockFreeQueueTest::testFull);
+            registerMethod("testTimeout", *this, &LockFreeQueueTest::testTimeout);
+            registerMethod("testThreads", *this, &LockFreeQueueTest::testThreads);
+            registerMethod("testOverflow", *this, &LockFreeQueueTest::testOverflow);
+            registerMethod("testOverflowThreads", *this, &LockFreeQueueTest::testOverflowThreads);
+        }
+
+        void testPutGet()
+        {
+            cxxtools::LockFreeQueue<unsigned> queue(4);
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+
+            queue.put(1);
+            queue.put(2);
+            queue.put(3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.size(), 3u);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.get(), 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.get(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.get(), 3u);
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+            CXXTOOLS_UNIT_ASSERT(!queue.tryGet().second);
+        }
+
+        void testFull()
+        {
+            cxxtools::LockFreeQueue<unsigned> queue(3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.maxSize(), 4u);
+
+            for (unsigned n = 0; n < 4; ++n)
+                CXXTOOLS_UNIT_ASSERT(queue.tryPut(n));
+            CXXTOOLS_UNIT_ASSERT(!queue.tryPut(4));
+
+            // the ring buffer wraps around
+            for (unsigned n = 0; n < 10; ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(queue.get(), n);
+                CXXTOOLS_UNIT_ASSERT(queue.tryPut(n + 4));
+            }
+        }
+
+        void testTimeout()
+        {
+            cxxtools::LockFreeQueue<unsigned> queue;
+            std::pair<unsigned, bool> ret = queue.get(cxxtools::Milliseconds(10));
+            CXXTOOLS_UNIT_ASSERT(!ret.second);
+
+            queue.put(5);
+            ret = queue.get(cxxtools::Milliseconds(10));
+            CXXTOOLS_UNIT_ASSERT(ret.second);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(ret.first, 5u);
+        }
+
+        void produce()
+        {
+            for (unsigned n = 1; n <= 10000; ++n)
+                _queue->put(n);
+        }
+
+        void consume()
+        {
+            unsigned n;
+            while ((n = _queue->get()) != 0)
+                cxxtools::atomicExchangeAdd(_sum, n);
+        }
+
+        void testThreads()
+        {
+            // a small queue lets producers and consumers block
+            cxxtools::LockFreeQueue<unsigned> queue(16);
+            _queue = &queue;
+            _sum = 0;
+
+            std::vector<cxxtools::AttachedThread*> threads;
+            for (unsigned n = 0; n < 3; ++n)
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &LockFreeQueueTest::consume)));
+            for (unsigned n = 0; n < 3; ++n)
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &LockFreeQueueTest::produce)));
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+                threads[n]->start();
+
+            for (unsigned n = 3; n < threads.size(); ++n)
+                threads[n]->join();
+
+            for (unsigned n = 0; n < 3; ++n)
+                queue.put(0);
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+                delete threads[n];
+
+            _queue = 0;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::atomicGet(_sum), 3 * 10000 * 10001 / 2);
+        }
+
+        void testOverflow()
+        {
+            // the only consumer puts more than the capacity; put must not block
+            cxxtools::OverflowQueue<unsigned> queue(4);
+            for (unsigned n = 1; n <= 100; ++n)
+                queue.put(n);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.size(), 100u);
+
+            unsigned sum = 0;
+            for (unsigned n = 1; n <= 100; ++n)
+                sum += queue.get();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sum, 100u * 101u / 2);
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+        }
+
+        void relay()
+        {
+            // every element is put back twice with a lower value, like the
+            // workers of the servers put back sockets
+            unsigned n;
+            while ((n = _overflowQueue->get()) != 0)
+            {
+                cxxtools::atomicIncrement(_sum);
+                if (n > 1)
+                {
+                    _overflowQueue->put(n - 1);
+                    _overflowQueue->put(n - 1);
+                }
+            }
+        }
+
+        void testOverflowThreads()
+        {
+            cxxtools::OverflowQueue<unsigned> queue(4);
+            _overflowQueue = &queue;
+            _sum = 0;
+
+            std::vector<cxxtools::AttachedThread*> threads;
+            for (unsigned n = 0; n < 3; ++n)
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &LockFreeQueueTest::relay)));
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+                threads[n]->start();
+
+            // each element with value 6 is relayed 2^6 - 1 times
+            for (unsigned n = 0; n < 16; ++n)
+                queue.put(6);
+
+            while (cxxtools::atomicGet(_sum) < 16 * 63)
+                cxxtools::Thread::sleep(cxxtools::Milliseconds(1));
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+                queue.put(0);
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+                delete threads[n];
+
+            _overflowQueue = 0;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::atomicGet(_sum), 16 * 63);
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+        }
+};
+
+cxxtools::unit::RegisterTest<LockFreeQueueTest> register_LockFreeQueueTest;
@@ -27,8 +27,12 @@
  */
 
 #include "cxxtools/lrucache.h"
+#include "cxxtools/hashlrucache.h"
+#include "cxxtools/clock.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
+#include <iostream>
+#include <string>
 
 class LruCacheTest : public cxxtools::unit::TestSuite
 {
@@ -36,15 +40,23 @@ class LruCacheTest : public cxxtools::unit::TestSuite
         LruCacheTest()
         : cxxtools::unit::TestSuite("lrucache")
         {
-            registerMethod("cacheTest", *this, &LruCacheTest::cacheTest);
-            registerMethod("erase", *this, &LruCacheTest::erase);
-            registerMethod("resize", *this, &LruCacheTest::resize);
-            registerMethod("stats", *this, &LruCacheTest::stats);
+            registerMethod("cacheTest", *this, &LruCacheTest::cacheTest<cxxtools::LruCache<int, int> >);
+            registerMethod("erase", *this, &LruCacheTest::erase<cxxtools::LruCache<int, int> >);
+            registerMethod("resize", *this, &LruCacheTest::resize<cxxtools::LruCache<int, int> >);
+            registerMethod("stats", *this, &LruCacheTest::stats<cxxtools::LruCache<int, int> >);
+            registerMethod("hashCacheTest", *this, &LruCacheTest::cacheTest<cxxtools::HashLruCache<int, int> >);
+            registerMethod("hashErase", *this, &LruCacheTest::erase<cxxtools::HashLruCache<int, int> >);
+            registerMethod("hashResize", *this, &LruCacheTest::resize<cxxtools::HashLruCache<int, int> >);
+            registerMethod("hashStats", *this, &LruCacheTest::stats<cxxtools::HashLruCache<int, int> >);
+            registerMethod("hashOrder", *this, &LruCacheTest::hashOrder);
+            registerMethod("hashStringKey", *this, &LruCacheTest::hashStringKey);
+            registerMethod("timing", *this, &LruCacheTest::timing);
         }
 
+        template <typename CacheType>
         void cacheTest()
         {
-          cxxtools::LruCache<int, int> cache(6);
+          CacheType cache(6);
 
           cache.put(1, 10);
           cache.put(2, 20);
@@ -68,9 +80,10 @@ class LruCacheTest : public cxxtools::unit::TestSuite
 
         }
 
+        template <typename CacheType>
         void erase()
         {
-          cxxtools::LruCache<int, int> cache(6);
+          CacheType cache(6);
 
           cache.put(1, 10);
           cache.put(2, 20);
@@ -94,9 +107,10 @@ class LruCacheTest : public cxxtools::unit::TestSuite
         }
 
 
+        template <typename CacheType>
         void resize()
         {
-          cxxtools::LruCache<int, int> cache(6);
+          CacheType cache(6);
 
           cache.put(1, 10);
           cache.put(2, 20);
@@ -140,9 +154,10 @@ class LruCacheTest : public cxxtools::unit::TestSuite
 
         }
 
+        template <typename CacheType>
         void stats()
         {
-          cxxtools::LruCache<int, int> cache(6);
+          CacheType cache(6);
 
           cache.put(1, 10);
           cache.put(2, 20);
@@ -158,6 +173,83 @@ class LruCacheTest : public cxxtools::unit::TestSuite
           CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 1);
         }
 
+        void hashOrder()
+        {
+          cxxtools::HashLruCache<int, int> cache(3);
+
+          cache.put(1, 10);
+          cache.put(2, 20);
+          cache.put(3, 30);
+
+          // a hit makes 1 the most recently used element, so 2 is dropped
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(1), 10);
+          cache.put(4, 40);
+
+          CXXTOOLS_UNIT_ASSERT(cache.getx(1).first);
+          CXXTOOLS_UNIT_ASSERT(!cache.getx(2).first);
+          CXXTOOLS_UNIT_ASSERT(cache.getx(3).first);
+          CXXTOOLS_UNIT_ASSERT(cache.getx(4).first);
+
+          // put replaces the value of a existing element
+          cache.put(3, 31);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(3), 31);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 3u);
+        }
+
+        void hashStringKey()
+        {
+          cxxtools::HashLruCache<std::string, int> cache(100);
+
+          cache.put("foo", 1);
+          cache.put("bar", 2);
+
+          // lookup by const char* without a temporary std::string
+          const char* key = "foo";
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(key), 1);
+          CXXTOOLS_UNIT_ASSERT(!cache.getx("baz").first);
+          CXXTOOLS_UNIT_ASSERT(cache.erase("bar"));
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 1u);
+        }
+
+        template <typename CacheType>
+        void timeCache(const char* name, unsigned count, unsigned evictions)
+        {
+          CacheType cache(count);
+          cxxtools::Clock clock;
+
+          clock.start();
+          for (unsigned n = 0; n < count; ++n)
+            cache.put(n, n);
+          cxxtools::Timespan tput = clock.stop();
+
+          clock.start();
+          for (unsigned n = 0; n < count; ++n)
+            cache.getx((n * 7919) % count);
+          cxxtools::Timespan tget = clock.stop();
+
+          clock.start();
+          for (unsigned n = 0; n < evictions; ++n)
+            cache.put(count + n, n);
+          cxxtools::Timespan tevict = clock.stop();
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), count);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), count);
+
+          std::cout << '\t' << name << ": " << count << " puts " << tput.totalMSecs()
+                    << " ms, " << count << " gets " << tget.totalMSecs()
+                    << " ms, " << evictions << " evictions " << tevict.totalMSecs() << " ms" << std::endl;
+        }
+
+        void timing()
+        {
+          // LruCache scans all elements for every eviction, so it gets
+          // only a few of them
+          std::cout << '\n';
+          timeCache<cxxtools::LruCache<unsigned, unsigned> >("LruCache", 1000000, 100);
+          timeCache<cxxtools::HashLruCache<unsigned, unsigned> >("HashLruCache", 1000000, 100);
+          timeCache<cxxtools::HashLruCache<unsigned, unsigned> >("HashLruCache", 1000000, 1000000);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<LruCacheTest> register_LruCacheTest;
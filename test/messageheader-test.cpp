@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/messageheader.h"
+#include "cxxtools/convert.h"
+#include <stdexcept>
+
+class MessageHeaderTest : public cxxtools::unit::TestSuite
+{
+    public:
+        MessageHeaderTest()
+        : cxxtools::unit::TestSuite("messageheader")
+        {
+            registerMethod("getHeader", *this, &MessageHeaderTest::getHeader);
+            registerMethod("modify", *this, &MessageHeaderTest::modify);
+            registerMethod("manyHeaders", *this, &MessageHeaderTest::manyHeaders);
+            registerMethod("contentLength", *this, &MessageHeaderTest::contentLength);
+            registerMethod("removeHeader", *this, &MessageHeaderTest::removeHeader);
+            registerMethod("embeddedNul", *this, &MessageHeaderTest::embeddedNul);
+        }
+
+        void getHeader()
+        {
+            cxxtools::http::MessageHeader header;
+            header.addHeader("Content-Type", "text/html");
+            header.addHeader("X-Foo", "first");
+            header.addHeader("x-foo", "second");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(header.getHeader("content-type")), "text/html");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(header.getHeader("CONTENT-TYPE")), "text/html");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(header.getHeader("X-FOO")), "first");
+            CXXTOOLS_UNIT_ASSERT(!header.hasHeader("Content-Length"));
+            CXXTOOLS_UNIT_ASSERT(header.isHeaderValue("content-type", "TEXT/HTML"));
+        }
+
+        void modify()
+        {
+            cxxtools::http::MessageHeader header;
+            header.addHeader("Connection", "close");
+            CXXTOOLS_UNIT_ASSERT(!header.keepAlive());
+
+            header.setHeader("Connection", "Keep-Alive");
+            CXXTOOLS_UNIT_ASSERT(header.keepAlive());
+
+            header.removeHeader("connection");
+            CXXTOOLS_UNIT_ASSERT(!header.hasHeader("Connection"));
+
+            header.addHeader("Transfer-Encoding", "chunked");
+            CXXTOOLS_UNIT_ASSERT(header.chunkedTransferEncoding());
+
+            header.clear();
+            CXXTOOLS_UNIT_ASSERT(!header.chunkedTransferEncoding());
+        }
+
+        void manyHeaders()
+        {
+            cxxtools::http::MessageHeader header;
+            for (unsigned n = 0; n < 200; ++n)
+                header.addHeader(("X-Header-" + cxxtools::convert<std::string>(n)).c_str(),
+                                 cxxtools::convert<std::string>(n).c_str());
+
+            for (unsigned n = 0; n < 200; ++n)
+            {
+                const char* value = header.getHeader(("x-header-" + cxxtools::convert<std::string>(n)).c_str());
+                CXXTOOLS_UNIT_ASSERT(value != 0);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(value), cxxtools::convert<std::string>(n));
+            }
+
+            CXXTOOLS_UNIT_ASSERT(!header.hasHeader("X-Header-200"));
+        }
+
+        void contentLength()
+        {
+            cxxtools::http::MessageHeader header;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(header.contentLength(), 0u);
+
+            header.addHeader("Content-Length", "1234");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(header.contentLength(), 1234u);
+
+            header.setHeader("content-length", "42");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(header.contentLength(), 42u);
+
+            header.removeHeader("Content-Length");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(header.contentLength(), 0u);
+
+            for (unsigned n = 0; n < 100; ++n)
+                header.addHeader(("X-Header-" + cxxtools::convert<std::string>(n)).c_str(), "x");
+
+            header.addHeader("Content-Length", "17");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(header.contentLength(), 17u);
+        }
+
+        void removeHeader()
+        {
+            cxxtools::http::MessageHeader header;
+            header.addHeader("X-First", "1");
+            header.addHeader("X-Second", "2");
+            header.addHeader("X-Third", "3");
+
+            header.removeHeader("x-first");
+
+            const cxxtools::http::MessageHeader& cheader = header;
+            CXXTOOLS_UNIT_ASSERT(!cheader.hasHeader("X-First"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(cheader.getHeader("X-Second")), "2");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(cheader.getHeader("X-Third")), "3");
+        }
+
+        void embeddedNul()
+        {
+            static const char value[] = "a\0Content-Length";
+            cxxtools::http::MessageHeader header;
+            header.addHeader("X", 1, value, sizeof(value) - 1);
+            header.addHeader("Host", 4, "h", 1);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(header.getHeader("X")), "a");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(header.getHeader("Host")), "h");
+            CXXTOOLS_UNIT_ASSERT(!header.hasHeader("Content-Length"));
+            CXXTOOLS_UNIT_ASSERT_THROW(header.addHeader("Y\0Z", 3, "b", 1), std::runtime_error);
+        }
+
+};
+
+cxxtools::unit::RegisterTest<MessageHeaderTest> register_MessageHeaderTest;
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/mutex.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+#include <pthread.h>
+
+namespace
+{
+    unsigned loops = 0;
+    unsigned writeRatio = 0;
+    volatile unsigned shared = 0;
+
+    pthread_mutex_t pthreadMutex = PTHREAD_MUTEX_INITIALIZER;
+    cxxtools::Mutex mutex;
+    cxxtools::SpinMutex spinMutex;
+    cxxtools::ReadWriteMutex rwMutex;
+    cxxtools::ShardedReadWriteMutex shardedMutex;
+
+    void benchPthread()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            pthread_mutex_lock(&pthreadMutex);
+            ++shared;
+            pthread_mutex_unlock(&pthreadMutex);
+        }
+    }
+
+    void benchMutex()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            cxxtools::MutexLock lock(mutex);
+            ++shared;
+        }
+    }
+
+    void benchSpinMutex()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            cxxtools::SpinLock lock(spinMutex);
+            ++shared;
+        }
+    }
+
+    // read mostly: every writeRatio'th operation takes a write lock
+    void benchReadWriteMutex()
+    {
+        unsigned sum = 0;
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            if (writeRatio && n % writeRatio == 0)
+            {
+                cxxtools::WriteLock lock(rwMutex);
+                ++shared;
+            }
+            else
+            {
+                cxxtools::ReadLock lock(rwMutex);
+                sum += shared;
+            }
+        }
+    }
+
+    void benchShardedReadWriteMutex()
+    {
+        unsigned sum = 0;
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            if (writeRatio && n % writeRatio == 0)
+            {
+                cxxtools::ShardedWriteLock lock(shardedMutex);
+                ++shared;
+            }
+            else
+            {
+                cxxtools::ShardedReadLock lock(shardedMutex);
+                sum += shared;
+            }
+        }
+    }
+
+    void run(const char* name, void (*fn)(), unsigned threads)
+    {
+        std::vector<cxxtools::AttachedThread*> workers;
+        for (unsigned n = 0; n < threads; ++n)
+            workers.push_back(new cxxtools::AttachedThread(cxxtools::callable(fn)));
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        for (unsigned n = 0; n < threads; ++n)
+            workers[n]->start();
+
+        for (unsigned n = 0; n < threads; ++n)
+        {
+            workers[n]->join();
+            delete workers[n];
+        }
+
+        cxxtools::Timespan t = clock.stop();
+
+        double total = static_cast<double>(loops) * threads;
+        std::cout << name << '\t' << threads << " threads\t"
+                  << (t.totalUSecs() * 1000.0 / total) << " ns/op" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> threads(argc, argv, 't', 0);
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 16);
+        cxxtools::Arg<unsigned> n(argc, argv, 'n', 1000000);
+        cxxtools::Arg<unsigned> w(argc, argv, 'w', 100);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -t number  run with the given number of threads only\n"
+                         "   -T number  maximum number of threads (default: 16)\n"
+                         "   -n number  lock operations per thread (default: 1000000)\n"
+                         "   -w number  one write lock per number read locks (default: 100, 0: no writes)\n";
+            return -1;
+        }
+
+        loops = n;
+        writeRatio = w;
+
+        unsigned minT = threads.isSet() ? threads.getValue() : 1;
+        unsigned maxT = threads.isSet() ? threads.getValue() : maxThreads.getValue();
+
+        for (unsigned t = minT; t > 0 && t <= maxT; t *= 2)
+        {
+            run("pthread_mutex", benchPthread, t);
+            run("Mutex", benchMutex, t);
+            run("SpinMutex", benchSpinMutex, t);
+            run("ReadWriteMutex", benchReadWriteMutex, t);
+            run("ShardedReadWriteMutex", benchShardedReadWriteMutex, t);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/mutex.h"
+#include "cxxtools/condition.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <vector>
+
+class MutexTest : public cxxtools::unit::TestSuite
+{
+        cxxtools::Mutex _mutex;
+        cxxtools::Condition _condition;
+        cxxtools::SpinMutex _spinMutex;
+        cxxtools::ShardedReadWriteMutex _rwMutex;
+        unsigned _counter;
+        unsigned _value1;
+        unsigned _value2;
+        unsigned _inconsistent;
+        bool _ready;
+
+        void incrementMutex()
+        {
+            for (unsigned n = 0; n < 20000; ++n)
+            {
+                cxxtools::MutexLock lock(_mutex);
+                ++_counter;
+            }
+        }
+
+        void incrementSpin()
+        {
+            for (unsigned n = 0; n < 20000; ++n)
+            {
+                cxxtools::SpinLock lock(_spinMutex);
+                ++_counter;
+            }
+        }
+
+        void signalReady()
+        {
+            cxxtools::MutexLock lock(_mutex);
+            _ready = true;
+            _condition.signal();
+        }
+
+        void reader()
+        {
+            for (unsigned n = 0; n < 20000; ++n)
+            {
+                cxxtools::ShardedReadLock lock(_rwMutex);
+                if (_value1 != _value2)
+                    ++_inconsistent;
+            }
+        }
+
+        void writer()
+        {
+            for (unsigned n = 0; n < 2000; ++n)
+            {
+                cxxtools::ShardedWriteLock lock(_rwMutex);
+                ++_value1;
+                cxxtools::Thread::yield();
+                ++_value2;
+            }
+        }
+
+        template <typename Obj>
+        void runThreads(Obj& obj, void (Obj::*fn)(), unsigned count)
+        {
+            std::vector<cxxtools::AttachedThread*> threads;
+            for (unsigned n = 0; n < count; ++n)
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(obj, fn)));
+            for (unsigned n = 0; n < count; ++n)
+                threads[n]->start();
+            for (unsigned n = 0; n < count; ++n)
+            {
+                threads[n]->join();
+                delete threads[n];
+            }
+        }
+
+    public:
+        MutexTest()
+        : cxxtools::unit::TestSuite("mutex")
+        {
+            registerMethod("lock", *this, &MutexTest::lock);
+            registerMethod("mutexThreads", *this, &MutexTest::mutexThreads);
+            registerMethod("spinThreads", *this, &MutexTest::spinThreads);
+            registerMethod("conditionSignal", *this, &MutexTest::conditionSignal);
+            registerMethod("conditionTimeout", *this, &MutexTest::conditionTimeout);
+            registerMethod("shardedReadWrite", *this, &MutexTest::shardedReadWrite);
+            registerMethod("shardedThreads", *this, &MutexTest::shardedThreads);
+        }
+
+        void setUp()
+        {
+            _counter = 0;
+            _value1 = _value2 = 0;
+            _inconsistent = 0;
+            _ready = false;
+        }
+
+        void lock()
+        {
+            cxxtools::Mutex mutex;
+            mutex.lock();
+            CXXTOOLS_UNIT_ASSERT(!mutex.tryLock());
+            mutex.unlock();
+            CXXTOOLS_UNIT_ASSERT(mutex.tryLock());
+            mutex.unlock();
+            CXXTOOLS_UNIT_ASSERT(!mutex.unlockNoThrow());
+
+            cxxtools::RecursiveMutex rmutex;
+            rmutex.lock();
+            CXXTOOLS_UNIT_ASSERT(rmutex.tryLock());
+            rmutex.unlock();
+            rmutex.unlock();
+        }
+
+        void mutexThreads()
+        {
+            runThreads(*this, &MutexTest::incrementMutex, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_counter, 80000u);
+        }
+
+        void spinThreads()
+        {
+            runThreads(*this, &MutexTest::incrementSpin, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_counter, 80000u);
+        }
+
+        void conditionSignal()
+        {
+            cxxtools::AttachedThread thread(cxxtools::callable(*this, &MutexTest::signalReady));
+
+            cxxtools::MutexLock lock(_mutex);
+            thread.start();
+            while (!_ready)
+                _condition.wait(lock);
+
+            CXXTOOLS_UNIT_ASSERT(_ready);
+        }
+
+        void conditionTimeout()
+        {
+            cxxtools::MutexLock lock(_mutex);
+            cxxtools::Timespan t0 = cxxtools::Timespan::gettimeofday();
+            bool ret = _condition.wait(lock, cxxtools::Milliseconds(50));
+            cxxtools::Timespan t = cxxtools::Timespan::gettimeofday() - t0;
+
+            CXXTOOLS_UNIT_ASSERT(!ret);
+            CXXTOOLS_UNIT_ASSERT(t >= cxxtools::Milliseconds(40));
+            CXXTOOLS_UNIT_ASSERT(_mutex.tryLock() == false);
+        }
+
+        void shardedReadWrite()
+        {
+            cxxtools::ShardedReadWriteMutex mutex;
+
+            mutex.readLock();
+            CXXTOOLS_UNIT_ASSERT(mutex.tryReadLock());
+            CXXTOOLS_UNIT_ASSERT(!mutex.tryWriteLock());
+            mutex.readUnlock();
+            mutex.readUnlock();
+
+            CXXTOOLS_UNIT_ASSERT(mutex.tryWriteLock());
+            CXXTOOLS_UNIT_ASSERT(!mutex.tryReadLock());
+            mutex.writeUnlock();
+
+            CXXTOOLS_UNIT_ASSERT(mutex.tryReadLock());
+            mutex.readUnlock();
+        }
+
+        void shardedThreads()
+        {
+            cxxtools::AttachedThread w(cxxtools::callable(*this, &MutexTest::writer));
+            w.start();
+            runThreads(*this, &MutexTest::reader, 3);
+            w.join();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_inconsistent, 0u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_value1, 2000u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_value2, 2000u);
+        }
+};
+
+cxxtools::unit::RegisterTest<MutexTest> register_MutexTest;
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/pool.h>
+#include <cxxtools/concurrentpool.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    struct Object
+    {
+        char data[64];
+    };
+
+    typedef cxxtools::Pool<Object> LockedPool;
+    typedef cxxtools::ConcurrentPool<Object> LockFreePool;
+
+    unsigned cycles = 0;
+
+    template <typename PoolType>
+    struct Worker
+    {
+        PoolType* pool;
+
+        explicit Worker(PoolType& pool_)
+            : pool(&pool_)
+            { }
+
+        void run()
+        {
+            for (unsigned n = 0; n < cycles; ++n)
+            {
+                typename PoolType::Ptr p = pool->get();
+                p->data[0] = static_cast<char>(n);
+            }
+        }
+    };
+
+    template <typename PoolType>
+    void bench(const char* name, PoolType& pool, unsigned threads)
+    {
+        Worker<PoolType> worker(pool);
+        std::vector<cxxtools::AttachedThread*> workers;
+        for (unsigned n = 0; n < threads; ++n)
+            workers.push_back(new cxxtools::AttachedThread(cxxtools::callable(worker, &Worker<PoolType>::run)));
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        for (unsigned n = 0; n < threads; ++n)
+            workers[n]->start();
+
+        for (unsigned n = 0; n < threads; ++n)
+        {
+            workers[n]->join();
+            delete workers[n];
+        }
+
+        cxxtools::Timespan t = clock.stop();
+
+        unsigned total = cycles * threads;
+        std::cout << name << '\t' << threads << " threads\t"
+                  << total << " cycles in " << t.totalSeconds() << " s => "
+                  << (total / t.totalSeconds()) << "#/s" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> threads(argc, argv, 't', 0);
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 32);
+        cxxtools::Arg<unsigned> n(argc, argv, 'n', 1000000);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -t number  run with the given number of threads only\n"
+                         "   -T number  maximum number of threads (default: 32)\n"
+                         "   -n number  get/release cycles per thread (default: 1000000)\n";
+            return -1;
+        }
+
+        cycles = n;
+
+        unsigned minT = threads.isSet() ? threads.getValue() : 1;
+        unsigned maxT = threads.isSet() ? threads.getValue() : maxThreads.getValue();
+
+        for (unsigned t = minT; t > 0 && t <= maxT; t *= 2)
+        {
+            LockedPool lockedPool;
+            bench("Pool", lockedPool, t);
+
+            LockFreePool lockFreePool;
+            lockFreePool.prewarm(t);
+            bench("ConcurrentPool", lockFreePool, t);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/queue.h>
+#include <cxxtools/lockfreequeue.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+
+// Measures the throughput of cxxtools::Queue and cxxtools::LockFreeQueue
+// with a growing number of producer and consumer threads.
+
+template <typename QueueType>
+class QueueBench
+{
+        QueueType& _queue;
+        unsigned _count;
+
+        void produce()
+        {
+            for (unsigned n = 1; n <= _count; ++n)
+                _queue.put(n);
+        }
+
+        void consume()
+        {
+            while (_queue.get() != 0)
+                ;
+        }
+
+    public:
+        QueueBench(QueueType& queue, unsigned count)
+            : _queue(queue),
+              _count(count)
+        { }
+
+        cxxtools::Timespan run(unsigned threads)
+        {
+            std::vector<cxxtools::AttachedThread*> consumers;
+            std::vector<cxxtools::AttachedThread*> producers;
+
+            for (unsigned n = 0; n < threads; ++n)
+            {
+                consumers.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &QueueBench::consume)));
+                producers.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &QueueBench::produce)));
+            }
+
+            cxxtools::Clock clock;
+            clock.start();
+
+            for (unsigned n = 0; n < threads; ++n)
+            {
+                consumers[n]->start();
+                producers[n]->start();
+            }
+
+            for (unsigned n = 0; n < threads; ++n)
+                producers[n]->join();
+
+            for (unsigned n = 0; n < threads; ++n)
+                _queue.put(0);
+
+            for (unsigned n = 0; n < threads; ++n)
+                consumers[n]->join();
+
+            cxxtools::Timespan t = clock.stop();
+
+            for (unsigned n = 0; n < threads; ++n)
+            {
+                delete consumers[n];
+                delete producers[n];
+            }
+
+            return t;
+        }
+};
+
+void report(const char* name, unsigned threads, unsigned count, cxxtools::Timespan t)
+{
+    std::cout << name << '\t' << threads << " producers/consumers\t"
+              << count << " elements in " << t.totalSeconds() << " s => "
+              << (count / t.totalSeconds()) << "#/s" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 16);
+        cxxtools::Arg<unsigned> count(argc, argv, 'n', 1000000);
+        cxxtools::Arg<unsigned> capacity(argc, argv, 'c', 1024);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -T number  maximum number of producer and consumer threads (default: 16)\n"
+                         "   -n number  number of elements (default: 1000000)\n"
+                         "   -c number  capacity of the queues (default: 1024)\n";
+            return -1;
+        }
+
+        for (unsigned t = 1; t <= maxThreads; t *= 2)
+        {
+            unsigned perThread = count / t;
+
+            {
+                cxxtools::Queue<unsigned> queue;
+                queue.maxSize(capacity);
+                QueueBench<cxxtools::Queue<unsigned> > bench(queue, perThread);
+                report("Queue", t, perThread * t, bench.run(t));
+            }
+
+            {
+                cxxtools::LockFreeQueue<unsigned> queue(capacity);
+                QueueBench<cxxtools::LockFreeQueue<unsigned> > bench(queue, perThread);
+                report("LockFreeQueue", t, perThread * t, bench.run(t));
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/atomicity.h>
+#include <cxxtools/smartptr.h>
+#include <cxxtools/refcounted.h>
+#include <cxxtools/spinlockedsmartptr.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    unsigned loops = 0;
+    volatile cxxtools::atomic_t counter = 0;
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    // the former hand written x86_64 implementation as a reference
+    __attribute__((noinline)) cxxtools::atomic_t asmIncrement(volatile cxxtools::atomic_t& val)
+    {
+        cxxtools::atomic_t tmp = 1;
+        asm volatile ("lock; xaddq %0, %1" : "+r" (tmp), "+m" (val) : : "memory");
+        return tmp + 1;
+    }
+
+    __attribute__((noinline)) cxxtools::atomic_t asmDecrement(volatile cxxtools::atomic_t& val)
+    {
+        cxxtools::atomic_t tmp = -1;
+        asm volatile ("lock; xaddq %0, %1" : "+r" (tmp), "+m" (val) : : "memory");
+        return tmp - 1;
+    }
+
+    __attribute__((noinline)) cxxtools::atomic_t asmGet(volatile cxxtools::atomic_t& val)
+    {
+        asm volatile ("mfence" : : : "memory");
+        return val;
+    }
+
+    void benchAsm()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            asmIncrement(counter);
+            asmDecrement(counter);
+        }
+    }
+
+    void benchAsmGet()
+    {
+        cxxtools::atomic_t sum = 0;
+        for (unsigned n = 0; n < loops; ++n)
+            sum += asmGet(counter);
+        if (sum == 1)
+            std::cout << sum;
+    }
+#endif
+
+    void benchFull()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            cxxtools::atomicIncrement(counter);
+            cxxtools::atomicDecrement(counter);
+        }
+    }
+
+    void benchRef()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            cxxtools::atomicRefIncrement(counter);
+            cxxtools::atomicRefDecrement(counter);
+        }
+    }
+
+    void benchGet()
+    {
+        cxxtools::atomic_t sum = 0;
+        for (unsigned n = 0; n < loops; ++n)
+            sum += cxxtools::atomicGet(counter);
+        if (sum == 1)
+            std::cout << sum;
+    }
+
+    class Object : public cxxtools::AtomicRefCounted
+    {
+    };
+
+    typedef cxxtools::SmartPtr<Object> Ptr;
+
+    Ptr sharedPtr;
+    cxxtools::SpinLockedSmartPtr<Object> atomicPtr;
+    cxxtools::Mutex mutex;
+
+    void benchSmartPtr()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+            Ptr p(sharedPtr);
+    }
+
+    void benchSpinLockedSmartPtr()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+            Ptr p = atomicPtr.load();
+    }
+
+    void benchMutexSmartPtr()
+    {
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            Ptr p;
+            {
+                cxxtools::MutexLock lock(mutex);
+                p = sharedPtr;
+            }
+        }
+    }
+
+    void run(const char* name, void (*fn)(), unsigned threads)
+    {
+        std::vector<cxxtools::AttachedThread*> workers;
+        for (unsigned n = 0; n < threads; ++n)
+            workers.push_back(new cxxtools::AttachedThread(cxxtools::callable(fn)));
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        for (unsigned n = 0; n < threads; ++n)
+            workers[n]->start();
+
+        for (unsigned n = 0; n < threads; ++n)
+        {
+            workers[n]->join();
+            delete workers[n];
+        }
+
+        cxxtools::Timespan t = clock.stop();
+
+        double total = static_cast<double>(loops) * threads;
+        std::cout << name << '\t' << threads << " threads\t"
+                  << (t.totalUSecs() * 1000.0 / total) << " ns/op" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> threads(argc, argv, 't', 0);
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 8);
+        cxxtools::Arg<unsigned> n(argc, argv, 'n', 10000000);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -t number  run with the given number of threads only\n"
+                         "   -T number  maximum number of threads (default: 8)\n"
+                         "   -n number  operations per thread (default: 10000000)\n";
+            return -1;
+        }
+
+        loops = n;
+        sharedPtr = new Object();
+        atomicPtr.store(sharedPtr);
+
+        unsigned minT = threads.isSet() ? threads.getValue() : 1;
+        unsigned maxT = threads.isSet() ? threads.getValue() : maxThreads.getValue();
+
+        for (unsigned t = minT; t > 0 && t <= maxT; t *= 2)
+        {
+#if defined(__x86_64__) && defined(__GNUC__)
+            run("asm inc/dec", benchAsm, t);
+#endif
+            run("atomic inc/dec", benchFull, t);
+            run("refcount inc/dec", benchRef, t);
+#if defined(__x86_64__) && defined(__GNUC__)
+            run("asm get", benchAsmGet, t);
+#endif
+            run("atomic get", benchGet, t);
+            run("SmartPtr copy", benchSmartPtr, t);
+            run("SpinLockedSmartPtr load", benchSpinLockedSmartPtr, t);
+            run("mutex SmartPtr load", benchMutexSmartPtr, t);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -79,6 +79,7 @@ int main(int argc, char* argv[])
     cxxtools::Arg<std::string> sslCert(argc, argv, 'c');
     cxxtools::Arg<unsigned> threads(argc, argv, 't', 4);
     cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 200);
+    cxxtools::Arg<bool> ioUring(argc, argv, 'U');
 
     std::cout << "rpc echo server running on port " << port.getValue() << "\n\n"
                  "options:\n\n"
@@ -89,9 +90,12 @@ int main(int argc, char* argv[])
                  "   -c cert    enable ssl using the specified server certificate\n"
                  "   -t number  set minimum number of threads (default: 4)\n"
                  "   -T number  set maximum number of threads (default: 200)\n"
+                 "   -U         wait for I/O using io_uring\n"
               << std::endl;
 
     cxxtools::EventLoop loop;
+    if (ioUring && !loop.useIoUring())
+      std::cerr << "io_uring not available; using poll" << std::endl;
 
     cxxtools::http::Server server(loop, ip, port, sslCert);
     server.minThreads(threads);
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/selector.h>
+#include <cxxtools/timer.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    cxxtools::Selector* selector = 0;
+    volatile cxxtools::atomic_t wakeTime = 0;
+    unsigned wakeups = 0;
+
+    // wakes the selector with a pause between the wake ups, so that the
+    // selector is blocked in poll each time
+    void waker()
+    {
+        for (unsigned n = 0; n < wakeups; ++n)
+        {
+            while (cxxtools::atomicGet(wakeTime) != 0)
+                cxxtools::Thread::yield();
+
+            cxxtools::Thread::sleep(cxxtools::Milliseconds(1));
+
+            cxxtools::atomicSet(wakeTime, cxxtools::Timespan::gettimeofday().totalUSecs());
+            selector->wake();
+        }
+    }
+
+    void wakeLatency(unsigned n)
+    {
+        cxxtools::Selector s;
+        selector = &s;
+        wakeups = n;
+        cxxtools::atomicSet(wakeTime, 0);
+
+        cxxtools::AttachedThread thread(cxxtools::callable(waker));
+        thread.start();
+
+        int64_t sum = 0;
+        int64_t max = 0;
+        for (unsigned count = 0; count < n; )
+        {
+            s.wait(cxxtools::Selector::WaitInfinite);
+
+            int64_t t = cxxtools::atomicGet(wakeTime);
+            if (t == 0)
+                continue;
+
+            int64_t latency = cxxtools::Timespan::gettimeofday().totalUSecs() - t;
+            sum += latency;
+            if (latency > max)
+                max = latency;
+
+            ++count;
+            cxxtools::atomicSet(wakeTime, 0);
+        }
+
+        thread.join();
+
+        std::cout << "wake\t" << n << " wake ups => "
+                  << (sum / static_cast<double>(n)) << " us average, " << max << " us max latency" << std::endl;
+    }
+
+    class TimerProbe : public cxxtools::Connectable
+    {
+    public:
+        cxxtools::Timer timer;
+        unsigned count;
+        int64_t sum;
+        int64_t max;
+
+        TimerProbe()
+            : count(0),
+              sum(0),
+              max(0)
+        {
+            cxxtools::connect(timer.timeout, *this, &TimerProbe::onTimeout);
+        }
+
+        // the timer already moved to the next interval, when the signal is sent
+        void onTimeout()
+        {
+            int64_t due = (timer.finished() - timer.interval()).totalUSecs();
+            int64_t latency = cxxtools::Timespan::gettimeofday().totalUSecs() - due;
+            sum += latency;
+            if (latency > max)
+                max = latency;
+            ++count;
+        }
+    };
+
+    void timerLatency(unsigned timers, unsigned intervalMs, unsigned durationMs)
+    {
+        cxxtools::Selector s;
+        std::vector<TimerProbe*> probes;
+
+        for (unsigned n = 0; n < timers; ++n)
+        {
+            TimerProbe* p = new TimerProbe();
+            s.add(p->timer);
+            p->timer.start(cxxtools::Milliseconds(intervalMs + n % intervalMs));
+            probes.push_back(p);
+        }
+
+        cxxtools::Timespan end = cxxtools::Timespan::gettimeofday() + cxxtools::Milliseconds(durationMs);
+        unsigned iterations = 0;
+        while (cxxtools::Timespan::gettimeofday() < end)
+        {
+            s.wait(cxxtools::Milliseconds(durationMs));
+            ++iterations;
+        }
+
+        unsigned count = 0;
+        int64_t sum = 0;
+        int64_t max = 0;
+        for (unsigned n = 0; n < probes.size(); ++n)
+        {
+            count += probes[n]->count;
+            sum += probes[n]->sum;
+            if (probes[n]->max > max)
+                max = probes[n]->max;
+            delete probes[n];
+        }
+
+        std::cout << "timer\t" << timers << " timers\t" << count << " timeouts in " << iterations << " iterations => "
+                  << (count ? sum / static_cast<double>(count) : 0.0) << " us average, " << max << " us max latency" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> n(argc, argv, 'n', 1000);
+        cxxtools::Arg<unsigned> interval(argc, argv, 'i', 2);
+        cxxtools::Arg<unsigned> duration(argc, argv, 'd', 1000);
+        cxxtools::Arg<unsigned> maxTimers(argc, argv, 'T', 1000);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -n number  number of wake ups (default: 1000)\n"
+                         "   -i ms      minimum timer interval (default: 2)\n"
+                         "   -d ms      duration of each timer run (default: 1000)\n"
+                         "   -T number  maximum number of timers (default: 1000)\n";
+            return -1;
+        }
+
+        wakeLatency(n);
+
+        for (unsigned t = 1; t <= maxTimers; t *= 10)
+            timerLatency(t, interval, duration);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -30,6 +30,8 @@
 
 #include "cxxtools/smartptr.h"
 #include "cxxtools/refcounted.h"
+#include "cxxtools/spinlockedsmartptr.h"
+#include "cxxtools/thread.h"
 #include "cxxtools/unit/assertion.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
@@ -63,6 +65,24 @@ class AtomicObject : public cxxtools::AtomicRefCounted
 
 std::size_t AtomicObject::objectRefs = 0;
 
+class Snapshot : public cxxtools::AtomicRefCounted
+{
+    public:
+        explicit Snapshot(unsigned value_)
+        : value(value_), check(value_)
+        { cxxtools::atomicIncrement(objectRefs); }
+
+        ~Snapshot()
+        { check = 0; cxxtools::atomicDecrement(objectRefs); }
+
+        unsigned value;
+        unsigned check;
+
+        static cxxtools::atomic_t objectRefs;
+};
+
+cxxtools::atomic_t Snapshot::objectRefs = 0;
+
 
 class SmartPtrTest : public cxxtools::unit::TestSuite
 {
@@ -74,6 +94,9 @@ class SmartPtrTest : public cxxtools::unit::TestSuite
             registerMethod( "InternalRefCounted", *this, &SmartPtrTest::InternalRefCounted );
             registerMethod( "AtomicInternalRefCounted", *this, &SmartPtrTest::AtomicInternalRefCounted );
             registerMethod( "RefLinked", *this, &SmartPtrTest::RefLinked );
+            registerMethod( "ExternalAtomicRefCounted", *this, &SmartPtrTest::ExternalAtomicRefCounted );
+            registerMethod( "SpinLockedSmartPtr", *this, &SmartPtrTest::SpinLockedSmartPtr );
+            registerMethod( "SpinLockedSmartPtrThreads", *this, &SmartPtrTest::SpinLockedSmartPtrThreads );
         }
 
     public:
@@ -84,6 +107,16 @@ class SmartPtrTest : public cxxtools::unit::TestSuite
         void InternalRefCounted();
         void AtomicInternalRefCounted();
         void RefLinked();
+        void ExternalAtomicRefCounted();
+        void SpinLockedSmartPtr();
+        void SpinLockedSmartPtrThreads();
+
+    private:
+        typedef cxxtools::SpinLockedSmartPtr<Snapshot> SharedSnapshot;
+        SharedSnapshot* _shared;
+        cxxtools::atomic_t _failures;
+
+        void reader();
 };
 
 cxxtools::unit::RegisterTest<SmartPtrTest> register_SmartPtrTest;
@@ -189,3 +222,97 @@ void SmartPtrTest::RefLinked()
     CXXTOOLS_UNIT_ASSERT(Object::objectRefs == 0);
 }
 
+
+
+void SmartPtrTest::ExternalAtomicRefCounted()
+{
+    Object* obj = new Object();
+
+    typedef cxxtools::SmartPtr<Object, cxxtools::ExternalAtomicRefCounted> Ptr;
+
+    {
+        Ptr smartPtr(obj);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( smartPtr.refs(), 1 );
+
+        Ptr second(smartPtr);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( second.refs(), 2);
+
+        Ptr third;
+        third = second;
+        CXXTOOLS_UNIT_ASSERT_EQUALS( third.refs(), 3);
+    }
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(Object::objectRefs, 0);
+}
+
+
+void SmartPtrTest::SpinLockedSmartPtr()
+{
+    typedef SharedSnapshot::PtrType Ptr;
+
+    {
+        SharedSnapshot shared(Ptr(new Snapshot(1)));
+
+        Ptr p = shared.load();
+        CXXTOOLS_UNIT_ASSERT_EQUALS(p->value, 1u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(p->refs(), 2);
+
+        shared.store(Ptr(new Snapshot(2)));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(shared.load()->value, 2u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(p->refs(), 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(Snapshot::objectRefs, 2);
+
+        // p is outdated, so the exchange fails and p is updated
+        CXXTOOLS_UNIT_ASSERT(!shared.compareExchange(p, Ptr(new Snapshot(3))));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(p->value, 2u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(Snapshot::objectRefs, 1);
+
+        CXXTOOLS_UNIT_ASSERT(shared.compareExchange(p, Ptr(new Snapshot(4))));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(shared.load()->value, 4u);
+
+        Ptr old = shared.exchange(Ptr());
+        CXXTOOLS_UNIT_ASSERT_EQUALS(old->value, 4u);
+        CXXTOOLS_UNIT_ASSERT(!shared.load());
+    }
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(Snapshot::objectRefs, 0);
+}
+
+
+void SmartPtrTest::reader()
+{
+    for (unsigned n = 0; n < 20000; ++n)
+    {
+        SharedSnapshot::PtrType p = _shared->load();
+        if (p->value != p->check)
+            cxxtools::atomicIncrement(_failures);
+    }
+}
+
+
+void SmartPtrTest::SpinLockedSmartPtrThreads()
+{
+    typedef SharedSnapshot::PtrType Ptr;
+
+    Snapshot::objectRefs = 0;
+    _failures = 0;
+
+    {
+        SharedSnapshot shared(Ptr(new Snapshot(0)));
+        _shared = &shared;
+
+        cxxtools::AttachedThread t1(cxxtools::callable(*this, &SmartPtrTest::reader));
+        cxxtools::AttachedThread t2(cxxtools::callable(*this, &SmartPtrTest::reader));
+        t1.start();
+        t2.start();
+
+        for (unsigned n = 1; n <= 20000; ++n)
+            shared.store(Ptr(new Snapshot(n)));
+
+        t1.join();
+        t2.join();
+    }
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(_failures, 0);
+    CXXTOOLS_UNIT_ASSERT_EQUALS(Snapshot::objectRefs, 0);
+}
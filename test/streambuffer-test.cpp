@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/streambuffer.h"
+#include "cxxtools/pipe.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <algorithm>
+#include <ostream>
+#include <string>
+
+class StreamBufferTest : public cxxtools::unit::TestSuite
+{
+    public:
+        StreamBufferTest()
+        : cxxtools::unit::TestSuite("streambuffer")
+        {
+            registerMethod("testWriteRef", *this, &StreamBufferTest::testWriteRef);
+            registerMethod("testWriteRefOverflow", *this, &StreamBufferTest::testWriteRefOverflow);
+        }
+
+        static std::string readAll(cxxtools::Pipe& pipe, size_t n)
+        {
+            std::string ret;
+            char buffer[256];
+            while (ret.size() < n)
+            {
+                size_t c = pipe.read(buffer, std::min(sizeof(buffer), n - ret.size()));
+                ret.append(buffer, c);
+            }
+            return ret;
+        }
+
+        void testWriteRef()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::StreamBuffer sb(pipe.in(), 16);
+            std::ostream os(&sb);
+
+            os << "hello ";
+            sb.writeRef("world", 5);
+            os << '!';
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.out_avail(), 12);
+
+            os.flush();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.out_avail(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(pipe, 12), "hello world!");
+        }
+
+        void testWriteRefOverflow()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::StreamBuffer sb(pipe.in(), 8);
+            std::ostream os(&sb);
+
+            const std::string ref(100, 'x');
+
+            os << "0123456789";
+            sb.writeRef(ref.data(), ref.size());
+            os << "abcdefghijklmnopqrstuvwxyz";
+            sb.writeRef(ref.data(), 3);
+            os << "end";
+            os.flush();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.out_avail(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(pipe, 142),
+                "0123456789" + ref + "abcdefghijklmnopqrstuvwxyz" + "xxx" + "end");
+        }
+};
+
+cxxtools::unit::RegisterTest<StreamBufferTest> register_StreamBufferTest;
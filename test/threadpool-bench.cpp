@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/threadpool.h>
+#include <cxxtools/function.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    cxxtools::atomic_t counter = 0;
+    unsigned mediumLoops = 2000;
+    cxxtools::ThreadPool* pool = 0;
+    unsigned spawnTasks = 0;
+
+    void tinyTask()
+    {
+        cxxtools::atomicIncrement(counter);
+    }
+
+    void mediumTask()
+    {
+        volatile unsigned v = 0;
+        for (unsigned n = 0; n < mediumLoops; ++n)
+            v = v * 31 + n;
+        cxxtools::atomicIncrement(counter);
+    }
+
+    // schedules tiny tasks from a worker thread
+    void spawnTask()
+    {
+        for (unsigned n = 0; n < spawnTasks; ++n)
+            pool->schedule(cxxtools::callable(tinyTask));
+    }
+
+    void report(const char* name, unsigned threads, unsigned tasks, cxxtools::Timespan t)
+    {
+        std::cout << name << '\t' << threads << " threads\t"
+                  << tasks << " tasks in " << t.totalSeconds() << " s => "
+                  << (tasks / t.totalSeconds()) << "#/s" << std::endl;
+    }
+
+    // schedules all tasks from the main thread and waits for their futures
+    void benchSchedule(const char* name, void (*fn)(), unsigned threads, unsigned tasks)
+    {
+        cxxtools::ThreadPool threadPool(threads);
+        std::vector<cxxtools::ThreadPool::Future> futures;
+        futures.reserve(tasks);
+
+        cxxtools::atomicSet(counter, 0);
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        for (unsigned n = 0; n < tasks; ++n)
+            futures.push_back(threadPool.schedule(cxxtools::callable(fn)));
+
+        for (unsigned n = 0; n < tasks; ++n)
+            futures[n].wait();
+
+        cxxtools::Timespan t = clock.stop();
+
+        if (cxxtools::atomicGet(counter) != static_cast<cxxtools::atomic_t>(tasks))
+            std::cerr << "unexpected task count " << cxxtools::atomicGet(counter) << std::endl;
+
+        report(name, threads, tasks, t);
+    }
+
+    // every thread schedules its share of tiny tasks from inside the pool
+    void benchSpawn(unsigned threads, unsigned tasks)
+    {
+        cxxtools::ThreadPool threadPool(threads);
+        pool = &threadPool;
+        spawnTasks = tasks / threads;
+
+        cxxtools::atomicSet(counter, 0);
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        for (unsigned n = 0; n < threads; ++n)
+            threadPool.schedule(cxxtools::callable(spawnTask));
+
+        threadPool.stop();
+
+        cxxtools::Timespan t = clock.stop();
+        pool = 0;
+
+        report("spawn", threads, spawnTasks * threads, t);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> threads(argc, argv, 't', 0);
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 64);
+        cxxtools::Arg<unsigned> tasks(argc, argv, 'n', 100000);
+        cxxtools::Arg<unsigned> loops(argc, argv, 'm', 2000);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -t number  run with the given number of threads only\n"
+                         "   -T number  maximum number of threads (default: 64)\n"
+                         "   -n number  number of tasks (default: 100000)\n"
+                         "   -m number  loop count of medium tasks (default: 2000)\n";
+            return -1;
+        }
+
+        mediumLoops = loops;
+
+        unsigned minT = threads.isSet() ? threads.getValue() : 1;
+        unsigned maxT = threads.isSet() ? threads.getValue() : maxThreads.getValue();
+
+        for (unsigned t = minT; t > 0 && t <= maxT; t *= 2)
+        {
+            benchSchedule("tiny", tinyTask, t, tasks);
+            benchSchedule("medium", mediumTask, t, tasks);
+            benchSpawn(t, tasks);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
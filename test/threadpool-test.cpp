@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/threadpool.h"
+#include "cxxtools/function.h"
+#include "cxxtools/atomicity.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    cxxtools::atomic_t counter = 0;
+    cxxtools::atomic_t started = 0;
+    cxxtools::ThreadPool* pool = 0;
+
+    void increment()
+    {
+        cxxtools::atomicIncrement(counter);
+    }
+
+    void spawn()
+    {
+        // more than fits into the deque of the worker
+        for (unsigned n = 0; n < 10000; ++n)
+            pool->schedule(cxxtools::callable(increment));
+    }
+
+    void block()
+    {
+        cxxtools::atomicSet(started, 1);
+        cxxtools::Thread::sleep(cxxtools::Milliseconds(100));
+    }
+
+    void fail()
+    {
+        throw std::runtime_error("task failed");
+    }
+}
+
+class ThreadPoolTest : public cxxtools::unit::TestSuite
+{
+    public:
+        ThreadPoolTest()
+        : cxxtools::unit::TestSuite("threadpool")
+        {
+            registerMethod("testSchedule", *this, &ThreadPoolTest::testSchedule);
+            registerMethod("testScheduleFromTask", *this, &ThreadPoolTest::testScheduleFromTask);
+            registerMethod("testCancel", *this, &ThreadPoolTest::testCancel);
+            registerMethod("testFailed", *this, &ThreadPoolTest::testFailed);
+        }
+
+        void setUp()
+        {
+            cxxtools::atomicSet(counter, 0);
+            cxxtools::atomicSet(started, 0);
+        }
+
+        void testSchedule()
+        {
+            cxxtools::ThreadPool threadPool(4);
+            std::vector<cxxtools::ThreadPool::Future> futures;
+            for (unsigned n = 0; n < 1000; ++n)
+                futures.push_back(threadPool.schedule(cxxtools::callable(increment)));
+
+            for (unsigned n = 0; n < futures.size(); ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT(futures[n].wait());
+                CXXTOOLS_UNIT_ASSERT(futures[n].isFinished());
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::atomicGet(counter), 1000);
+        }
+
+        void testScheduleFromTask()
+        {
+            cxxtools::ThreadPool threadPool(4);
+            pool = &threadPool;
+
+            threadPool.schedule(cxxtools::callable(spawn));
+            threadPool.schedule(cxxtools::callable(spawn));
+            threadPool.stop();
+            pool = 0;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::atomicGet(counter), 20000);
+        }
+
+        void testCancel()
+        {
+            cxxtools::ThreadPool threadPool(1);
+
+            cxxtools::ThreadPool::Future blocker = threadPool.schedule(cxxtools::callable(block));
+            while (cxxtools::atomicGet(started) == 0)
+                cxxtools::Thread::yield();
+
+            std::vector<cxxtools::ThreadPool::Future> futures;
+            for (unsigned n = 0; n < 10; ++n)
+                futures.push_back(threadPool.schedule(cxxtools::callable(increment)));
+
+            threadPool.stop(true);
+
+            CXXTOOLS_UNIT_ASSERT(blocker.isFinished());
+            CXXTOOLS_UNIT_ASSERT(!blocker.isCanceled());
+            for (unsigned n = 0; n < futures.size(); ++n)
+                CXXTOOLS_UNIT_ASSERT(futures[n].isCanceled());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::atomicGet(counter), 0);
+        }
+
+        void testFailed()
+        {
+            cxxtools::ThreadPool threadPool(2);
+            cxxtools::ThreadPool::Future future = threadPool.schedule(cxxtools::callable(fail));
+            CXXTOOLS_UNIT_ASSERT(future.wait(10));
+            CXXTOOLS_UNIT_ASSERT(future.isFailed());
+        }
+};
+
+cxxtools::unit::RegisterTest<ThreadPoolTest> register_ThreadPoolTest;
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/xml/xmlreader.h>
+#include <cxxtools/xml/startelement.h>
+#include <cxxtools/xml/characters.h>
+#include <cxxtools/xml/xmldeserializer.h>
+#include <cxxtools/xml/xmlwriter.h>
+#include <cxxtools/xml/xmlserializer.h>
+#include <cxxtools/serializationinfo.h>
+#include <cxxtools/textstream.h>
+#include <cxxtools/utf8codec.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    std::string generate(unsigned megabytes)
+    {
+        std::ostringstream data;
+        data << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<records>\n";
+
+        for (unsigned n = 0; data.tellp() < static_cast<std::streamoff>(megabytes) * 1024 * 1024; ++n)
+        {
+            data << "  <record id=\"" << n << "\" type=\"" << (n % 3 ? "person" : "company") << "\">\n"
+                    "    <name>Name " << n << (n % 10 == 0 ? " &amp; Partner" : "") << "</name>\n"
+                    "    <value>" << (n * 0.25) << "</value>\n"
+                    "    <text>Some text with umlauts \xc3\xa4\xc3\xb6\xc3\xbc and a bit more text</text>\n"
+                    "    <empty/>\n"
+                    "  </record>\n";
+        }
+
+        data << "</records>\n";
+        return data.str();
+    }
+
+    // xhtml with many named and numeric entities
+    std::string generateXhtml(unsigned megabytes)
+    {
+        std::ostringstream data;
+        data << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<html xmlns=\"http://www.w3.org/1999/xhtml\"><body>\n";
+
+        for (unsigned n = 0; data.tellp() < static_cast<std::streamoff>(megabytes) * 1024 * 1024; ++n)
+        {
+            data << "<p class=\"c" << n % 7 << "\">Caf&eacute; &amp; cr&egrave;me br&ucirc;l&eacute;e &ndash; "
+                 << n << "&nbsp;&euro; &lt;b&gt;bold&lt;/b&gt; &copy; &quot;quoted&quot; "
+                    "&auml;&ouml;&uuml;&szlig; &#8364; &#x20AC; &hellip;</p>\n";
+        }
+
+        data << "</body></html>\n";
+        return data.str();
+    }
+
+    void report(const char* what, const std::string& data, unsigned long nodes, const cxxtools::Timespan& t)
+    {
+        double secs = t.totalMSecs() / 1000.0;
+        std::cout << what << '\t' << nodes << " nodes in " << secs << " s => "
+                  << (data.size() / secs / 1e6) << " MB/s, "
+                  << static_cast<unsigned long>(nodes / secs) << " nodes/s" << std::endl;
+    }
+
+    unsigned long readAll(cxxtools::xml::XmlReader& reader)
+    {
+        unsigned long nodes = 0;
+        unsigned long attributes = 0;
+        unsigned long chars = 0;
+
+        while (reader.next().type() != cxxtools::xml::Node::EndDocument)
+        {
+            const cxxtools::xml::Node& node = reader.get();
+            if (node.type() == cxxtools::xml::Node::StartElement)
+                attributes += static_cast<const cxxtools::xml::StartElement&>(node).attributes().size();
+            else if (node.type() == cxxtools::xml::Node::Characters)
+                chars += static_cast<const cxxtools::xml::Characters&>(node).content().size();
+            ++nodes;
+        }
+
+        return nodes + (attributes + chars) % 2;
+    }
+
+    // utf-8 bytes from a std::istream
+    void benchBytes(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        cxxtools::xml::XmlReader reader(in);
+        unsigned long nodes = readAll(reader);
+
+        report("XmlReader(std::istream)", data, nodes, clock.stop());
+    }
+
+    // decoded characters from a text stream
+    void benchText(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        cxxtools::TextIStream ts(in, new cxxtools::Utf8Codec());
+        cxxtools::xml::XmlReader reader(ts);
+        unsigned long nodes = readAll(reader);
+
+        report("XmlReader(TextIStream)", data, nodes, clock.stop());
+    }
+
+    // entity dense input
+    void benchEntities(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        cxxtools::xml::XmlReader reader(in);
+        unsigned long nodes = readAll(reader);
+
+        report("XmlReader(entities)", data, nodes, clock.stop());
+    }
+
+    // text, which needs escaping, written with XmlWriter
+    void benchWriter(unsigned megabytes)
+    {
+        cxxtools::String text(L"Caf\u00e9 & cr\u00e8me br\u00fbl\u00e9e \u2013 5\u00a0\u20ac <b>bold</b> "
+                              L"\u00a9 \"quoted\" \u00e4\u00f6\u00fc\u00df and some plain text as well");
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::ostringstream out;
+        cxxtools::xml::XmlWriter writer(out, 0);
+        writer.writeStartElement(L"body");
+        unsigned long nodes = 0;
+        while (out.tellp() < static_cast<std::streamoff>(megabytes) * 1024 * 1024)
+        {
+            for (unsigned n = 0; n < 1000; ++n)
+                writer.writeElement(L"p", text);
+            writer.flush();
+            nodes += 1000;
+        }
+        writer.writeEndElement();
+        writer.flush();
+
+        report("XmlWriter(entities)", out.str(), nodes, clock.stop());
+    }
+
+    // objects written with XmlSerializer
+    void benchSerializer(unsigned megabytes)
+    {
+        cxxtools::SerializationInfo si;
+        si.setCategory(cxxtools::SerializationInfo::Array);
+        for (unsigned n = 0; n < 1000; ++n)
+        {
+            cxxtools::SerializationInfo& record = si.addMember("record");
+            record.setCategory(cxxtools::SerializationInfo::Object);
+            record.addMember("id") <<= n;
+            record.addMember("name") <<= "Name & Partner";
+            record.addMember("value") <<= n * 0.25;
+            record.addMember("active") <<= (n % 2 == 0);
+        }
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::ostringstream out;
+        unsigned long nodes = 0;
+        while (out.tellp() < static_cast<std::streamoff>(megabytes) * 1024 * 1024)
+        {
+            cxxtools::xml::XmlSerializer serializer(out);
+            serializer.serialize(si, "records");
+            nodes += 1 + 1000 * 5;
+        }
+
+        report("XmlSerializer", out.str(), nodes, clock.stop());
+    }
+
+    // complete document into a SerializationInfo
+    void benchDeserializer(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        cxxtools::xml::XmlDeserializer deserializer(in, true);
+
+        report("XmlDeserializer", data, deserializer.si().memberCount(), clock.stop());
+    }
+
+    // one record at a time
+    void benchParseNext(const std::string& data)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::istringstream in(data);
+        cxxtools::xml::XmlReader reader(in);
+        cxxtools::xml::XmlDeserializer deserializer(true);
+
+        unsigned long records = 0;
+        while (deserializer.parseNext(reader, L"/records/record"))
+            ++records;
+
+        report("XmlDeserializer::parseNext", data, records, clock.stop());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> megabytes(argc, argv, 'm', 50);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -m number  size of the document in MB (default: 50)\n";
+            return -1;
+        }
+
+        std::string data = generate(megabytes);
+
+        benchBytes(data);
+        benchText(data);
+        benchDeserializer(data);
+        benchParseNext(data);
+
+        std::string xhtml = generateXhtml(megabytes);
+        benchEntities(xhtml);
+        benchWriter(megabytes);
+        benchSerializer(megabytes);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
@@ -30,6 +30,8 @@
 #include "cxxtools/unit/registertest.h"
 #include "cxxtools/xml/xmldeserializer.h"
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 namespace
 {
@@ -66,6 +68,18 @@ namespace
             && obj1.boolValue == obj2.boolValue;
     }
 
+    struct Collector
+    {
+        std::vector<TestObject>* objects;
+
+        explicit Collector(std::vector<TestObject>& objects_)
+            : objects(&objects_)
+        { }
+
+        void operator() (const TestObject& obj)
+        { objects->push_back(obj); }
+    };
+
 }
 
 class XmlDeserializerTest : public cxxtools::unit::TestSuite
@@ -76,6 +90,8 @@ class XmlDeserializerTest : public cxxtools::unit::TestSuite
         {
             registerMethod("testObjectWithAttributes", *this, &XmlDeserializerTest::testObjectWithAttributes);
             registerMethod("testManyObjectsWithAttributes", *this, &XmlDeserializerTest::testManyObjectsWithAttributes);
+            registerMethod("testParseNext", *this, &XmlDeserializerTest::testParseNext);
+            registerMethod("testForEach", *this, &XmlDeserializerTest::testForEach);
         }
 
         void testObjectWithAttributes()
@@ -121,6 +137,67 @@ class XmlDeserializerTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_EQUALS(t[1].boolValue, false);
         }
 
+        void testParseNext()
+        {
+            std::istringstream data(
+                "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                "<!-- records -->\n"
+                "<root>\n"
+                " <object><intValue>1</intValue><stringValue>a</stringValue><doubleValue>1.5</doubleValue><boolValue>true</boolValue></object>\n"
+                " <other><object><intValue>99</intValue></object></other>\n"
+                " <object><intValue>2</intValue><stringValue/><doubleValue>2.5</doubleValue><boolValue>false</boolValue></object>\n"
+                " <object intValue=\"3\" stringValue=\"c\" doubleValue=\"3.5\" boolValue=\"true\"/>\n"
+                "</root>");
+
+            cxxtools::xml::XmlReader reader(data);
+            cxxtools::xml::XmlDeserializer d(true);
+            TestObject t;
+
+            CXXTOOLS_UNIT_ASSERT(d.parseNext(reader, L"/root/object"));
+            d.deserialize(t);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.intValue, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.stringValue, "a");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.doubleValue, 1.5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.boolValue, true);
+
+            CXXTOOLS_UNIT_ASSERT(d.parseNext(reader, L"/root/object"));
+            d.deserialize(t);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.intValue, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.stringValue, "");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.doubleValue, 2.5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.boolValue, false);
+
+            CXXTOOLS_UNIT_ASSERT(d.parseNext(reader, L"root/object"));
+            d.deserialize(t);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.intValue, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.stringValue, "c");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.doubleValue, 3.5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(t.boolValue, true);
+
+            CXXTOOLS_UNIT_ASSERT(!d.parseNext(reader, L"/root/object"));
+            CXXTOOLS_UNIT_ASSERT(!d.parseNext(reader, L"/root/object"));
+
+            CXXTOOLS_UNIT_ASSERT_THROW(d.parseNext(reader, L"/"), std::invalid_argument);
+        }
+
+        void testForEach()
+        {
+            std::ostringstream xml;
+            xml << "<root><header>h</header><objects>";
+            for (unsigned n = 0; n < 1000; ++n)
+                xml << "<object><intValue>" << n << "</intValue><stringValue>s</stringValue>"
+                       "<doubleValue>0</doubleValue><boolValue>false</boolValue></object>";
+            xml << "</objects></root>";
+
+            std::istringstream data(xml.str());
+            std::vector<TestObject> objects;
+            cxxtools::xml::XmlDeserializer::forEach<TestObject>(data, L"/root/objects/object", Collector(objects));
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(objects.size(), 1000);
+            for (unsigned n = 0; n < objects.size(); ++n)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(objects[n].intValue, static_cast<int>(n));
+        }
+
 };
 
 cxxtools::unit::RegisterTest<XmlDeserializerTest> register_XmlDeserializerTest;
@@ -27,12 +27,102 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include "cxxtools/xml/xmlreader.h"
 #include "cxxtools/xml/startelement.h"
+#include "cxxtools/xml/endelement.h"
+#include "cxxtools/xml/characters.h"
 #include "cxxtools/xml/entityresolver.h"
+#include "cxxtools/xml/xmlerror.h"
+#include "cxxtools/textstream.h"
+#include "cxxtools/utf8codec.h"
+#include "cxxtools/conversionerror.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
 
+namespace
+{
+    // delivers the input one byte at a time
+    class ByteBuffer : public std::streambuf
+    {
+            std::string _data;
+            std::string::size_type _pos;
+            char _ch;
+
+        public:
+            explicit ByteBuffer(const std::string& data)
+                : _data(data),
+                  _pos(0)
+            { }
+
+        protected:
+            int_type underflow()
+            {
+                if (_pos >= _data.size())
+                    return traits_type::eof();
+
+                _ch = _data[_pos++];
+                setg(&_ch, &_ch, &_ch + 1);
+                return traits_type::to_int_type(_ch);
+            }
+    };
+
+    std::string dump(cxxtools::xml::XmlReader& reader)
+    {
+        std::ostringstream out;
+        while (true)
+        {
+            const cxxtools::xml::Node& node = reader.next();
+            switch (node.type())
+            {
+                case cxxtools::xml::Node::StartElement:
+                {
+                    const cxxtools::xml::StartElement& se = static_cast<const cxxtools::xml::StartElement&>(node);
+                    out << '<' << cxxtools::Utf8Codec::encode(se.name());
+                    for (cxxtools::xml::Attributes::const_iterator it = se.attributes().begin(); it != se.attributes().end(); ++it)
+                        out << ' ' << cxxtools::Utf8Codec::encode(it->name())
+                            << "='" << cxxtools::Utf8Codec::encode(it->value()) << '\'';
+                    out << '>';
+                    break;
+                }
+
+                case cxxtools::xml::Node::EndElement:
+                    out << "</" << cxxtools::Utf8Codec::encode(static_cast<const cxxtools::xml::EndElement&>(node).name()) << '>';
+                    break;
+
+                case cxxtools::xml::Node::Characters:
+                    out << '[' << cxxtools::Utf8Codec::encode(static_cast<const cxxtools::xml::Characters&>(node).content()) << ']';
+                    break;
+
+                case cxxtools::xml::Node::EndDocument:
+                    return out.str();
+
+                default:
+                    out << '#' << node.type();
+            }
+        }
+    }
+
+    std::string dumpText(const std::string& xml)
+    {
+        std::istringstream in(xml);
+        cxxtools::TextIStream ts(in, new cxxtools::Utf8Codec());
+        cxxtools::xml::XmlReader reader(ts);
+        return dump(reader);
+    }
+
+    const char* testDocument =
+        "\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!-- comment -->\n"
+        "<root a=\"1\" b = 'x &amp; y' c=\"&#x41;&lt;\">\n"
+        "  <item id=\"1\">Gr\xc3\xbc\xc3\x9f" "e &amp; &#8364;</item>\n"
+        "  <empty/><empty2 x=\"y\" /><ns:item ns:a=\"v\">t</ns:item >\n"
+        "  <data><![CDATA[<not> & parsed]]></data>\n"
+        "  <?pi some data?>\n"
+        "  <long>" "0123456789012345678901234567890123456789012345678901234567890123456789" "</long>\n"
+        "</root>\n";
+}
+
 class XmlReaderTest : public cxxtools::unit::TestSuite
 {
     public:
@@ -46,7 +136,18 @@ class XmlReaderTest : public cxxtools::unit::TestSuite
             registerMethod("XmlReadAttributesFromEmptyXml", *this, &XmlReaderTest::XmlReadAttributesFromEmptyXml);
             registerMethod("XmlEntity", *this, &XmlReaderTest::XmlEntity);
             registerMethod("ReverseEntity", *this, &XmlReaderTest::ReverseEntity);
+            registerMethod("NamedEntities", *this, &XmlReaderTest::NamedEntities);
+            registerMethod("GetEntities", *this, &XmlReaderTest::GetEntities);
             registerMethod("AllEntities", *this, &XmlReaderTest::AllEntities);
+            registerMethod("EveryNamedEntity", *this, &XmlReaderTest::EveryNamedEntity);
+            registerMethod("ByteInput", *this, &XmlReaderTest::ByteInput);
+            registerMethod("ByteBoundaries", *this, &XmlReaderTest::ByteBoundaries);
+            registerMethod("Utf8Characters", *this, &XmlReaderTest::Utf8Characters);
+            registerMethod("AttributeReuse", *this, &XmlReaderTest::AttributeReuse);
+            registerMethod("NameIds", *this, &XmlReaderTest::NameIds);
+            registerMethod("Reset", *this, &XmlReaderTest::Reset);
+            registerMethod("LineNumber", *this, &XmlReaderTest::LineNumber);
+            registerMethod("InvalidUtf8", *this, &XmlReaderTest::InvalidUtf8);
         }
 
         void setUp()
@@ -175,6 +276,51 @@ class XmlReaderTest : public cxxtools::unit::TestSuite
 
         }
 
+        void NamedEntities()
+        {
+            cxxtools::xml::EntityResolver resolver;
+
+            // first, last and a few in between of the table
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"AElig")) == cxxtools::String(1, cxxtools::Char(0xC6)));
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"zwnj")) == cxxtools::String(1, cxxtools::Char(0x200C)));
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"euro")) == cxxtools::String(1, cxxtools::Char(0x20AC)));
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"nbsp")) == cxxtools::String(1, cxxtools::Char(0xA0)));
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"Zeta")) == cxxtools::String(1, cxxtools::Char(0x396)));
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"zeta")) == cxxtools::String(1, cxxtools::Char(0x3B6)));
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"amp")) == cxxtools::String(L"&"));
+
+            // names must match exactly
+            CXXTOOLS_UNIT_ASSERT_THROW(resolver.resolveEntity(cxxtools::String(L"AUML")), std::exception);
+            CXXTOOLS_UNIT_ASSERT_THROW(resolver.resolveEntity(cxxtools::String(L"amp ")), std::exception);
+            CXXTOOLS_UNIT_ASSERT_THROW(resolver.resolveEntity(cxxtools::String(L"")), std::exception);
+
+            // user defined entities are found after the builtin ones
+            resolver.addEntity(L"xauml", L"x\u00e4");
+            CXXTOOLS_UNIT_ASSERT(resolver.resolveEntity(cxxtools::String(L"xauml")) == cxxtools::String(L"x\u00e4"));
+        }
+
+        void GetEntities()
+        {
+            cxxtools::xml::EntityResolver resolver;
+
+            cxxtools::String text;
+            for (cxxtools::Char::value_type n = 1; n < 0x300; ++n)
+                text += cxxtools::Char(n);
+            text += L"plain text at the end";
+
+            std::basic_ostringstream<cxxtools::Char> expected;
+            for (cxxtools::String::const_iterator it = text.begin(); it != text.end(); ++it)
+                expected << resolver.getEntity(*it);
+
+            std::basic_ostringstream<cxxtools::Char> out;
+            resolver.getEntities(out, text);
+            CXXTOOLS_UNIT_ASSERT(out.str() == expected.str());
+
+            std::basic_ostringstream<cxxtools::Char> out2;
+            resolver.getEntities(out2, cxxtools::String(L"a<b & \"c\"\u00e4"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::String(out2.str()).narrow(), "a&lt;b &amp; &quot;c&quot;&#228;");
+        }
+
         void ReverseEntity()
         {
             cxxtools::xml::EntityResolver resolver;
@@ -216,6 +362,256 @@ class XmlReaderTest : public cxxtools::unit::TestSuite
             }
         }
 
+        void EveryNamedEntity()
+        {
+            // all entries of the entity table of the resolver
+            static const struct
+            {
+                const char* name;
+                cxxtools::Char::value_type value;
+            } entities[] = {
+                { "AElig", 0x00C6 }, { "Acirc", 0x00C2 }, { "Agrave", 0x00C0 }, { "Alpha", 0x0391 },
+                { "Aring", 0x00C5 }, { "Atilde", 0x00C3 }, { "Auml", 0x00C4 }, { "Beta", 0x0392 },
+                { "Ccedil", 0x00C7 }, { "Chi", 0x03A7 }, { "Dagger", 0x2021 }, { "Delta", 0x0394 },
+                { "ETH", 0x00D0 }, { "Eacute", 0x00C9 }, { "Ecirc", 0x00CA }, { "Egrave", 0x00C8 },
+                { "Epsilon", 0x0395 }, { "Eta", 0x0397 }, { "Euml", 0x00CB }, { "Gamma", 0x0393 },
+                { "Iacute", 0x00CD }, { "Icirc", 0x00CE }, { "Igrave", 0x00CC }, { "Iota", 0x0399 },
+                { "Iuml", 0x00CF }, { "Kappa", 0x039A }, { "Lambda", 0x039B }, { "Mu", 0x039C },
+                { "Ntilde", 0x00D1 }, { "Nu", 0x039D }, { "OElig", 0x0152 }, { "Oacute", 0x00D3 },
+                { "Ocirc", 0x00D4 }, { "Ograve", 0x00D2 }, { "Omega", 0x03A9 }, { "Omicron", 0x039F },
+                { "Oslash", 0x00D8 }, { "Otilde", 0x00D5 }, { "Ouml", 0x00D6 }, { "Phi", 0x03A6 },
+                { "Pi", 0x03A0 }, { "Prime", 0x2033 }, { "Psi", 0x03A8 }, { "Rho", 0x03A1 },
+                { "Scaron", 0x0160 }, { "Sigma", 0x03A3 }, { "THORN", 0x00DE }, { "Tau", 0x03A4 },
+                { "Theta", 0x0398 }, { "Uacute", 0x00DA }, { "Ucirc", 0x00DB }, { "Ugrave", 0x00D9 },
+                { "Upsilon", 0x03A5 }, { "Uuml", 0x00DC }, { "Xi", 0x039E }, { "Yacute", 0x00DD },
+                { "Yuml", 0x0178 }, { "Zeta", 0x0396 }, { "acirc", 0x00E2 }, { "acute", 0x00B4 },
+                { "aelig", 0x00E6 }, { "agrave", 0x00E0 }, { "alefsym", 0x2135 }, { "alpha", 0x03B1 },
+                { "amp", 0x0026 }, { "and", 0x2227 }, { "ang", 0x2220 }, { "apos", 0x0027 },
+                { "aring", 0x00E5 }, { "asymp", 0x2248 }, { "atilde", 0x00E3 }, { "auml", 0x00E4 },
+                { "bdquo", 0x201E }, { "beta", 0x03B2 }, { "brvbar", 0x00A6 }, { "bull", 0x2022 },
+                { "cap", 0x2229 }, { "ccedil", 0x00E7 }, { "cedil", 0x00B8 }, { "cent", 0x00A2 },
+                { "chi", 0x03C7 }, { "circ", 0x02C6 }, { "clubs", 0x2663 }, { "cong", 0x2245 },
+                { "copy", 0x00A9 }, { "crarr", 0x21B5 }, { "cup", 0x222A }, { "curren", 0x00A4 },
+                { "dArr", 0x21D3 }, { "dagger", 0x2020 }, { "darr", 0x2193 }, { "deg", 0x00B0 },
+                { "delta", 0x03B4 }, { "diams", 0x2666 }, { "divide", 0x00F7 }, { "eacute", 0x00E9 },
+                { "ecirc", 0x00EA }, { "egrave", 0x00E8 }, { "empty", 0x2205 }, { "emsp", 0x2003 },
+                { "ensp", 0x2002 }, { "epsilon", 0x03B5 }, { "equiv", 0x2261 }, { "eta", 0x03B7 },
+                { "eth", 0x00F0 }, { "euml", 0x00EB }, { "euro", 0x20AC }, { "exist", 0x2203 },
+                { "fnof", 0x0192 }, { "forall", 0x2200 }, { "frac12", 0x00BD }, { "frac14", 0x00BC },
+                { "frac34", 0x00BE }, { "frasl", 0x2044 }, { "gamma", 0x03B3 }, { "ge", 0x2265 },
+                { "gt", 0x003E }, { "hArr", 0x21D4 }, { "harr", 0x2194 }, { "hearts", 0x2665 },
+                { "hellip", 0x2026 }, { "iacute", 0x00ED }, { "icirc", 0x00EE }, { "iexcl", 0x00A1 },
+                { "igrave", 0x00EC }, { "image", 0x2111 }, { "infin", 0x221E }, { "int", 0x222B },
+                { "iota", 0x03B9 }, { "iquest", 0x00BF }, { "isin", 0x2208 }, { "iuml", 0x00EF },
+                { "kappa", 0x03BA }, { "lArr", 0x21D0 }, { "lambda", 0x03BB }, { "lang", 0x2329 },
+                { "laquo", 0x00AB }, { "larr", 0x2190 }, { "lceil", 0x2308 }, { "ldquo", 0x201C },
+                { "le", 0x2264 }, { "lfloor", 0x230A }, { "lowast", 0x2217 }, { "loz", 0x25CA },
+                { "lrm", 0x200E }, { "lsaquo", 0x2039 }, { "lsquo", 0x2018 }, { "lt", 0x003C },
+                { "macr", 0x00AF }, { "mdash", 0x2014 }, { "micro", 0x00B5 }, { "middot", 0x00B7 },
+                { "minus", 0x2212 }, { "mu", 0x03BC }, { "nabla", 0x2207 }, { "nbsp", 0x00A0 },
+                { "ndash", 0x2013 }, { "ne", 0x2260 }, { "ni", 0x220B }, { "not", 0x00AC },
+                { "notin", 0x2209 }, { "nsub", 0x2284 }, { "ntilde", 0x00F1 }, { "nu", 0x03BD },
+                { "oacute", 0x00F3 }, { "ocirc", 0x00F4 }, { "oelig", 0x0153 }, { "ograve", 0x00F2 },
+                { "oline", 0x203E }, { "omega", 0x03C9 }, { "omicron", 0x03BF }, { "oplus", 0x2295 },
+                { "or", 0x2228 }, { "ordf", 0x00AA }, { "ordm", 0x00BA }, { "oslash", 0x00F8 },
+                { "otilde", 0x00F5 }, { "otimes", 0x2297 }, { "ouml", 0x00F6 }, { "para", 0x00B6 },
+                { "part", 0x2202 }, { "permil", 0x2030 }, { "perp", 0x22A5 }, { "phi", 0x03C6 },
+                { "pi", 0x03C0 }, { "piv", 0x03D6 }, { "plusmn", 0x00B1 }, { "pound", 0x00A3 },
+                { "prime", 0x2032 }, { "prod", 0x220F }, { "prop", 0x221D }, { "psi", 0x03C8 },
+                { "quot", 0x0022 }, { "rArr", 0x21D2 }, { "radic", 0x221A }, { "rang", 0x232A },
+                { "raquo", 0x00BB }, { "rarr", 0x2192 }, { "rceil", 0x2309 }, { "rdquo", 0x201D },
+                { "real", 0x211C }, { "reg", 0x00AE }, { "rfloor", 0x230B }, { "rho", 0x03C1 },
+                { "rlm", 0x200F }, { "rsaquo", 0x203A }, { "rsquo", 0x2019 }, { "sbquo", 0x201A },
+                { "scaron", 0x0161 }, { "sdot", 0x22C5 }, { "sect", 0x00A7 }, { "shy", 0x00AD },
+                { "sigma", 0x03C3 }, { "sigmaf", 0x03C2 }, { "sim", 0x223C }, { "spades", 0x2660 },
+                { "sub", 0x2282 }, { "sube", 0x2286 }, { "sum", 0x2211 }, { "sup", 0x2283 },
+                { "sup1", 0x00B9 }, { "sup2", 0x00B2 }, { "sup3", 0x00B3 }, { "supe", 0x2287 },
+                { "szlig", 0x00DF }, { "tau", 0x03C4 }, { "there4", 0x2234 }, { "theta", 0x03B8 },
+                { "thetasym", 0x03D1 }, { "thinsp", 0x2009 }, { "thorn", 0x00FE }, { "tilde", 0x02DC },
+                { "times", 0x00D7 }, { "trade", 0x2122 }, { "uArr", 0x21D1 }, { "uacute", 0x00FA },
+                { "uarr", 0x2191 }, { "ucirc", 0x00FB }, { "ugrave", 0x00F9 }, { "uml", 0x00A8 },
+                { "upsih", 0x03D2 }, { "upsilon", 0x03C5 }, { "uuml", 0x00FC }, { "weierp", 0x2118 },
+                { "xi", 0x03BE }, { "yacute", 0x00FD }, { "yen", 0x00A5 }, { "yuml", 0x00FF },
+                { "zeta", 0x03B6 }, { "zwj", 0x200D }, { "zwnj", 0x200C }
+            };
+
+            cxxtools::xml::EntityResolver resolver;
+            for (unsigned n = 0; n < sizeof(entities) / sizeof(entities[0]); ++n)
+            {
+                cxxtools::Char ch(entities[n].value);
+
+                cxxtools::String r = resolver.resolveEntity(cxxtools::String(entities[n].name));
+                CXXTOOLS_UNIT_ASSERT_MSG(r == cxxtools::String(1, ch),
+                    "resolving entity \"" << entities[n].name << "\" failed");
+
+                // the escaped character must resolve to the same character
+                cxxtools::String e = resolver.getEntity(ch);
+                if (e.size() > 2 && e[0] == '&')
+                    e = resolver.resolveEntity(e.substr(1, e.size() - 2));
+                CXXTOOLS_UNIT_ASSERT_MSG(e == cxxtools::String(1, ch),
+                    "escaping entity \"" << entities[n].name << "\" failed");
+
+                std::basic_ostringstream<cxxtools::Char> out;
+                resolver.getEntities(out, cxxtools::String(1, ch));
+                std::string bytes;
+                resolver.getEntities(bytes, cxxtools::String(1, ch));
+                CXXTOOLS_UNIT_ASSERT(out.str() == resolver.getEntity(ch));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(bytes, resolver.getEntity(ch).narrow());
+            }
+        }
+
+        void ByteInput()
+        {
+            // utf-8 input is parsed on byte level; the result must not differ
+            // from reading decoded characters
+            std::istringstream in(testDocument);
+            cxxtools::xml::XmlReader reader(in);
+            std::string result = dump(reader);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result, dumpText(testDocument));
+            CXXTOOLS_UNIT_ASSERT(result.find("<root a='1' b='x & y' c='A<'>") != std::string::npos);
+            CXXTOOLS_UNIT_ASSERT(result.find("[Gr\xc3\xbc\xc3\x9f" "e & \xe2\x82\xac]") != std::string::npos);
+            CXXTOOLS_UNIT_ASSERT(result.find("[<not> & parsed]") != std::string::npos);
+        }
+
+        void ByteBoundaries()
+        {
+            // every token and every multi byte character is split between reads
+            ByteBuffer buffer(testDocument);
+            std::istream in(&buffer);
+            cxxtools::xml::XmlReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(dump(reader), dumpText(testDocument));
+        }
+
+        void Utf8Characters()
+        {
+            const std::string xml =
+                "<a x=\"\xe2\x82\xac\xf0\x9f\x98\x80\"><\xc3\xa4\xe2\x82\xac>\xe2\x82\xac \xf0\x9f\x98\x80</\xc3\xa4\xe2\x82\xac></a>";
+            const std::string expected =
+                "<a x='\xe2\x82\xac\xf0\x9f\x98\x80'><\xc3\xa4\xe2\x82\xac>[\xe2\x82\xac \xf0\x9f\x98\x80]</\xc3\xa4\xe2\x82\xac></a>";
+
+            std::istringstream in(xml);
+            cxxtools::xml::XmlReader reader(in);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(dump(reader), expected);
+
+            ByteBuffer buffer(xml);
+            std::istream bin(&buffer);
+            cxxtools::xml::XmlReader breader(bin);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(dump(breader), expected);
+        }
+
+        void AttributeReuse()
+        {
+            std::istringstream in(
+                "<root><a x=\"1\" y=\"2\" z=\"3\"/><b x=\"4\"/><c/><d y=\"5\" z=\"6\"/></root>");
+            cxxtools::xml::XmlReader reader(in);
+
+            reader.nextElement();
+
+            const cxxtools::xml::StartElement& a = reader.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a.attributes().size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a.attribute(L"z").narrow(), "3");
+
+            const cxxtools::xml::StartElement& b = reader.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b.attributes().size(), 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b.attribute(L"x").narrow(), "4");
+
+            const cxxtools::xml::StartElement& c = reader.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.attributes().size(), 0);
+
+            const cxxtools::xml::StartElement& d = reader.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(d.attributes().size(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(d.attribute(L"y").narrow(), "5");
+            CXXTOOLS_UNIT_ASSERT(!d.hasAttribute(L"x"));
+        }
+
+        void NameIds()
+        {
+            std::istringstream in(
+                "<root><a x=\"1\">t</a><b x=\"2\" y=\"3\"/><a y=\"4\"></a></root>");
+            cxxtools::xml::XmlReader reader(in);
+
+            const cxxtools::xml::StartElement& root = reader.nextElement();
+            unsigned rootId = root.nameId();
+            CXXTOOLS_UNIT_ASSERT(rootId != 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.nameId(L"root"), rootId);
+
+            const cxxtools::xml::StartElement& a = reader.nextElement();
+            unsigned aId = a.nameId();
+            unsigned xId = a.attributes()[0].nameId();
+            CXXTOOLS_UNIT_ASSERT(aId != rootId);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.nameId(L"x"), xId);
+
+            const cxxtools::xml::Node& end = reader.nextTag();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(end.type(), cxxtools::xml::Node::EndElement);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::EndElement&>(end).nameId(), aId);
+
+            const cxxtools::xml::StartElement& b = reader.nextElement();
+            CXXTOOLS_UNIT_ASSERT(b.nameId() != aId);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b.attributes()[0].nameId(), xId);
+            unsigned yId = b.attributes()[1].nameId();
+            CXXTOOLS_UNIT_ASSERT(yId != xId);
+
+            const cxxtools::xml::Node& emptyEnd = reader.nextTag();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::EndElement&>(emptyEnd).nameId(), b.nameId());
+
+            const cxxtools::xml::StartElement& a2 = reader.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a2.nameId(), aId);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a2.attributes()[0].nameId(), yId);
+
+            cxxtools::xml::StartElement se(L"a");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(se.nameId(), 0u);
+        }
+
+        void Reset()
+        {
+            // a reader without input is attached to a stream later
+            cxxtools::xml::XmlReader reader;
+            unsigned valueId = reader.nameId(L"value");
+
+            std::istringstream in("<value>\xc3\xa4</value>");
+            reader.reset(in);
+
+            const cxxtools::xml::StartElement& se = reader.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(se.nameId(), valueId);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next().type(), cxxtools::xml::Node::Characters);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::Characters&>(reader.get()).content(), cxxtools::String(L"\u00e4"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next().type(), cxxtools::xml::Node::EndElement);
+        }
+
+        void LineNumber()
+        {
+            std::istringstream in(
+                "<root>\n"
+                "  <a x=\"1\n2\">text\n"
+                "more</a>\n"
+                "  <b =\"1\"/>\n"
+                "</root>\n");
+            cxxtools::xml::XmlReader reader(in);
+
+            try
+            {
+                while (reader.next().type() != cxxtools::xml::Node::EndDocument)
+                    ;
+                CXXTOOLS_UNIT_FAIL("XmlError expected");
+            }
+            catch (const cxxtools::xml::XmlError& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.line(), 5u);
+            }
+        }
+
+        void InvalidUtf8()
+        {
+            std::istringstream in("<root>abc\xc3(</root>");
+            cxxtools::xml::XmlReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT_THROW(
+                while (reader.next().type() != cxxtools::xml::Node::EndDocument)
+                    ;, cxxtools::ConversionError);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<XmlReaderTest> register_XmlReaderTest;
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/xmlrpc/formatter.h>
+#include <cxxtools/xmlrpc/scanner.h>
+#include <cxxtools/xml/xmlreader.h>
+#include <cxxtools/xml/startelement.h>
+#include <cxxtools/xml/xmlwriter.h>
+#include <cxxtools/serializationinfo.h>
+#include <cxxtools/deserializer.h>
+#include <cxxtools/composer.h>
+#include <cxxtools/decomposer.h>
+#include <cxxtools/textstream.h>
+#include <cxxtools/utf8codec.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    struct Record
+    {
+        int id;
+        std::string name;
+        double value;
+        bool flag;
+    };
+
+    void operator<<= (cxxtools::SerializationInfo& si, const Record& r)
+    {
+        si.addMember("id") <<= r.id;
+        si.addMember("name") <<= r.name;
+        si.addMember("value") <<= r.value;
+        si.addMember("flag") <<= r.flag;
+    }
+
+    void operator>>= (const cxxtools::SerializationInfo& si, Record& r)
+    {
+        si.getMember("id") >>= r.id;
+        si.getMember("name") >>= r.name;
+        si.getMember("value") >>= r.value;
+        si.getMember("flag") >>= r.flag;
+    }
+
+    void report(const char* what, std::size_t bytes, unsigned long values, const cxxtools::Timespan& t)
+    {
+        double secs = t.totalMSecs() / 1000.0;
+        std::cout << what << '\t' << values << " values in " << secs << " s => "
+                  << (bytes / secs / 1e6) << " MB/s, "
+                  << static_cast<unsigned long>(values / secs) << " values/s" << std::endl;
+    }
+
+    // a methodResponse with the records as in the xmlrpc server
+    void formatResponse(cxxtools::xml::XmlWriter& writer, cxxtools::xmlrpc::Formatter& formatter,
+        cxxtools::IDecomposer& decomposer, std::ostream& out)
+    {
+        writer.begin(out);
+        writer.writeStartElement("methodResponse");
+        writer.writeStartElement("params");
+        writer.writeStartElement("param");
+        decomposer.format(formatter);
+        writer.writeEndElement();
+        writer.writeEndElement();
+        writer.writeEndElement();
+        writer.flush();
+    }
+
+    void benchFormatter(const std::vector<Record>& records, unsigned count)
+    {
+        cxxtools::xml::XmlWriter writer;
+        writer.useIndent(false);
+        writer.useEndl(false);
+
+        cxxtools::xmlrpc::Formatter formatter(writer);
+        formatter.addAlias("bool", "boolean");
+
+        cxxtools::Decomposer<std::vector<Record> > decomposer;
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::size_t bytes = 0;
+        for (unsigned n = 0; n < count; ++n)
+        {
+            std::ostringstream out;
+            decomposer.begin(records);
+            formatResponse(writer, formatter, decomposer, out);
+            bytes += out.str().size();
+        }
+
+        report("xmlrpc::Formatter", bytes, count * records.size() * 4, clock.stop());
+    }
+
+    // parses the response as the xmlrpc client does
+    template <typename Stream>
+    std::size_t scan(cxxtools::xml::XmlReader& reader, Stream& in, std::vector<Record>& records)
+    {
+        cxxtools::Deserializer deserializer;
+        cxxtools::xmlrpc::Scanner scanner;
+        cxxtools::Composer<std::vector<Record> > composer;
+
+        composer.begin(records);
+        reader.reset(in);
+        scanner.begin(deserializer, composer, reader);
+
+        while (reader.get().type() != cxxtools::xml::Node::EndDocument)
+        {
+            const cxxtools::xml::Node& node = reader.get();
+            if (node.type() == cxxtools::xml::Node::StartElement
+                && static_cast<const cxxtools::xml::StartElement&>(node).name() == L"param")
+                break;
+            reader.next();
+        }
+
+        while (reader.next().type() != cxxtools::xml::Node::EndDocument)
+        {
+            if (scanner.advance(reader.get()))
+                break;
+        }
+
+        return records.size();
+    }
+
+    void benchScanner(const std::string& data, unsigned count)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::size_t values = 0;
+        std::vector<Record> records;
+        std::istringstream in;
+        cxxtools::xml::XmlReader reader(in);
+        for (unsigned n = 0; n < count; ++n)
+        {
+            in.str(data);
+            in.clear();
+            values += scan(reader, in, records) * 4;
+        }
+
+        report("xmlrpc::Scanner", data.size() * count, values, clock.stop());
+    }
+
+    void benchScannerText(const std::string& data, unsigned count)
+    {
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::size_t values = 0;
+        std::vector<Record> records;
+        std::istringstream in;
+        cxxtools::TextIStream ts(new cxxtools::Utf8Codec());
+        cxxtools::xml::XmlReader reader(ts);
+        for (unsigned n = 0; n < count; ++n)
+        {
+            in.str(data);
+            in.clear();
+            ts.attach(in);
+            values += scan(reader, ts, records) * 4;
+        }
+
+        report("xmlrpc::Scanner(text)", data.size() * count, values, clock.stop());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> size(argc, argv, 's', 10000);
+        cxxtools::Arg<unsigned> count(argc, argv, 'n', 50);
+
+        if (argc > 1)
+        {
+            std::cerr << "usage: " << argv[0] << " [options]\n"
+                         "options:\n"
+                         "   -s number  number of records in a response (default: 10000)\n"
+                         "   -n number  number of responses (default: 50)\n";
+            return -1;
+        }
+
+        std::vector<Record> records(size);
+        for (unsigned n = 0; n < records.size(); ++n)
+        {
+            records[n].id = n;
+            records[n].name = n % 10 == 0 ? "M\xc3\xbcller & Partner" : "Name";
+            records[n].value = n * 0.25;
+            records[n].flag = n % 2 == 0;
+        }
+
+        benchFormatter(records, count);
+
+        cxxtools::xml::XmlWriter writer;
+        writer.useIndent(false);
+        writer.useEndl(false);
+        cxxtools::xmlrpc::Formatter formatter(writer);
+        formatter.addAlias("bool", "boolean");
+        cxxtools::Decomposer<std::vector<Record> > decomposer;
+        decomposer.begin(records);
+        std::ostringstream out;
+        formatResponse(writer, formatter, decomposer, out);
+
+        benchScannerText(out.str(), count);
+        benchScanner(out.str(), count);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
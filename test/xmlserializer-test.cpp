@@ -120,6 +120,7 @@ class XmlSerializerTest : public cxxtools::unit::TestSuite
             registerMethod("testComplexObject", *this, &XmlSerializerTest::testComplexObject);
             registerMethod("testObjectVector", *this, &XmlSerializerTest::testObjectVector);
             registerMethod("testBinaryData", *this, &XmlSerializerTest::testBinaryData);
+            registerMethod("testWriter", *this, &XmlSerializerTest::testWriter);
         }
 
         void testScalar()
@@ -360,6 +361,43 @@ class XmlSerializerTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT(v == v2);
 
         }
+
+        void testWriter()
+        {
+            std::ostringstream out;
+
+            {
+                cxxtools::xml::XmlWriter writer(out, cxxtools::xml::XmlWriter::UseIndent | cxxtools::xml::XmlWriter::UseEndl);
+                cxxtools::xml::Attribute attr(L"a", L"x\"y");
+
+                writer.writeStartElement("root");
+                writer.writeElement(L"item", &attr, 1, L"<\u00e4>");
+                writer.writeStartElement(L"root");
+                writer.writeElement("item", L"2");
+                writer.writeEndElement();
+                writer.writeEndElement();
+                writer.writeEndElement();  // ignored
+                // output is written, when the writer is destroyed
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "<root>\n"
+                "  <item\n"
+                "    a=\"x&quot;y\">&lt;&#228;&gt;</item>\n"
+                "  <root>\n"
+                "    <item>2</item>\n"
+                "  </root>\n"
+                "</root>\n");
+
+            std::ostringstream out2;
+            cxxtools::xml::XmlWriter writer(out2, 0);
+            writer.writeElement("n", L"");
+            writer.writeElement(cxxtools::String(L"\u20ac"), L"");
+            writer.flush();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out2.str(), "<n></n><\xe2\x82\xac></\xe2\x82\xac>");
+
+            CXXTOOLS_UNIT_ASSERT_THROW(writer.writeStartElement(""), std::runtime_error);
+        }
 };
 
 cxxtools::unit::RegisterTest<XmlSerializerTest> register_XmlSerializerTest;
@@ -0,0 +1,133 @@
+#!/usr/bin/perl -w
+
+=head1 NAME
+
+entityhash.pl - generates the perfect hash tables of the xml entity resolver
+
+=head1 SYNOPSIS
+
+./utils/entityhash.pl src/xml/entityresolver.cpp
+
+=head1 DESCRIPTION
+
+Reads the entity names from the table ent[] in src/xml/entityresolver.cpp and
+searches the seeds of a perfect hash over them. The arrays entitySeed and
+entitySlot are printed to stdout and replace the arrays in the source, when
+ent[] is changed.
+
+The hash with seed 0 selects one of the buckets and the hash with the seed of
+that bucket selects a slot. The buckets are processed starting with the
+largest and for each the smallest seed is used, which places all of its names
+into free slots. A slot holds the index + 1 of the entity in ent[].
+
+The hash function is FNV-1a over the characters of the name, with the seed
+xored into the offset basis. It must match entityHash in the source.
+
+=head1 OPTIONS
+
+=over 2
+
+=item -b I<number>
+
+number of buckets (default: 64)
+
+=item -s I<number>
+
+number of slots (default: 512)
+
+=back
+
+=cut
+
+use strict;
+use Getopt::Std;
+
+my %opt;
+getopts('b:s:', \%opt);
+
+my $buckets = $opt{b} || 64;
+my $slots = $opt{s} || 512;
+my $file = shift @ARGV || 'src/xml/entityresolver.cpp';
+
+open(my $in, '<', $file) or die "cannot open $file: $!";
+my $src = do { local $/; <$in> };
+close $in;
+
+$src =~ /static const Ent ent\[\] = \{(.*?)\};/s
+    or die "table ent[] not found in $file";
+
+my @names = ($1 =~ /\{ L"(\w+)", 0x[0-9A-Fa-f]+ \}/g);
+
+my %seen;
+foreach my $name (@names)
+{
+    die "duplicate entity $name" if $seen{$name}++;
+}
+
+sub hash
+{
+    my ($name, $seed) = @_;
+
+    my $h = (2166136261 ^ $seed) & 0xffffffff;
+    foreach my $c (split //, $name)
+    {
+        $h ^= ord($c);
+        $h = ($h * 16777619) & 0xffffffff;
+    }
+
+    return $h;
+}
+
+my @bucket = map { [] } (1 .. $buckets);
+for (my $n = 0; $n < @names; ++$n)
+{
+    push @{$bucket[hash($names[$n], 0) % $buckets]}, $n;
+}
+
+my @order = sort { @{$bucket[$b]} <=> @{$bucket[$a]} || $a <=> $b } (0 .. $buckets - 1);
+
+my @slot = (0) x $slots;
+my @seed = (0) x $buckets;
+
+BUCKET: foreach my $b (@order)
+{
+    my @entries = @{$bucket[$b]};
+    next unless @entries;
+
+    SEED: for (my $seed = 1; $seed < 256; ++$seed)
+    {
+        my %used;
+        foreach my $n (@entries)
+        {
+            my $s = hash($names[$n], $seed) % $slots;
+            next SEED if $slot[$s] || $used{$s}++;
+        }
+
+        foreach my $n (@entries)
+        {
+            $slot[hash($names[$n], $seed) % $slots] = $n + 1;
+        }
+
+        $seed[$b] = $seed;
+        next BUCKET;
+    }
+
+    die "no seed found for bucket $b; try more buckets or slots";
+}
+
+sub printTable
+{
+    my ($decl, @values) = @_;
+
+    print "  static const unsigned char ${decl} = {\n";
+    my @lines;
+    while (@values)
+    {
+        push @lines, '    ' . join(', ', map { sprintf('%3d', $_) } splice(@values, 0, 16));
+    }
+    print join(",\n", @lines), "\n  };\n";
+}
+
+printTable("entitySeed[$buckets]", @seed);
+print "\n";
+printTable("entitySlot[$slots]", @slot);